@@ -182,6 +182,10 @@ protected:
 #if CC_ENABLE_SCRIPT_BINDING
     ccScriptType _scriptType;         ///< type of script binding, lua or javascript
 #endif
+    /** The slot of the action in the ActionTweenBatch stepping it, -1 if it is stepped by itself. */
+    int _tweenSlot;
+
+    friend class ActionTweenBatch;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
 };
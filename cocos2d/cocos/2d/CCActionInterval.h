@@ -117,6 +117,7 @@ protected:
     float _elapsed;
     bool _firstTick;
     bool _done;
+    friend class ActionTweenBatch;
     
 protected:
     bool sendUpdateEventToScript(float dt, Action *actionObject);
@@ -593,6 +594,7 @@ protected:
     Vec3 _positionDelta;
     Vec3 _startPosition;
     Vec3 _previousPosition;
+    friend class ActionTweenBatch;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
@@ -1088,6 +1090,7 @@ protected:
     float _deltaX;
     float _deltaY;
     float _deltaZ;
+    friend class ActionTweenBatch;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
@@ -1228,6 +1231,7 @@ protected:
     uint8_t _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class ActionTweenBatch;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
 };
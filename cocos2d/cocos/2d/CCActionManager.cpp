@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCActionTweenBatch.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
@@ -53,7 +54,9 @@ typedef struct _hashElement
 ActionManager::ActionManager()
 : _targets(nullptr),
   _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+  _currentTargetSalvaged(false),
+  _tweenBatch(new ActionTweenBatch()),
+  _tweenBatchingEnabled(true)
 {
 
 }
@@ -63,12 +66,18 @@ ActionManager::~ActionManager()
     CCLOGINFO("deallocing ActionManager: %p", this);
 
     removeAllActions();
+    delete _tweenBatch;
 }
 
 // private
 
 void ActionManager::deleteHashElement(tHashElement *element)
 {
+    // the actions may still be running if the target was only retained by the ActionManager
+    for (ssize_t i = 0; element->actions && i < element->actions->num; ++i)
+    {
+        _tweenBatch->remove(static_cast<Action*>(element->actions->arr[i]));
+    }
     ccArrayFree(element->actions);
     HASH_DEL(_targets, element);
     element->target->release();
@@ -92,6 +101,7 @@ void ActionManager::actionAllocWithHashElement(tHashElement *element)
 void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
 {
     Action *action = static_cast<Action*>(element->actions->arr[index]);
+    _tweenBatch->remove(action);
 
     if (action == element->currentAction && (! element->currentActionSalvaged))
     {
@@ -194,6 +204,11 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      ccArrayAppendObject(element->actions, action);
  
      action->startWithTarget(target);
+
+     if (_tweenBatchingEnabled)
+     {
+         _tweenBatch->add(action, &element->paused);
+     }
 }
 
 // remove
@@ -226,6 +241,10 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
             element->currentActionSalvaged = true;
         }
 
+        for (ssize_t i = 0; i < element->actions->num; ++i)
+        {
+            _tweenBatch->remove(static_cast<Action*>(element->actions->arr[i]));
+        }
         ccArrayRemoveAllObjects(element->actions);
         if (_currentTarget == element)
         {
@@ -439,6 +458,9 @@ ssize_t ActionManager::getNumberOfRunningActions() const
 // main loop
 void ActionManager::update(float dt)
 {
+    // the batched tweens of all targets are stepped first, the loop below only checks whether they are done
+    _tweenBatch->update(dt);
+
     for (tHashElement *elt = _targets; elt != nullptr; )
     {
         _currentTarget = elt;
@@ -458,7 +480,10 @@ void ActionManager::update(float dt)
 
                 _currentTarget->currentActionSalvaged = false;
 
-                _currentTarget->currentAction->step(dt);
+                if (! ActionTweenBatch::isBatched(_currentTarget->currentAction))
+                {
+                    _currentTarget->currentAction->step(dt);
+                }
 
                 if (_currentTarget->currentActionSalvaged)
                 {
@@ -39,6 +39,7 @@ NS_CC_BEGIN
 class Action;
 
 struct _hashElement;
+class ActionTweenBatch;
 
 /**
  * @addtogroup actions
@@ -194,6 +195,21 @@ public:
      * @param dt    In seconds.
      */
     virtual void update(float dt);
+
+    /** Enables or disables stepping the simple tweens together, enabled by default.
+     * MoveTo, MoveBy, ScaleTo, ScaleBy, FadeTo, FadeIn and FadeOut actions, alone or wrapped by a quadratic, cubic,
+     * quartic, sine or rate ease action, are then stepped by an ActionTweenBatch before the other actions.
+     * It only applies to the actions added afterwards.
+     *
+     * @param enabled   Whether the tweens are batched.
+     * @js NA
+     */
+    void setTweenBatchingEnabled(bool enabled) { _tweenBatchingEnabled = enabled; }
+
+    /** Whether the simple tweens are stepped together.
+     * @js NA
+     */
+    bool isTweenBatchingEnabled() const { return _tweenBatchingEnabled; }
     
 protected:
     // declared in ActionManager.m
@@ -206,6 +222,8 @@ protected:
     struct _hashElement    *_targets;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
+    ActionTweenBatch *_tweenBatch;
+    bool            _tweenBatchingEnabled;
 };
 
 // end of actions group
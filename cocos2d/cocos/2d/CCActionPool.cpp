@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCActionPool.h"
+
+#include "2d/CCAction.h"
+
+NS_CC_BEGIN
+
+static ActionPool* s_sharedActionPool = nullptr;
+
+ActionPool* ActionPool::getInstance()
+{
+    if (!s_sharedActionPool)
+    {
+        s_sharedActionPool = new (std::nothrow) ActionPool();
+    }
+    return s_sharedActionPool;
+}
+
+void ActionPool::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedActionPool);
+}
+
+ActionPool::~ActionPool()
+{
+    removeAllActions();
+}
+
+Action* ActionPool::getAction(Action* prototype)
+{
+    CCASSERT(prototype != nullptr, "prototype can't be nullptr!");
+
+    auto it = _pools.find(prototype);
+    if (it == _pools.end())
+    {
+        prototype->retain();
+        it = _pools.emplace(prototype, Pool()).first;
+    }
+
+    Action* action = nullptr;
+    auto& pool = it->second;
+    ssize_t count = pool.actions.size();
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        ssize_t index = (pool.next + i) % count;
+        // only retained by the pool
+        if (pool.actions.at(index)->getReferenceCount() == 1)
+        {
+            action = pool.actions.at(index);
+            pool.next = (index + 1) % count;
+            break;
+        }
+    }
+
+    if (action == nullptr)
+    {
+        action = prototype->clone();
+        CCASSERT(action != nullptr, "the prototype can't be cloned!");
+        if (action == nullptr)
+            return nullptr;
+        pool.actions.pushBack(action);
+    }
+
+    action->setTag(prototype->getTag());
+    action->setFlags(prototype->getFlags());
+    return action;
+}
+
+ssize_t ActionPool::getActionCount(Action* prototype) const
+{
+    auto it = _pools.find(prototype);
+    return it != _pools.end() ? it->second.actions.size() : 0;
+}
+
+void ActionPool::removeUnusedActions()
+{
+    // the prototypes are kept, their users may still rely on the pool retaining them
+    for (auto& pool : _pools)
+    {
+        auto& actions = pool.second.actions;
+        for (ssize_t i = actions.size() - 1; i >= 0; --i)
+        {
+            if (actions.at(i)->getReferenceCount() == 1)
+                actions.erase(i);
+        }
+        pool.second.next = 0;
+    }
+}
+
+void ActionPool::removeActions(Action* prototype)
+{
+    auto it = _pools.find(prototype);
+    if (it != _pools.end())
+    {
+        it->first->release();
+        _pools.erase(it);
+    }
+}
+
+void ActionPool::removeAllActions()
+{
+    for (auto& pool : _pools)
+    {
+        pool.first->release();
+    }
+    _pools.clear();
+}
+
+NS_CC_END
@@ -0,0 +1,96 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <unordered_map>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCVector.h"
+
+/**
+ * @addtogroup actions
+ * @{
+ */
+NS_CC_BEGIN
+
+class Action;
+
+/**
+ * @class ActionPool
+ * @brief Keeps instances of prototype actions so that frequently run effects are not allocated every time.
+ * An instance is a clone of its prototype owned by the pool, it is free again once nothing but the pool retains it,
+ * i.e. when its ActionManager released it after it is done or stopped. A new clone is only made when all instances
+ * of the prototype are in use, so after the first runs no action is allocated.
+ * Composed actions such as Sequence, Repeat or RepeatForever are reset by startWithTarget(), like any action.
+ * @see Node::runPooledAction()
+ * @js NA
+ */
+class CC_DLL ActionPool
+{
+public:
+    /** Returns the shared instance. */
+    static ActionPool* getInstance();
+
+    /** Destroys the shared instance, the pooled actions are released. */
+    static void destroyInstance();
+
+    /**
+     * Gets a free instance of the prototype, it is cloned if all instances are in use.
+     * The tag and the flags of the instance are reset to the ones of the prototype.
+     * The instance is retained by the pool only, it should be run right away or retained.
+     *
+     * @param prototype The action to instantiate, it is retained by the pool and should not be run itself.
+     */
+    Action* getAction(Action* prototype);
+
+    /** Gets the number of instances of the prototype, in use or not. */
+    ssize_t getActionCount(Action* prototype) const;
+
+    /** Releases the instances which aren't in use, the prototypes are kept until removeActions() is invoked. */
+    void removeUnusedActions();
+
+    /** Releases the prototype and its instances, the ones in use are kept alive by their users. */
+    void removeActions(Action* prototype);
+
+    /** Releases all prototypes and instances. */
+    void removeAllActions();
+
+protected:
+    ActionPool() {}
+    ~ActionPool();
+
+    struct Pool
+    {
+        Vector<Action*> actions;
+        ssize_t next = 0;   ///< where the search for a free instance starts
+    };
+
+    // the keys are the retained prototypes
+    std::unordered_map<Action*, Pool> _pools;
+};
+
+NS_CC_END
+// end of actions group
+/// @}
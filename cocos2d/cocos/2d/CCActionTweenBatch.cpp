@@ -0,0 +1,426 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCActionTweenBatch.h"
+
+#include <algorithm>
+#include <float.h>
+#include <typeinfo>
+
+#include "2d/CCActionInterval.h"
+#include "2d/CCActionEase.h"
+#include "2d/CCNode.h"
+#include "2d/CCTweenFunction.h"
+#include "base/ccConfig.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // Writes f(time) for the slots using the easing, the loop has no branch so that it can be vectorized.
+    template <typename E, typename F>
+    void applyEasing(const E* easings, E easing, const float* times, float* values, size_t count, F f)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            float eased = f(times[i]);
+            values[i] = easings[i] == easing ? eased : values[i];
+        }
+    }
+}
+
+ActionTweenBatch::ActionTweenBatch()
+: _removedCount(0)
+, _updating(false)
+{
+    std::fill(std::begin(_easingCounts), std::end(_easingCounts), 0);
+}
+
+bool ActionTweenBatch::isBatched(const Action* action)
+{
+    return action->_tweenSlot >= 0;
+}
+
+bool ActionTweenBatch::getEasing(ActionInterval* action, Easing* easing, float* rate, ActionInterval** inner)
+{
+    const std::type_info& type = typeid(*action);
+    *rate = 1.0f;
+    *inner = action;
+    if (type == typeid(EaseQuadraticActionIn))
+        *easing = Easing::QUAD_IN;
+    else if (type == typeid(EaseQuadraticActionOut))
+        *easing = Easing::QUAD_OUT;
+    else if (type == typeid(EaseQuadraticActionInOut))
+        *easing = Easing::QUAD_IN_OUT;
+    else if (type == typeid(EaseCubicActionIn))
+        *easing = Easing::CUBIC_IN;
+    else if (type == typeid(EaseCubicActionOut))
+        *easing = Easing::CUBIC_OUT;
+    else if (type == typeid(EaseCubicActionInOut))
+        *easing = Easing::CUBIC_IN_OUT;
+    else if (type == typeid(EaseQuarticActionIn))
+        *easing = Easing::QUART_IN;
+    else if (type == typeid(EaseQuarticActionOut))
+        *easing = Easing::QUART_OUT;
+    else if (type == typeid(EaseQuarticActionInOut))
+        *easing = Easing::QUART_IN_OUT;
+    else if (type == typeid(EaseSineIn))
+        *easing = Easing::SINE_IN;
+    else if (type == typeid(EaseSineOut))
+        *easing = Easing::SINE_OUT;
+    else if (type == typeid(EaseSineInOut))
+        *easing = Easing::SINE_IN_OUT;
+    else if (type == typeid(EaseIn))
+        *easing = Easing::RATE_IN;
+    else if (type == typeid(EaseOut))
+        *easing = Easing::RATE_OUT;
+    else if (type == typeid(EaseInOut))
+        *easing = Easing::RATE_IN_OUT;
+    else
+    {
+        *easing = Easing::LINEAR;
+        return true;
+    }
+
+    if (*easing >= Easing::RATE_IN)
+        *rate = static_cast<EaseRateAction*>(action)->getRate();
+    *inner = static_cast<ActionEase*>(action)->getInnerAction();
+    return *inner != nullptr;
+}
+
+bool ActionTweenBatch::add(Action* action, const bool* paused)
+{
+    // only the exact classes are batched, a subclass may override update()
+    auto interval = dynamic_cast<ActionInterval*>(action);
+    if (interval == nullptr || interval->_tweenSlot >= 0 || interval->getTarget() == nullptr)
+        return false;
+
+#if CC_ENABLE_SCRIPT_BINDING
+    if (interval->_scriptType == kScriptTypeJavascript)
+        return false;
+#endif
+
+    Easing easing;
+    float rate;
+    ActionInterval* inner;
+    if (!getEasing(interval, &easing, &rate, &inner))
+        return false;
+
+    float starts[3] = {0, 0, 0};
+    float deltas[3] = {0, 0, 0};
+    Property property;
+    const std::type_info& type = typeid(*inner);
+    if (type == typeid(MoveBy) || type == typeid(MoveTo))
+    {
+        auto move = static_cast<MoveBy*>(inner);
+        property = Property::POSITION;
+        starts[0] = move->_startPosition.x;
+        starts[1] = move->_startPosition.y;
+        starts[2] = move->_startPosition.z;
+        deltas[0] = move->_positionDelta.x;
+        deltas[1] = move->_positionDelta.y;
+        deltas[2] = move->_positionDelta.z;
+    }
+    else if (type == typeid(ScaleTo) || type == typeid(ScaleBy))
+    {
+        auto scale = static_cast<ScaleTo*>(inner);
+        property = Property::SCALE;
+        starts[0] = scale->_startScaleX;
+        starts[1] = scale->_startScaleY;
+        starts[2] = scale->_startScaleZ;
+        deltas[0] = scale->_deltaX;
+        deltas[1] = scale->_deltaY;
+        deltas[2] = scale->_deltaZ;
+    }
+    else if (type == typeid(FadeTo) || type == typeid(FadeIn) || type == typeid(FadeOut))
+    {
+        auto fade = static_cast<FadeTo*>(inner);
+        property = Property::OPACITY;
+        starts[0] = fade->_fromOpacity;
+        deltas[0] = (float)(fade->_toOpacity - fade->_fromOpacity);
+    }
+    else
+    {
+        return false;
+    }
+
+    interval->_tweenSlot = (int)_actions.size();
+    _actions.push_back(interval);
+    _targets.push_back(interval->getTarget());
+    _paused.push_back(paused);
+    _properties.push_back(property);
+    _easings.push_back(easing);
+    _rates.push_back(rate);
+    _elapsed.push_back(0);
+    _durations.push_back(std::max(interval->getDuration(), FLT_EPSILON));
+    _started.push_back(0);
+    for (int i = 0; i < 3; ++i)
+    {
+        _starts[i].push_back(starts[i]);
+        _deltas[i].push_back(deltas[i]);
+        _previous[i].push_back(starts[i]);
+    }
+    ++_easingCounts[(int)easing];
+    return true;
+}
+
+void ActionTweenBatch::remove(Action* action)
+{
+    int slot = action->_tweenSlot;
+    if (slot < 0)
+        return;
+
+    action->_tweenSlot = -1;
+    --_easingCounts[(int)_easings[slot]];
+
+    // the slots are being iterated, they are compacted at the end of update()
+    if (_updating)
+    {
+        _actions[slot] = nullptr;
+        ++_removedCount;
+        return;
+    }
+    erase(slot);
+}
+
+void ActionTweenBatch::erase(int slot)
+{
+    // move the last slot into the removed one
+    int last = (int)_actions.size() - 1;
+    if (slot != last)
+    {
+        _actions[slot] = _actions[last];
+        if (_actions[slot])
+            _actions[slot]->_tweenSlot = slot;
+        _targets[slot] = _targets[last];
+        _paused[slot] = _paused[last];
+        _properties[slot] = _properties[last];
+        _easings[slot] = _easings[last];
+        _rates[slot] = _rates[last];
+        _elapsed[slot] = _elapsed[last];
+        _durations[slot] = _durations[last];
+        _started[slot] = _started[last];
+        for (int i = 0; i < 3; ++i)
+        {
+            _starts[i][slot] = _starts[i][last];
+            _deltas[i][slot] = _deltas[i][last];
+            _previous[i][slot] = _previous[i][last];
+        }
+    }
+
+    _actions.pop_back();
+    _targets.pop_back();
+    _paused.pop_back();
+    _properties.pop_back();
+    _easings.pop_back();
+    _rates.pop_back();
+    _elapsed.pop_back();
+    _durations.pop_back();
+    _started.pop_back();
+    for (int i = 0; i < 3; ++i)
+    {
+        _starts[i].pop_back();
+        _deltas[i].pop_back();
+        _previous[i].pop_back();
+    }
+}
+
+void ActionTweenBatch::compact()
+{
+    for (int slot = (int)_actions.size() - 1; slot >= 0 && _removedCount > 0; --slot)
+    {
+        if (_actions[slot] == nullptr)
+        {
+            erase(slot);
+            --_removedCount;
+        }
+    }
+}
+
+void ActionTweenBatch::evaluateEasings(size_t count)
+{
+    const Easing* easings = _easings.data();
+    const float* times = _times.data();
+    float* values = _values[0].data();
+    std::copy(times, times + count, values);
+
+    if (_easingCounts[(int)Easing::QUAD_IN])
+        applyEasing(easings, Easing::QUAD_IN, times, values, count, [](float t) { return t * t; });
+    if (_easingCounts[(int)Easing::QUAD_OUT])
+        applyEasing(easings, Easing::QUAD_OUT, times, values, count, [](float t) { return -t * (t - 2); });
+    if (_easingCounts[(int)Easing::QUAD_IN_OUT])
+        applyEasing(easings, Easing::QUAD_IN_OUT, times, values, count, [](float t) {
+            float s = t * 2;
+            float u = s - 1;
+            return s < 1 ? 0.5f * s * s : -0.5f * (u * (u - 2) - 1);
+        });
+    if (_easingCounts[(int)Easing::CUBIC_IN])
+        applyEasing(easings, Easing::CUBIC_IN, times, values, count, [](float t) { return t * t * t; });
+    if (_easingCounts[(int)Easing::CUBIC_OUT])
+        applyEasing(easings, Easing::CUBIC_OUT, times, values, count, [](float t) {
+            float u = t - 1;
+            return u * u * u + 1;
+        });
+    if (_easingCounts[(int)Easing::CUBIC_IN_OUT])
+        applyEasing(easings, Easing::CUBIC_IN_OUT, times, values, count, [](float t) {
+            float s = t * 2;
+            float u = s - 2;
+            return s < 1 ? 0.5f * s * s * s : 0.5f * (u * u * u + 2);
+        });
+    if (_easingCounts[(int)Easing::QUART_IN])
+        applyEasing(easings, Easing::QUART_IN, times, values, count, [](float t) { return t * t * t * t; });
+    if (_easingCounts[(int)Easing::QUART_OUT])
+        applyEasing(easings, Easing::QUART_OUT, times, values, count, [](float t) {
+            float u = t - 1;
+            return -(u * u * u * u - 1);
+        });
+    if (_easingCounts[(int)Easing::QUART_IN_OUT])
+        applyEasing(easings, Easing::QUART_IN_OUT, times, values, count, [](float t) {
+            float s = t * 2;
+            float u = s - 2;
+            return s < 1 ? 0.5f * s * s * s * s : -0.5f * (u * u * u * u - 2);
+        });
+    if (_easingCounts[(int)Easing::SINE_IN])
+        applyEasing(easings, Easing::SINE_IN, times, values, count, tweenfunc::sineEaseIn);
+    if (_easingCounts[(int)Easing::SINE_OUT])
+        applyEasing(easings, Easing::SINE_OUT, times, values, count, tweenfunc::sineEaseOut);
+    if (_easingCounts[(int)Easing::SINE_IN_OUT])
+        applyEasing(easings, Easing::SINE_IN_OUT, times, values, count, tweenfunc::sineEaseInOut);
+
+    // the rate varies by slot and powf is not vectorized
+    if (_easingCounts[(int)Easing::RATE_IN] || _easingCounts[(int)Easing::RATE_OUT] || _easingCounts[(int)Easing::RATE_IN_OUT])
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            switch (easings[i])
+            {
+                case Easing::RATE_IN:
+                    values[i] = tweenfunc::easeIn(times[i], _rates[i]);
+                    break;
+                case Easing::RATE_OUT:
+                    values[i] = tweenfunc::easeOut(times[i], _rates[i]);
+                    break;
+                case Easing::RATE_IN_OUT:
+                    values[i] = tweenfunc::easeInOut(times[i], _rates[i]);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+void ActionTweenBatch::update(float dt)
+{
+    size_t count = _actions.size();
+    if (count == 0)
+        return;
+
+    _steps.resize(count);
+    _times.resize(count);
+    for (int i = 0; i < 3; ++i)
+        _values[i].resize(count);
+
+    // like ActionInterval::step(), the first step of an action doesn't add dt
+    float* steps = _steps.data();
+    float* started = _started.data();
+    for (size_t i = 0; i < count; ++i)
+        steps[i] = *_paused[i] ? 0.0f : 1.0f;
+
+    float* elapsed = _elapsed.data();
+    const float* durations = _durations.data();
+    float* times = _times.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        elapsed[i] += dt * steps[i] * started[i];
+        started[i] = std::max(started[i], steps[i]);
+        times[i] = std::max(0.0f, std::min(1.0f, elapsed[i] / durations[i]));
+    }
+
+    evaluateEasings(count);
+
+    // values[0] holds the eased time, it is the last component to be computed
+    for (int c = 2; c >= 0; --c)
+    {
+        const float* eased = _values[0].data();
+        const float* starts = _starts[c].data();
+        const float* deltas = _deltas[c].data();
+        float* values = _values[c].data();
+        for (size_t i = 0; i < count; ++i)
+            values[i] = starts[i] + deltas[i] * eased[i];
+    }
+
+    // the setters may add actions, which reallocates the slots, so they are indexed instead of using the pointers above
+    _updating = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        ActionInterval* action = _actions[i];
+        if (_steps[i] == 0 || action == nullptr)
+            continue;
+
+        Node* target = _targets[i];
+        switch (_properties[i])
+        {
+            case Property::POSITION:
+            {
+                Vec3 position(_values[0][i], _values[1][i], _values[2][i]);
+#if CC_ENABLE_STACKABLE_ACTIONS
+                Vec3 previous(_previous[0][i], _previous[1][i], _previous[2][i]);
+                Vec3 diff = target->getPosition3D() - previous;
+                _starts[0][i] += diff.x;
+                _starts[1][i] += diff.y;
+                _starts[2][i] += diff.z;
+                position += diff;
+                _previous[0][i] = position.x;
+                _previous[1][i] = position.y;
+                _previous[2][i] = position.z;
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+                target->setPosition3D(position);
+                break;
+            }
+            case Property::SCALE:
+                target->setScaleX(_values[0][i]);
+                target->setScaleY(_values[1][i]);
+                target->setScaleZ(_values[2][i]);
+                break;
+            case Property::OPACITY:
+                target->setOpacity((uint8_t)_values[0][i]);
+                break;
+        }
+
+        // the setters may have removed the action
+        if (_actions[i] == action)
+        {
+            action->_firstTick = false;
+            action->_elapsed = _elapsed[i];
+            action->_done = _elapsed[i] >= action->getDuration();
+        }
+    }
+    _updating = false;
+
+    if (_removedCount > 0)
+        compact();
+}
+
+NS_CC_END
@@ -0,0 +1,133 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup actions
+ * @{
+ */
+NS_CC_BEGIN
+
+class Action;
+class ActionInterval;
+class Node;
+
+/**
+ * @class ActionTweenBatch
+ * @brief Steps the simple tweens of an ActionManager together instead of one action at a time.
+ * MoveBy, MoveTo, ScaleTo, ScaleBy, FadeTo, FadeIn and FadeOut, alone or wrapped by a quadratic, cubic, quartic,
+ * sine or rate ease action, are stored in structure of arrays buffers. Their time and easing curves are evaluated
+ * by loops over these buffers, which the compiler can vectorize, then the results are written to the nodes in one pass.
+ * The batched actions are still owned by the ActionManager, which checks whether they are done.
+ * @js NA
+ */
+class CC_DLL ActionTweenBatch
+{
+public:
+    ActionTweenBatch();
+
+    /** Whether the action is stepped by a batch. */
+    static bool isBatched(const Action* action);
+
+    /**
+     * Adds an action which has been started with its target, if it can be batched.
+     * @param paused Whether the target is paused, it must stay valid until the action is removed.
+     * @return true if the action will be stepped by the batch.
+     */
+    bool add(Action* action, const bool* paused);
+
+    /** Removes the action from the batch, it must be done before the action is released. */
+    void remove(Action* action);
+
+    /** Steps all batched actions of the targets which aren't paused. */
+    void update(float dt);
+
+    /** Returns the number of batched actions. */
+    size_t getCount() const { return _actions.size() - _removedCount; }
+
+private:
+    enum class Property : unsigned char
+    {
+        POSITION,
+        SCALE,
+        OPACITY
+    };
+
+    enum class Easing : unsigned char
+    {
+        LINEAR,
+        QUAD_IN,
+        QUAD_OUT,
+        QUAD_IN_OUT,
+        CUBIC_IN,
+        CUBIC_OUT,
+        CUBIC_IN_OUT,
+        QUART_IN,
+        QUART_OUT,
+        QUART_IN_OUT,
+        SINE_IN,
+        SINE_OUT,
+        SINE_IN_OUT,
+        RATE_IN,
+        RATE_OUT,
+        RATE_IN_OUT,
+        COUNT
+    };
+
+    static bool getEasing(ActionInterval* action, Easing* easing, float* rate, ActionInterval** inner);
+    void evaluateEasings(size_t count);
+    void erase(int slot);
+    void compact();
+
+    std::vector<ActionInterval*> _actions;
+    std::vector<Node*> _targets;
+    std::vector<const bool*> _paused;
+    std::vector<Property> _properties;
+    std::vector<Easing> _easings;
+    std::vector<float> _rates;
+    std::vector<float> _elapsed;
+    std::vector<float> _durations;
+    std::vector<float> _started;
+    std::vector<float> _starts[3];
+    std::vector<float> _deltas[3];
+    std::vector<float> _previous[3];
+
+    // scratch buffers of update()
+    std::vector<float> _steps;
+    std::vector<float> _times;
+    std::vector<float> _values[3];
+
+    unsigned int _easingCounts[(int)Easing::COUNT];
+    size_t _removedCount;
+    bool _updating;
+};
+
+NS_CC_END
+// end of actions group
+/// @}
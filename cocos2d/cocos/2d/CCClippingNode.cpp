@@ -26,6 +26,11 @@
  *
  */
 #include "2d/CCClippingNode.h"
+#include "2d/CCDrawNode.h"
+#include "2d/CCLayer.h"
+#include "2d/CCCamera.h"
+#include "2d/CCRenderTexture.h"
+#include "platform/CCGLView.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/ccShaders.h"
 #include "renderer/backend/ProgramState.h"
@@ -190,6 +195,25 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
 
     renderer->pushGroup(_groupCommandStencil.getRenderQueueID());
 
+    // A rectangle stencil seen without rotation clips like a scissor box,
+    // which avoids drawing the stencil and clearing the stencil buffer
+    if (getStencilScissorRect(&_scissorRect))
+    {
+        _beforeVisitCmd.init(_globalZOrder);
+        _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisitScissor, this);
+        renderer->addCommand(&_beforeVisitCmd);
+
+        visitContent(renderer, flags);
+
+        _afterVisitCmd.init(_globalZOrder);
+        _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisitScissor, this);
+        renderer->addCommand(&_afterVisitCmd);
+
+        renderer->popGroup();
+        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        return;
+    }
+
     // _beforeVisitCmd.init(_globalZOrder);
     // _beforeVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onBeforeVisit, _stencilStateManager);
     // renderer->addCommand(&_beforeVisitCmd);
@@ -212,6 +236,19 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     _afterDrawStencilCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterDrawStencil, _stencilStateManager);
     renderer->addCommand(&_afterDrawStencilCmd);
 
+    visitContent(renderer, flags);
+
+    _afterVisitCmd.init(_globalZOrder);
+    _afterVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterVisit, _stencilStateManager);
+    renderer->addCommand(&_afterVisitCmd);
+
+    renderer->popGroup();
+    
+    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+}
+
+void ClippingNode::visitContent(Renderer *renderer, uint32_t flags)
+{
     int i = 0;
     bool visibleByCamera = isVisitableByVisitingCamera();
     
@@ -250,14 +287,113 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
 
 
     renderer->popGroup();
+}
 
-    _afterVisitCmd.init(_globalZOrder);
-    _afterVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterVisit, _stencilStateManager);
-    renderer->addCommand(&_afterVisitCmd);
+bool ClippingNode::getStencilScissorRect(Rect* rect) const
+{
+    if (isInverted() || getAlphaThreshold() < 1 || !_stencil->isVisible() || !_stencil->getChildren().empty())
+        return false;
 
-    renderer->popGroup();
-    
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    Rect stencilRect;
+    auto drawNode = dynamic_cast<DrawNode*>(_stencil);
+    if (drawNode)
+    {
+        if (!drawNode->getSolidRect(&stencilRect))
+            return false;
+    }
+    else if (dynamic_cast<LayerColor*>(_stencil))
+    {
+        stencilRect.size = _stencil->getContentSize();
+        if (stencilRect.size.width <= 0 || stencilRect.size.height <= 0)
+            return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    // scissor rects are in window coordinates, they can't clip what a render texture draws
+    if (RenderTexture::isGrabbing())
+        return false;
+
+    // the corners are projected like the content is drawn, by the camera visiting the node
+    auto camera = Camera::getVisitingCamera();
+    if (camera == nullptr)
+        return false;
+
+    Mat4 transform = _modelViewTransform * _stencil->getNodeToParentTransform();
+    Vec2 corners[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        Vec3 corner(i & 1 ? stencilRect.getMaxX() : stencilRect.getMinX(),
+                    i & 2 ? stencilRect.getMaxY() : stencilRect.getMinY(),
+                    0);
+        transform.transformPoint(&corner);
+        corners[i] = camera->projectGL(corner);
+    }
+
+    // the projected rectangle must stay axis aligned, corners 0 and 2 share the left edge, 0 and 1 the bottom edge
+    const float epsilon = 0.01f;
+    bool aligned = fabsf(corners[0].x - corners[2].x) < epsilon && fabsf(corners[1].x - corners[3].x) < epsilon
+        && fabsf(corners[0].y - corners[1].y) < epsilon && fabsf(corners[2].y - corners[3].y) < epsilon;
+    bool rotated = fabsf(corners[0].x - corners[1].x) < epsilon && fabsf(corners[2].x - corners[3].x) < epsilon
+        && fabsf(corners[0].y - corners[2].y) < epsilon && fabsf(corners[1].y - corners[3].y) < epsilon;
+    if (!aligned && !rotated)
+        return false;
+
+    float minX = corners[0].x, maxX = minX;
+    float minY = corners[0].y, maxY = minY;
+    for (int i = 1; i < 4; ++i)
+    {
+        minX = std::min(minX, corners[i].x);
+        maxX = std::max(maxX, corners[i].x);
+        minY = std::min(minY, corners[i].y);
+        maxY = std::max(maxY, corners[i].y);
+    }
+    rect->setRect(minX, minY, maxX - minX, maxY - minY);
+    return true;
+}
+
+void ClippingNode::onBeforeVisitScissor()
+{
+    auto glview = Director::getInstance()->getOpenGLView();
+    _scissorOldEnabled = glview->isScissorEnabled();
+    Rect scissorRect = _scissorRect;
+    if (_scissorOldEnabled)
+    {
+        // nested clipping only draws inside both rectangles
+        _scissorOldRect = glview->getScissorRect();
+        float minX = std::max(scissorRect.getMinX(), _scissorOldRect.getMinX());
+        float minY = std::max(scissorRect.getMinY(), _scissorOldRect.getMinY());
+        float maxX = std::min(scissorRect.getMaxX(), _scissorOldRect.getMaxX());
+        float maxY = std::min(scissorRect.getMaxY(), _scissorOldRect.getMaxY());
+        scissorRect.setRect(minX, minY, std::max(maxX - minX, 0.0f), std::max(maxY - minY, 0.0f));
+    }
+    else
+    {
+        Director::getInstance()->getRenderer()->setScissorTest(true);
+    }
+
+    glview->setScissorInPoints(scissorRect.origin.x,
+                               scissorRect.origin.y,
+                               scissorRect.size.width,
+                               scissorRect.size.height);
+}
+
+void ClippingNode::onAfterVisitScissor()
+{
+    if (_scissorOldEnabled)
+    {
+        auto glview = Director::getInstance()->getOpenGLView();
+        glview->setScissorInPoints(_scissorOldRect.origin.x,
+                                   _scissorOldRect.origin.y,
+                                   _scissorOldRect.size.width,
+                                   _scissorOldRect.size.height);
+    }
+    else
+    {
+        Director::getInstance()->getRenderer()->setScissorTest(false);
+    }
 }
 
 void ClippingNode::setCameraMask(unsigned short mask, bool applyChildren)
@@ -156,14 +156,28 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     void setProgramStateRecursively(Node* node, backend::ProgramState* programState);
     void restoreAllProgramStates();
+    void visitContent(Renderer *renderer, uint32_t flags);
+
+    /**
+     * Get the window rectangle covered by the stencil, in points, if it can replace the stencil test.
+     * It is the case for a DrawNode made of one solid rectangle or a LayerColor, which are not rotated on screen,
+     * when the clipping node is not inverted, has no alpha threshold and is not drawn to a render texture.
+     */
+    bool getStencilScissorRect(Rect* rect) const;
+    void onBeforeVisitScissor();
+    void onAfterVisitScissor();
 
     Node* _stencil                              = nullptr;
     StencilStateManager* _stencilStateManager   = nullptr;
     
     GroupCommand _groupCommandStencil;
     GroupCommand _groupCommandChildren;
+    CallbackCommand _beforeVisitCmd;
     CallbackCommand _afterDrawStencilCmd;
     CallbackCommand _afterVisitCmd;
+    Rect _scissorRect;
+    Rect _scissorOldRect;
+    bool _scissorOldEnabled                     = false;
     std::unordered_map<Node*, backend::ProgramState*> _originalStencilProgramState;
 
 private:
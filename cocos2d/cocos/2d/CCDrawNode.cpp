@@ -49,6 +49,30 @@ DrawNode::DrawNode(float lineWidth)
 : _lineWidth(lineWidth)
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
+
+    // The vertices are uploaded when the commands are rendered, on the render thread.
+    // draw() may run on a worker thread of the ParallelVisitor, which can't call the backend.
+    _customCommand.setBeforeCallback([this]() {
+        if (_dirty)
+        {
+            updateVertexBuffer(_customCommand, _buffer, _bufferCount, _uploadedCount, _retainedBuffer);
+            _dirty = false;
+        }
+    });
+    _customCommandGLPoint.setBeforeCallback([this]() {
+        if (_dirtyGLPoint)
+        {
+            updateVertexBuffer(_customCommandGLPoint, _bufferGLPoint, _bufferCountGLPoint, _uploadedCountGLPoint, _retainedBufferGLPoint);
+            _dirtyGLPoint = false;
+        }
+    });
+    _customCommandGLLine.setBeforeCallback([this]() {
+        if (_dirtyGLLine)
+        {
+            updateVertexBuffer(_customCommandGLLine, _bufferGLLine, _bufferCountGLLine, _uploadedCountGLLine, _retainedBufferGLLine);
+            _dirtyGLLine = false;
+        }
+    });
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     //TODO new-renderer: interface setupBuffer removal
 
@@ -100,8 +124,10 @@ void DrawNode::ensureCapacity(int count)
         _bufferCapacity += MAX(_bufferCapacity, count);
         _buffer = (V2F_C4B_T2F*)realloc(_buffer, _bufferCapacity*sizeof(V2F_C4B_T2F));
         
-        _customCommand.createVertexBuffer(sizeof(V2F_C4B_T2F), _bufferCapacity, CustomCommand::BufferUsage::STATIC);
-        _customCommand.updateVertexBuffer(_buffer, _bufferCapacity*sizeof(V2F_C4B_T2F));
+        // the whole buffer is uploaded by the next draw
+        _customCommand.createVertexBuffer(sizeof(V2F_C4B_T2F), _bufferCapacity, getBufferUsage());
+        _uploadedCount = 0;
+        _dirty = true;
     }
 }
 
@@ -114,8 +140,10 @@ void DrawNode::ensureCapacityGLPoint(int count)
         _bufferCapacityGLPoint += MAX(_bufferCapacityGLPoint, count);
         _bufferGLPoint = (V2F_C4B_T2F*)realloc(_bufferGLPoint, _bufferCapacityGLPoint*sizeof(V2F_C4B_T2F));
         
-        _customCommandGLPoint.createVertexBuffer(sizeof(V2F_C4B_T2F), _bufferCapacityGLPoint, CustomCommand::BufferUsage::STATIC);
-        _customCommandGLPoint.updateVertexBuffer(_bufferGLPoint, _bufferCapacityGLPoint*sizeof(V2F_C4B_T2F));
+        // the whole buffer is uploaded by the next draw
+        _customCommandGLPoint.createVertexBuffer(sizeof(V2F_C4B_T2F), _bufferCapacityGLPoint, getBufferUsage());
+        _uploadedCountGLPoint = 0;
+        _dirtyGLPoint = true;
     }
 }
 
@@ -128,8 +156,10 @@ void DrawNode::ensureCapacityGLLine(int count)
         _bufferCapacityGLLine += MAX(_bufferCapacityGLLine, count);
         _bufferGLLine = (V2F_C4B_T2F*)realloc(_bufferGLLine, _bufferCapacityGLLine*sizeof(V2F_C4B_T2F));
         
-        _customCommandGLLine.createVertexBuffer(sizeof(V2F_C4B_T2F), _bufferCapacityGLLine, CustomCommand::BufferUsage::STATIC);
-        _customCommandGLLine.updateVertexBuffer(_bufferGLLine, _bufferCapacityGLLine*sizeof(V2F_C4B_T2F));
+        // the whole buffer is uploaded by the next draw
+        _customCommandGLLine.createVertexBuffer(sizeof(V2F_C4B_T2F), _bufferCapacityGLLine, getBufferUsage());
+        _uploadedCountGLLine = 0;
+        _dirtyGLLine = true;
     }
 }
 
@@ -234,6 +264,42 @@ void DrawNode::updateUniforms(const Mat4 &transform, CustomCommand& cmd)
     pipelineDescriptor.programState->setUniform(alphaUniformLocation, &alpha, sizeof(alpha));
 }
 
+void DrawNode::updateVertexBuffer(CustomCommand& cmd, V2F_C4B_T2F* buffer, int count, int& uploadedCount, std::vector<V2F_C4B_T2F>& retainedBuffer)
+{
+    // append-only by default, the vertices before uploadedCount didn't change
+    int start = uploadedCount;
+    int end = count;
+    if (_retained)
+    {
+        // compare with the uploaded vertices, so that clearing and drawing the same primitives uploads nothing
+        int compared = std::min(count, uploadedCount);
+        start = 0;
+        while (start < compared && memcmp(buffer + start, retainedBuffer.data() + start, sizeof(V2F_C4B_T2F)) == 0)
+            ++start;
+        if (count <= uploadedCount)
+        {
+            end = compared;
+            while (end > start && memcmp(buffer + end - 1, retainedBuffer.data() + end - 1, sizeof(V2F_C4B_T2F)) == 0)
+                --end;
+        }
+        if (start < end)
+        {
+            if ((int)retainedBuffer.size() < end)
+                retainedBuffer.resize(end);
+            memcpy(retainedBuffer.data() + start, buffer + start, (end - start) * sizeof(V2F_C4B_T2F));
+        }
+        // the vertices after count are still valid, they may be drawn again after the next clear()
+        uploadedCount = std::max(uploadedCount, count);
+    }
+    else
+    {
+        uploadedCount = count;
+    }
+
+    if (start < end)
+        cmd.updateVertexBuffer(buffer + start, start * sizeof(V2F_C4B_T2F), (end - start) * sizeof(V2F_C4B_T2F));
+}
+
 void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     if(_bufferCount)
@@ -269,7 +335,6 @@ void DrawNode::drawPoint(const Vec2& position, const float pointSize, const Colo
     V2F_C4B_T2F *point = _bufferGLPoint + _bufferCountGLPoint;
     *point = {position, Color4B(color), Tex2F(pointSize,0)};
     
-    _customCommandGLPoint.updateVertexBuffer(point, _bufferCountGLPoint*sizeof(V2F_C4B_T2F), sizeof(V2F_C4B_T2F));
     _bufferCountGLPoint += 1;
     _dirtyGLPoint = true;
     _customCommandGLPoint.setVertexDrawInfo(0, _bufferCountGLPoint);
@@ -290,7 +355,6 @@ void DrawNode::drawPoints(const Vec2 *position, unsigned int numberOfPoints, con
         *(point + i) = {position[i], Color4B(color), Tex2F(pointSize,0)};
     }
     
-    _customCommandGLPoint.updateVertexBuffer(point, _bufferCountGLPoint*sizeof(V2F_C4B_T2F), numberOfPoints*sizeof(V2F_C4B_T2F));
     _bufferCountGLPoint += numberOfPoints;
     _dirtyGLPoint = true;
     _customCommandGLPoint.setVertexDrawInfo(0, _bufferCountGLPoint);
@@ -305,7 +369,6 @@ void DrawNode::drawLine(const Vec2 &origin, const Vec2 &destination, const Color
     *point = {origin, Color4B(color), Tex2F(0.0, 0.0)};
     *(point+1) = {destination, Color4B(color), Tex2F(0.0, 0.0)};
     
-    _customCommandGLLine.updateVertexBuffer(point, _bufferCountGLLine*sizeof(V2F_C4B_T2F), 2*sizeof(V2F_C4B_T2F));
     _bufferCountGLLine += 2;
     _dirtyGLLine = true;
     _customCommandGLLine.setVertexDrawInfo(0, _bufferCountGLLine);
@@ -334,7 +397,6 @@ void DrawNode::drawPoly(const Vec2 *poli, unsigned int numberOfPoints, bool clos
     }
     
     V2F_C4B_T2F *point = _bufferGLLine + _bufferCountGLLine;
-    V2F_C4B_T2F *cursor = point;
     
     unsigned int i = 0;
     for(; i < numberOfPoints - 1; i++)
@@ -349,8 +411,8 @@ void DrawNode::drawPoly(const Vec2 *poli, unsigned int numberOfPoints, bool clos
         *(point + 1) = {poli[0], Color4B(color), Tex2F(0.0, 0.0)};
     }
     
-    _customCommandGLLine.updateVertexBuffer(cursor, _bufferCountGLLine*sizeof(V2F_C4B_T2F), vertex_count*sizeof(V2F_C4B_T2F));
     _bufferCountGLLine += vertex_count;
+    _dirtyGLLine = true;
     _customCommandGLLine.setVertexDrawInfo(0, _bufferCountGLLine);
 }
 
@@ -489,7 +551,6 @@ void DrawNode::drawDot(const Vec2 &pos, float radius, const Color4F &color)
     triangles[0] = triangle0;
     triangles[1] = triangle1;
     
-    _customCommand.updateVertexBuffer(triangles, _bufferCount*sizeof(V2F_C4B_T2F), vertex_count*sizeof(V2F_C4B_T2F));
     _bufferCount += vertex_count;
     _dirty = true;
     _customCommand.setVertexDrawInfo(0, _bufferCount);
@@ -571,7 +632,6 @@ void DrawNode::drawSegment(const Vec2 &from, const Vec2 &to, float radius, const
     };
     triangles[5] = triangles5;
     
-    _customCommand.updateVertexBuffer(triangles, _bufferCount*sizeof(V2F_C4B_T2F), vertex_count*sizeof(V2F_C4B_T2F));
     _bufferCount += vertex_count;
     _dirty = true;
     _customCommand.setVertexDrawInfo(0, _bufferCount);
@@ -653,7 +713,6 @@ void DrawNode::drawPolygon(const Vec2 *verts, int count, const Color4F &fillColo
         free(extrude);
     }
     
-    _customCommand.updateVertexBuffer(triangles, _bufferCount*sizeof(V2F_C4B_T2F), vertex_count*sizeof(V2F_C4B_T2F));
     _bufferCount += vertex_count;
     _customCommand.setVertexDrawInfo(0, _bufferCount);
     _dirty = true;
@@ -718,7 +777,6 @@ void DrawNode::drawTriangle(const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, cons
     V2F_C4B_T2F_Triangle triangle = {a, b, c};
     triangles[0] = triangle;
 
-    _customCommand.updateVertexBuffer(triangles, _bufferCount*sizeof(V2F_C4B_T2F), vertex_count*sizeof(V2F_C4B_T2F));
     _bufferCount += vertex_count;
     _dirty = true;
     _customCommand.setVertexDrawInfo(0, _bufferCount);
@@ -732,9 +790,90 @@ void DrawNode::clear()
     _dirtyGLLine = true;
     _bufferCountGLPoint = 0;
     _dirtyGLPoint = true;
+    if (!_retained)
+    {
+        _uploadedCount = 0;
+        _uploadedCountGLLine = 0;
+        _uploadedCountGLPoint = 0;
+    }
     _lineWidth = 0;
 }
 
+void DrawNode::setRetained(bool retained)
+{
+    if (_retained == retained)
+        return;
+
+    _retained = retained;
+
+    // create the buffers again with the usage of the mode, they are uploaded by the next draw
+    _customCommand.createVertexBuffer(sizeof(V2F_C4B_T2F), _bufferCapacity, getBufferUsage());
+    _customCommandGLPoint.createVertexBuffer(sizeof(V2F_C4B_T2F), _bufferCapacityGLPoint, getBufferUsage());
+    _customCommandGLLine.createVertexBuffer(sizeof(V2F_C4B_T2F), _bufferCapacityGLLine, getBufferUsage());
+    _uploadedCount = _uploadedCountGLPoint = _uploadedCountGLLine = 0;
+    _dirty = _dirtyGLPoint = _dirtyGLLine = true;
+
+    if (!_retained)
+    {
+        std::vector<V2F_C4B_T2F>().swap(_retainedBuffer);
+        std::vector<V2F_C4B_T2F>().swap(_retainedBufferGLPoint);
+        std::vector<V2F_C4B_T2F>().swap(_retainedBufferGLLine);
+    }
+}
+
+bool DrawNode::getSolidRect(Rect* rect) const
+{
+    // drawSolidRect() and drawPolygon() of 4 points without border make 2 triangles
+    if (_bufferCount != 6 || _bufferCountGLPoint || _bufferCountGLLine)
+        return false;
+
+    float minX = _buffer[0].vertices.x, maxX = minX;
+    float minY = _buffer[0].vertices.y, maxY = minY;
+    for (int i = 1; i < _bufferCount; ++i)
+    {
+        minX = std::min(minX, _buffer[i].vertices.x);
+        maxX = std::max(maxX, _buffer[i].vertices.x);
+        minY = std::min(minY, _buffer[i].vertices.y);
+        maxY = std::max(maxY, _buffer[i].vertices.y);
+    }
+    if (maxX <= minX || maxY <= minY)
+        return false;
+
+    // each triangle must use 3 corners of the rectangle, bit 0 of a corner index is right and bit 1 is top
+    int missingCorners[2];
+    for (int triangle = 0; triangle < 2; ++triangle)
+    {
+        unsigned int corners = 0;
+        for (int i = triangle * 3; i < triangle * 3 + 3; ++i)
+        {
+            const auto& vertex = _buffer[i].vertices;
+            if ((vertex.x != minX && vertex.x != maxX) || (vertex.y != minY && vertex.y != maxY))
+                return false;
+            corners |= 1 << ((vertex.x == maxX ? 1 : 0) + (vertex.y == maxY ? 2 : 0));
+        }
+        switch (corners)
+        {
+            case 0xE: missingCorners[triangle] = 0; break;
+            case 0xD: missingCorners[triangle] = 1; break;
+            case 0xB: missingCorners[triangle] = 2; break;
+            case 0x7: missingCorners[triangle] = 3; break;
+            default: return false;
+        }
+    }
+
+    // the triangles cover the rectangle if they miss opposite corners
+    if ((missingCorners[0] ^ missingCorners[1]) != 3)
+        return false;
+
+    rect->setRect(minX, minY, maxX - minX, maxY - minY);
+    return true;
+}
+
+CustomCommand::BufferUsage DrawNode::getBufferUsage() const
+{
+    return _retained ? CustomCommand::BufferUsage::STATIC : CustomCommand::BufferUsage::DYNAMIC;
+}
+
 const BlendFunc& DrawNode::getBlendFunc() const
 {
     return _blendFunc;
@@ -305,6 +305,24 @@ public:
 
     bool isIsolated() const { return _isolated; }
 
+    /**
+    * When retained is set, the uploaded geometry is kept and compared with the geometry drawn after clear(),
+    * only the vertices which changed are uploaded again. Use it for large overlays redrawn every frame
+    * with only a few primitives changing. Otherwise the vertices drawn since the last frame are appended
+    * to the vertex buffers. False by default.
+    */
+    void setRetained(bool retained);
+
+    bool isRetained() const { return _retained; }
+
+    /**
+    * Whether the node only draws one filled axis-aligned rectangle, as made by drawSolidRect().
+    * Used by ClippingNode to clip with a scissor rectangle instead of the stencil buffer.
+    *
+    * @param rect The rectangle in the node's coordinates, set only if true is returned.
+    */
+    bool getSolidRect(Rect* rect) const;
+
 CC_CONSTRUCTOR_ACCESS:
     DrawNode(float lineWidth = DEFAULT_LINE_WIDTH);
     virtual ~DrawNode();
@@ -319,20 +337,28 @@ protected:
     void setVertexLayout(CustomCommand& cmd);
     void updateBlendState(CustomCommand& cmd);
     void updateUniforms(const Mat4 &transform, CustomCommand& cmd);
+    void updateVertexBuffer(CustomCommand& cmd, V2F_C4B_T2F* buffer, int count, int& uploadedCount, std::vector<V2F_C4B_T2F>& retainedBuffer);
+    CustomCommand::BufferUsage getBufferUsage() const;
 
     int         _bufferCapacity = 0;
     int         _bufferCount = 0;
     V2F_C4B_T2F *_buffer = nullptr;
+    int         _uploadedCount = 0;             ///< vertices of the vertex buffer which are up to date
+    std::vector<V2F_C4B_T2F> _retainedBuffer;  ///< copy of the uploaded vertices in retained mode
     
     int         _bufferCapacityGLPoint = 0;
     int         _bufferCountGLPoint = 0;
     V2F_C4B_T2F *_bufferGLPoint = nullptr;
+    int         _uploadedCountGLPoint = 0;
+    std::vector<V2F_C4B_T2F> _retainedBufferGLPoint;
     Color4F     _pointColor;
     int         _pointSize = 0;
     
     int         _bufferCapacityGLLine = 0;
     int         _bufferCountGLLine = 0;
     V2F_C4B_T2F *_bufferGLLine = nullptr;
+    int         _uploadedCountGLLine = 0;
+    std::vector<V2F_C4B_T2F> _retainedBufferGLLine;
 
     BlendFunc   _blendFunc;
     
@@ -348,6 +374,7 @@ protected:
     bool        _dirtyGLPoint = false;
     bool        _dirtyGLLine = false;
     bool        _isolated = false;
+    bool        _retained = false;
     float       _lineWidth = 0.0f;
     
 private:
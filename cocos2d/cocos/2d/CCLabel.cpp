@@ -1860,8 +1860,12 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
-    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    bool matrixStackUsed = isMatrixStackUsed();
+    if (matrixStackUsed)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     if (!_children.empty())
     {
@@ -1892,7 +1896,8 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
         this->drawSelf(visibleByCamera, renderer, flags);
     }
 
-    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (matrixStackUsed)
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 }
 
 void Label::drawSelf(bool visibleByCamera, Renderer* renderer, uint32_t flags)
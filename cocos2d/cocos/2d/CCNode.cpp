@@ -39,8 +39,10 @@ THE SOFTWARE.
 #include "base/ccUTF8.h"
 #include "2d/CCCamera.h"
 #include "2d/CCActionManager.h"
+#include "2d/CCActionPool.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
+#include "2d/CCParallelVisitor.h"
 #include "renderer/CCMaterial.h"
 #include "math/TransformUtils.h"
 
@@ -97,6 +99,12 @@ Node::Node()
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _visitChildrenInParallel(false)
+, _matrixStackRequired(false)
+, _subtreeCullingEnabled(false)
+, _subtreeBoundsDirty(true)
+, _touchBoundsIndexed(false)
+, _touchBoundsDirty(false)
 , _isTransitionFinished(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
@@ -246,6 +254,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 float Node::getSkewY() const
@@ -260,6 +269,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 void Node::setLocalZOrder(std::int32_t z)
@@ -312,6 +322,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
     
     updateRotationQuat();
 }
@@ -329,6 +340,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -380,6 +392,7 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -394,6 +407,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
     
     updateRotationQuat();
 }
@@ -410,6 +424,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
     
     updateRotationQuat();
 }
@@ -429,6 +444,7 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 /// scaleX getter
@@ -446,6 +462,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 /// scaleX setter
@@ -456,6 +473,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 /// scaleY getter
@@ -472,6 +490,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 /// scaleY getter
@@ -488,6 +507,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 
@@ -518,6 +538,7 @@ void Node::setPosition(float x, float y)
     _position.y = y;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
     _usingNormalizedPosition = false;
 }
 
@@ -563,6 +584,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 
     _positionZ = positionZ;
 }
@@ -583,6 +605,7 @@ void Node::setPositionNormalized(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -604,6 +627,10 @@ void Node::setVisible(bool visible)
         _visible = visible;
         if(_visible)
             _transformUpdated = _transformDirty = _inverseDirty = true;
+        // getSubtreeBounds() skips invisible nodes, so this node may be dirty below clean ancestors
+        _subtreeBoundsDirty = true;
+        if (_parent)
+            _parent->invalidateSubtreeBounds();
     }
 }
 
@@ -625,6 +652,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        invalidateSubtreeBounds();
     }
 }
 
@@ -642,6 +670,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        invalidateSubtreeBounds();
     }
 }
 
@@ -654,8 +683,14 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node * parent)
 {
+    if (_parent)
+        _parent->invalidateSubtreeBounds();
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    // the new ancestors may not be dirty yet
+    _subtreeBoundsDirty = true;
+    if (_parent)
+        _parent->invalidateSubtreeBounds();
 }
 
 /// isRelativeAnchorPoint getter
@@ -671,6 +706,7 @@ void Node::setIgnoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        invalidateSubtreeBounds();
     }
 }
 
@@ -1178,6 +1214,11 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
             _position.x = _normalizedPosition.x * s.width;
             _position.y = _normalizedPosition.y * s.height;
             _transformUpdated = _transformDirty = _inverseDirty = true;
+            // the ancestors are shared by the threads of a parallel visit, they are invalidated once it is done
+            if (Renderer::isRecording())
+                ParallelVisitor::getInstance()->invalidateSubtreeBoundsLater(this);
+            else
+                invalidateSubtreeBounds();
             _normalizedPositionDirty = false;
         }
     }
@@ -1193,7 +1234,14 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     
 
     if(flags & FLAGS_DIRTY_MASK)
+    {
         _modelViewTransform = this->transform(parentTransform);
+        if (_touchBoundsIndexed && !_touchBoundsDirty)
+        {
+            _touchBoundsDirty = true;
+            _eventDispatcher->_touchSpatialIndex.markDirty(this);
+        }
+    }
     
     _transformUpdated = false;
     _contentSizeDirty = false;
@@ -1201,6 +1249,45 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     return flags;
 }
 
+void Node::invalidateSubtreeBounds()
+{
+    // stop at the first dirty node, its ancestors are already dirty unless it is invisible, @see setVisible()
+    for (auto node = this; node && !node->_subtreeBoundsDirty; node = node->_parent)
+    {
+        node->_subtreeBoundsDirty = true;
+    }
+}
+
+const Rect& Node::getSubtreeBounds()
+{
+    if (_subtreeBoundsDirty)
+    {
+        _subtreeBounds.setRect(0, 0, _contentSize.width, _contentSize.height);
+        for (const auto& child : _children)
+        {
+            if (!child->_visible)
+                continue;
+
+            auto& childBounds = child->getSubtreeBounds();
+            if (childBounds.size.equals(Size::ZERO))
+                continue;
+
+            auto rect = RectApplyTransform(childBounds, child->getNodeToParentTransform());
+            if (_subtreeBounds.size.equals(Size::ZERO))
+                _subtreeBounds = rect;
+            else
+                _subtreeBounds.merge(rect);
+        }
+        _subtreeBoundsDirty = false;
+    }
+    return _subtreeBounds;
+}
+
+bool Node::isMatrixStackUsed() const
+{
+    return _matrixStackRequired || _director->isMatrixStackCompatibilityEnabled();
+}
+
 bool Node::isVisitableByVisitingCamera() const
 {
     auto camera = Camera::getVisitingCamera();
@@ -1218,17 +1305,50 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
 
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
 
+    // skip the whole subtree if its bounds are out of the screen
+    if (_subtreeCullingEnabled)
+    {
+        CCASSERT(!Renderer::isRecording(), "Subtree culling doesn't work with nodes visited in parallel");
+        auto& bounds = getSubtreeBounds();
+        if (!bounds.size.equals(Size::ZERO))
+        {
+            Mat4 boundsTransform;
+            _modelViewTransform.translate(bounds.origin.x, bounds.origin.y, 0, &boundsTransform);
+            if (!renderer->checkVisibility(boundsTransform, bounds.size))
+                return;
+        }
+    }
+
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
-    // but it is deprecated and your code should not rely on it
-    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    // but it is deprecated and only updated for the nodes requiring it
+    bool matrixStackUsed = isMatrixStackUsed();
+    if (matrixStackUsed)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     bool visibleByCamera = isVisitableByVisitingCamera();
 
     int i = 0;
 
-    if(!_children.empty())
+    if(_visitChildrenInParallel && _children.size() > 1 && !Renderer::isRecording()
+       && ParallelVisitor::getInstance()->getThreadCount() > 0)
+    {
+        sortAllChildren();
+        auto visitor = ParallelVisitor::getInstance();
+        visitor->visit(_children, renderer, _modelViewTransform, flags);
+
+        // add the recorded commands in the order of a serial visit
+        for(auto size = _children.size(); i < size && _children.at(i)->_localZOrder < 0; ++i)
+            visitor->replay(renderer, i);
+        if (visibleByCamera)
+            this->draw(renderer, _modelViewTransform, flags);
+        for(auto size = _children.size(); i < size; ++i)
+            visitor->replay(renderer, i);
+    }
+    else if(!_children.empty())
     {
         sortAllChildren();
         // draw children zOrder < 0
@@ -1253,7 +1373,8 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
         this->draw(renderer, _modelViewTransform, flags);
     }
 
-    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (matrixStackUsed)
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -1424,6 +1545,17 @@ Action * Node::runAction(Action* action)
     return action;
 }
 
+Action * Node::runPooledAction(Action* prototype)
+{
+    CCASSERT( prototype != nullptr, "Argument must be non-nil");
+    auto action = ActionPool::getInstance()->getAction(prototype);
+    if (action)
+    {
+        runAction(action);
+    }
+    return action;
+}
+
 void Node::stopAllActions()
 {
     _actionManager->removeAllActionsFromTarget(this);
@@ -1772,6 +1904,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    invalidateSubtreeBounds();
 
     if (_additionalTransform)
         // _additionalTransform[1] has a copy of lastest transform
@@ -1805,6 +1938,7 @@ void Node::setAdditionalTransform(const Mat4* additionalTransform)
         _additionalTransform[0] = *additionalTransform;
     }
     _transformUpdated = _additionalTransformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 void Node::setAdditionalTransform(const Mat4& additionalTransform)
@@ -1122,6 +1122,72 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Sets whether the children are visited in parallel, on the threads of the ParallelVisitor.
+     * The commands added by the children are recorded and added in the same order as a serial visit.
+     * The children and their descendants must not create or release shared objects when they are visited,
+     * e.g. a Label whose text changed, a RenderTexture or autoreleased objects. Nested parallel visits are serial.
+     * Subtree culling can't be enabled on the children and their descendants, @see setSubtreeCullingEnabled().
+     * False by default.
+     *
+     * @param visitChildrenInParallel True to visit the children in parallel.
+     * @js NA
+     */
+    void setVisitChildrenInParallel(bool visitChildrenInParallel) { _visitChildrenInParallel = visitChildrenInParallel; }
+
+    /**
+     * Gets whether the children are visited in parallel.
+     *
+     * @return True if the children are visited in parallel.
+     * @js NA
+     */
+    bool isVisitChildrenInParallel() const { return _visitChildrenInParallel; }
+
+    /**
+     * Sets whether the model view transform of the node is loaded on the top of the deprecated MODELVIEW matrix stack
+     * while it is drawn and its children are visited. Only needed if its draw() or the code it invokes reads the stack,
+     * the transforms are passed to visit() and draw() otherwise. False by default.
+     * @see Director::setMatrixStackCompatibilityEnabled()
+     *
+     * @param required True to load the model view transform on the matrix stack.
+     * @js NA
+     */
+    void setMatrixStackRequired(bool required) { _matrixStackRequired = required; }
+
+    /**
+     * Gets whether the model view transform of the node is loaded on the deprecated MODELVIEW matrix stack.
+     *
+     * @return True if the model view transform is loaded on the matrix stack.
+     * @js NA
+     */
+    bool isMatrixStackRequired() const { return _matrixStackRequired; }
+
+    /**
+     * Sets whether the whole subtree is skipped by visit() when its bounds are out of the screen.
+     * The bounds are the union of the content rects of the visible nodes in the subtree, @see getSubtreeBounds(),
+     * so the subtree must not draw outside of them, e.g. a DrawNode or particles without content size.
+     * Only the default camera culls, like the culling of sprites. It doesn't work with nodes visited in parallel,
+     * @see setVisitChildrenInParallel(). False by default.
+     *
+     * @param enabled True to skip the subtree when it is out of the screen.
+     */
+    void setSubtreeCullingEnabled(bool enabled) { _subtreeCullingEnabled = enabled; }
+
+    /**
+     * Gets whether the whole subtree is skipped by visit() when its bounds are out of the screen.
+     *
+     * @return True if the subtree is skipped when it is out of the screen.
+     */
+    bool isSubtreeCullingEnabled() const { return _subtreeCullingEnabled; }
+
+    /**
+     * Returns the union of the content rects of this node and of its visible descendants, in the node's coordinates.
+     * The bounds are cached and only computed again when a node of the subtree changed.
+     *
+     * @return The bounds of the subtree, a zero rect if no node has a content size.
+     */
+    const Rect& getSubtreeBounds();
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1178,6 +1244,17 @@ public:
      */
     virtual Action* runAction(Action* action);
 
+    /**
+     * Executes an instance of a prototype action taken from the ActionPool, and returns it.
+     * The instance is only allocated if all instances of the prototype are running,
+     * which suits effects run again and again such as hit flashes.
+     *
+     * @param prototype The action to instantiate, it must not be run itself.
+     * @see ActionPool
+     * @js NA
+     */
+    Action* runPooledAction(Action* prototype);
+
     /**
      * Stops and removes all actions from the running action list .
      */
@@ -1792,6 +1869,10 @@ protected:
 
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
+    /// Whether visit() loads the model view transform on the matrix stack, @see setMatrixStackRequired().
+    bool isMatrixStackUsed() const;
+    /// Marks the subtree bounds of this node and of its ancestors as changed, @see getSubtreeBounds().
+    void invalidateSubtreeBounds();
 
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
@@ -1901,6 +1982,13 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+    bool _visitChildrenInParallel;    ///< whether the children are visited in parallel
+    bool _matrixStackRequired;        ///< whether the model view transform is loaded on the matrix stack while visited
+    bool _subtreeCullingEnabled;      ///< whether the subtree is skipped when it is out of the screen
+    bool _subtreeBoundsDirty;         ///< whether _subtreeBounds must be computed again, all the ancestors of a dirty node are dirty
+    Rect _subtreeBounds;              ///< cached bounds of the subtree, @see getSubtreeBounds()
+    bool _touchBoundsIndexed;         ///< whether the node has touch listeners with touch bounds culling
+    bool _touchBoundsDirty;           ///< whether the node is queued in the TouchSpatialIndex to compute its bounds again
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -1947,6 +2035,11 @@ public:
     friend class PhysicsBody;
 #endif
 
+    // reads the order of arrival to sort the scene graph priority listeners
+    friend class EventDispatcher;
+    friend class TouchSpatialIndex;
+    friend class ParallelVisitor;
+
     static int __attachedNodeCount;
     
 private:
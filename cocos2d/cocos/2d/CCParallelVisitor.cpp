@@ -0,0 +1,189 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCParallelVisitor.h"
+
+#include <algorithm>
+
+#include "2d/CCNode.h"
+#include "base/CCDirector.h"
+
+NS_CC_BEGIN
+
+static ParallelVisitor* s_sharedParallelVisitor = nullptr;
+
+ParallelVisitor* ParallelVisitor::getInstance()
+{
+    if (!s_sharedParallelVisitor)
+    {
+        s_sharedParallelVisitor = new (std::nothrow) ParallelVisitor();
+    }
+    return s_sharedParallelVisitor;
+}
+
+void ParallelVisitor::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedParallelVisitor);
+}
+
+ParallelVisitor::ParallelVisitor()
+: _nextNode(0)
+{
+    int hardwareThreads = (int)std::thread::hardware_concurrency();
+    _threadCount = std::min(std::max(hardwareThreads - 1, 0), 7);
+}
+
+ParallelVisitor::~ParallelVisitor()
+{
+    stopThreads();
+}
+
+void ParallelVisitor::setThreadCount(int count)
+{
+    CCASSERT(count >= 0, "Invalid thread count");
+    if (count == _threadCount)
+        return;
+
+    stopThreads();
+    _threadCount = count;
+}
+
+void ParallelVisitor::startThreads()
+{
+    _quit = false;
+    for (int i = 0; i < _threadCount; ++i)
+    {
+        _threads.emplace_back(&ParallelVisitor::threadLoop, this, _generation);
+    }
+}
+
+void ParallelVisitor::stopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _startCondition.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+void ParallelVisitor::threadLoop(unsigned int generation)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _startCondition.wait(lock, [this, generation]() { return _quit || _generation != generation; });
+            if (_quit)
+                return;
+            generation = _generation;
+        }
+
+        visitNodes();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_busyThreads == 0)
+                _doneCondition.notify_one();
+        }
+    }
+}
+
+void ParallelVisitor::visit(const Vector<Node*>& nodes, Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    CCASSERT(!Renderer::isRecording(), "Parallel visits can't be nested");
+
+    if (_threads.empty() && _threadCount > 0)
+        startThreads();
+
+    // only grows, so that the recordings keep their storage from one frame to the next
+    if (_recordings.size() < (size_t)nodes.size())
+        _recordings.resize(nodes.size());
+
+    auto director = Director::getInstance();
+    _nodes = &nodes;
+    _renderer = renderer;
+    _parentTransform = parentTransform;
+    _parentFlags = parentFlags;
+    _projection = director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    _texture = director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE);
+    _nextNode = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_generation;
+        _busyThreads = (int)_threads.size();
+    }
+    _startCondition.notify_all();
+
+    // the main thread visits nodes too
+    visitNodes();
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _doneCondition.wait(lock, [this]() { return _busyThreads == 0; });
+        _nodes = nullptr;
+    }
+
+    for (auto node : _invalidatedNodes)
+    {
+        node->invalidateSubtreeBounds();
+    }
+    _invalidatedNodes.clear();
+}
+
+void ParallelVisitor::visitNodes()
+{
+    auto director = Director::getInstance();
+    auto count = _nodes->size();
+    for (auto index = _nextNode++; index < count; index = _nextNode++)
+    {
+        auto& recording = _recordings[index];
+        recording.clear();
+
+        director->beginThreadMatrixStacks(_parentTransform, _projection, _texture);
+        _renderer->beginRecording(&recording);
+        _nodes->at(index)->visit(_renderer, _parentTransform, _parentFlags);
+        _renderer->endRecording();
+        director->endThreadMatrixStacks();
+    }
+}
+
+void ParallelVisitor::invalidateSubtreeBoundsLater(Node* node)
+{
+    std::lock_guard<std::mutex> lock(_invalidatedNodesMutex);
+    _invalidatedNodes.push_back(node);
+}
+
+void ParallelVisitor::replay(Renderer* renderer, ssize_t index)
+{
+    CCASSERT(index >= 0 && index < (ssize_t)_recordings.size(), "Invalid index");
+    renderer->replay(_recordings[index]);
+}
+
+NS_CC_END
@@ -0,0 +1,121 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCVector.h"
+#include "math/CCMath.h"
+#include "renderer/CCRenderer.h"
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+NS_CC_BEGIN
+
+class Node;
+
+/**
+ * @class ParallelVisitor
+ * @brief Visits sibling nodes on several threads, used by the nodes whose children are visited in parallel.
+ * Each child is visited with its own matrix stacks and its commands are recorded, the recordings are then replayed
+ * on the main thread in the order of a serial visit, so the rendered result doesn't change.
+ * @see Node::setVisitChildrenInParallel()
+ * @js NA
+ */
+class CC_DLL ParallelVisitor
+{
+public:
+    /** Returns the shared instance. */
+    static ParallelVisitor* getInstance();
+
+    /** Destroys the shared instance, its threads are stopped. */
+    static void destroyInstance();
+
+    /**
+     * Sets the number of threads helping the main thread, the threads are created when the next visit starts.
+     * 0 disables the parallel visits. The default value is the number of hardware threads minus 1, up to 7.
+     */
+    void setThreadCount(int count);
+
+    /** Gets the number of threads helping the main thread. */
+    int getThreadCount() const { return _threadCount; }
+
+    /**
+     * Visits the nodes in parallel, each one as if its visit(renderer, parentTransform, parentFlags) was invoked.
+     * The added commands are recorded and must then be added by replay(), in the order they have to be rendered.
+     */
+    void visit(const Vector<Node*>& nodes, Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags);
+
+    /** Adds the commands recorded by the visit of the node at index to the renderer. */
+    void replay(Renderer* renderer, ssize_t index);
+
+    /**
+     * Invalidates the subtree bounds of a node and its ancestors once the current visit is done,
+     * the ancestors may be visited by other threads meanwhile. It is thread-safe.
+     */
+    void invalidateSubtreeBoundsLater(Node* node);
+
+protected:
+    ParallelVisitor();
+    ~ParallelVisitor();
+
+    void startThreads();
+    void stopThreads();
+    void threadLoop(unsigned int generation);
+    void visitNodes();
+
+    std::vector<std::thread> _threads;
+    std::vector<CommandRecording> _recordings;
+    int _threadCount;
+
+    std::mutex _mutex;
+    std::condition_variable _startCondition;
+    std::condition_variable _doneCondition;
+    unsigned int _generation = 0;
+    int _busyThreads = 0;
+    bool _quit = false;
+
+    // the current visit
+    std::atomic<ssize_t> _nextNode;
+    std::mutex _invalidatedNodesMutex;
+    std::vector<Node*> _invalidatedNodes;
+    const Vector<Node*>* _nodes = nullptr;
+    Renderer* _renderer = nullptr;
+    Mat4 _parentTransform;
+    Mat4 _projection;
+    Mat4 _texture;
+    uint32_t _parentFlags = 0;
+};
+
+NS_CC_END
+// end of _2d group
+/// @}
@@ -163,12 +163,17 @@ void ParticleBatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, u
         // To ease the migration to v3.0, we still support the Mat4 stack,
         // but it is deprecated and your code should not rely on it
         Director* director = Director::getInstance();
-        director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-        director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+        bool matrixStackUsed = isMatrixStackUsed();
+        if (matrixStackUsed)
+        {
+            director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+            director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+        }
         
         draw(renderer, _modelViewTransform, flags);
         
-        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        if (matrixStackUsed)
+            director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     }
 }
 
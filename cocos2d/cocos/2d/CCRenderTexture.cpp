@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/CCEventType.h"
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
+#include "base/CCAsyncTaskPool.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "renderer/CCRenderer.h"
@@ -41,6 +42,9 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+// count of render textures between begin() and end(), visits are recorded per thread
+static thread_local int s_grabbingCount = 0;
+
 // implementation RenderTexture
 RenderTexture::RenderTexture()
 {
@@ -439,20 +443,30 @@ bool RenderTexture::saveToFile(const std::string& fileName, Image::Format format
 
 void RenderTexture::onSaveToFile(const std::string& filename, bool isRGBA, bool forceNonPMA)
 {
-    auto callbackFunc = [&, filename, isRGBA, forceNonPMA](Image* image){
-        if (image)
+    auto callbackFunc = [this, filename, isRGBA, forceNonPMA](Image* image){
+        // encode in the TASK_IO thread and invoke the callback in the main thread, so that saving doesn't stall the frame
+        auto saveFileCallback = _saveFileCallback;
+        this->retain();
+        auto mainThread = [this, filename, saveFileCallback](void* /*param*/)
         {
-            if (forceNonPMA && image->hasPremultipliedAlpha())
+            if (saveFileCallback)
             {
-                image->reversePremultipliedAlpha();
+                saveFileCallback(this, filename);
             }
-            image->saveToFile(filename, !isRGBA);
-        }
-        if(_saveFileCallback)
+            this->release();
+        };
+        AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, std::move(mainThread), nullptr, [image, filename, isRGBA, forceNonPMA]()
         {
-            _saveFileCallback(this, filename);
-        }
-        CC_SAFE_DELETE(image);
+            if (image)
+            {
+                if (forceNonPMA && image->hasPremultipliedAlpha())
+                {
+                    image->reversePremultipliedAlpha();
+                }
+                image->saveToFile(filename, !isRGBA);
+            }
+            delete image;
+        });
     };
     newImage(callbackFunc);
 }
@@ -477,9 +491,19 @@ void RenderTexture::newImage(std::function<void(Image*)> imageCallback, bool fli
     
     Image *image = new (std::nothrow) Image();
     
-    auto initCallback = [&, savedBufferWidth, savedBufferHeight, imageCallback](Image* image, const unsigned char* tempData){
-        image->initWithRawData(tempData, savedBufferWidth * savedBufferHeight * 4, savedBufferWidth, savedBufferHeight, 8, _texture2D->hasPremultipliedAlpha());
+    // the pixels may be delivered by a later frame, keep the render texture alive until then
+    this->retain();
+    auto initCallback = [this, savedBufferWidth, savedBufferHeight, imageCallback](Image* image, const unsigned char* tempData){
+        if (tempData)
+        {
+            image->initWithRawData(tempData, savedBufferWidth * savedBufferHeight * 4, savedBufferWidth, savedBufferHeight, 8, _texture2D->hasPremultipliedAlpha());
+        }
+        else
+        {
+            CC_SAFE_DELETE(image);
+        }
         imageCallback(image);
+        this->release();
     };
     auto callback = std::bind(initCallback, image, std::placeholders::_1);
     
@@ -619,6 +643,7 @@ void RenderTexture::begin()
     _beginCommand.init(_globalZOrder);
     _beginCommand.func = CC_CALLBACK_0(RenderTexture::onBegin, this);
     renderer->addCommand(&_beginCommand);
+    ++s_grabbingCount;
 }
 
 void RenderTexture::end()
@@ -635,6 +660,14 @@ void RenderTexture::end()
 
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+
+    if (s_grabbingCount > 0)
+        --s_grabbingCount;
+}
+
+bool RenderTexture::isGrabbing()
+{
+    return s_grabbingCount > 0;
 }
 
 void RenderTexture::setClearFlags(ClearFlag clearFlags)
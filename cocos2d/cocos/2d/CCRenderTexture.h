@@ -130,6 +130,12 @@ public:
      */
     virtual void end();
 
+    /** Whether a render texture is grabbing on the calling thread, i.e. nodes visited now are drawn to its texture.
+     *
+     * @return True if begin() of a render texture is called and its end() is not called yet.
+     */
+    static bool isGrabbing();
+
     /** Clears the texture with a color. 
      *
      * @param r Red.
@@ -153,6 +159,8 @@ public:
     
     /* Creates a new Image from with the texture's data.
      * Caller is responsible for releasing it by calling delete.
+     * The pixels are read without stalling where the backend supports it, so the callback may be invoked
+     * by a later frame. The image is null if the pixels could not be read.
      *
      * @param flipImage Whether or not to flip image.
      * @return An image.
@@ -176,7 +176,11 @@ bool Sprite::initWithFile(const std::string& filename)
 
     _fileName = filename;
 
-    Texture2D *texture = _director->getTextureCache()->addImage(filename);
+    auto textureCache = _director->getTextureCache();
+    if (auto region = textureCache->addImageInDynamicAtlas(filename))
+        return initWithTexture(region->page, CC_RECT_PIXELS_TO_POINTS(region->rect));
+
+    Texture2D *texture = textureCache->addImage(filename);
     if (texture)
     {
         Rect rect = Rect::ZERO;
@@ -198,7 +202,14 @@ bool Sprite::initWithFile(const std::string &filename, const Rect& rect)
 
     _fileName = filename;
 
-    Texture2D *texture = _director->getTextureCache()->addImage(filename);
+    auto textureCache = _director->getTextureCache();
+    if (auto region = textureCache->addImageInDynamicAtlas(filename))
+    {
+        auto origin = CC_POINT_PIXELS_TO_POINTS(region->rect.origin);
+        return initWithTexture(region->page, Rect(rect.origin + origin, rect.size));
+    }
+
+    Texture2D *texture = textureCache->addImage(filename);
     if (texture)
         return initWithTexture(texture, rect);
 
@@ -336,7 +347,16 @@ static unsigned char cc_2x2_white_image[] = {
 // MARK: texture
 void Sprite::setTexture(const std::string &filename)
 {
-    Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(filename);
+    auto textureCache = Director::getInstance()->getTextureCache();
+    if (auto region = textureCache->addImageInDynamicAtlas(filename))
+    {
+        setTexture(region->page);
+        _unflippedOffsetPositionFromCenter = Vec2::ZERO;
+        setTextureRect(CC_RECT_PIXELS_TO_POINTS(region->rect));
+        return;
+    }
+
+    Texture2D *texture = textureCache->addImage(filename);
     setTexture(texture);
     _unflippedOffsetPositionFromCenter = Vec2::ZERO;
     Rect rect = Rect::ZERO;
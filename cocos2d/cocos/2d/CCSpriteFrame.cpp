@@ -118,6 +118,15 @@ bool SpriteFrame::initWithTexture(Texture2D* texture, const Rect& rect, bool rot
 
 bool SpriteFrame::initWithTextureFilename(const std::string& filename, const Rect& rect, bool rotated, const Vec2& offset, const Size& originalSize)
 {
+    // the image is loaded now if it can be packed into the dynamic atlas, the rect is moved into its page
+    if (auto region = Director::getInstance()->getTextureCache()->addImageInDynamicAtlas(filename))
+    {
+        // like rect, the region and the rect passed to initWithTexture() are in pixels
+        Rect rectInPixels = rect;
+        rectInPixels.origin += region->rect.origin;
+        return initWithTexture(region->page, rectInPixels, rotated, offset, originalSize);
+    }
+
     if (FileUtils::getInstance()->isFileExist(filename)) {
         _texture = nullptr;
         _textureFilename = filename;
@@ -124,8 +124,12 @@ void BillBoard::visit(Renderer *renderer, const Mat4& parentTransform, uint32_t
     }
     
     Director* director = Director::getInstance();
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    bool matrixStackUsed = isMatrixStackUsed();
+    if (matrixStackUsed)
+    {
+        director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     int i = 0;
     
@@ -154,7 +158,8 @@ void BillBoard::visit(Renderer *renderer, const Mat4& parentTransform, uint32_t
         this->draw(renderer, _modelViewTransform, flags);
     }
     
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (matrixStackUsed)
+        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 }
 
 bool BillBoard::calculateBillboardTransform()
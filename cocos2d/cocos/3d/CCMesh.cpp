@@ -426,6 +426,7 @@ void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, u
         command.setSkipBatching(isTransparent);
         command.setTransparent(isTransparent);
         command.set3D(!_force2DQueue);
+        command.setInstanceColor(color);
     }
 
     _material->draw(commands.data(), globalZ,
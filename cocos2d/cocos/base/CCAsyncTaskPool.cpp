@@ -47,10 +47,38 @@ void AsyncTaskPool::destroyInstance()
 
 AsyncTaskPool::AsyncTaskPool()
 {
+    for (auto& generation : _generations)
+    {
+        generation.store(0);
+    }
 }
 
 AsyncTaskPool::~AsyncTaskPool()
 {
 }
 
+void AsyncTaskPool::stopTasks(TaskType type)
+{
+    ++_generations[(int)type];
+}
+
+void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, TaskCallBack callback, void* callbackParam, std::function<void()> task)
+{
+    auto& generation = _generations[(int)type];
+    unsigned int enqueuedGeneration = generation.load();
+
+    _jobSystem.schedule([&generation, enqueuedGeneration, callback, callbackParam, task]() {
+        if (generation.load() != enqueuedGeneration)
+            return;
+
+        task();
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread(std::bind(callback, callbackParam));
+    });
+}
+
+void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, std::function<void()> task)
+{
+    enqueue(type, [](void*) {}, nullptr, std::move(task));
+}
+
 NS_CC_END
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCJobSystem.h"
+#include <atomic>
 #include <vector>
 #include <queue>
 #include <memory>
@@ -49,6 +51,7 @@ NS_CC_BEGIN
 /**
  * @class AsyncTaskPool
  * @brief This class allows to perform background operations without having to manipulate threads.
+ * The tasks of all types are run by a shared JobSystem, so they may run in parallel, even tasks of the same type.
  * @js NA
  */
 class CC_DLL AsyncTaskPool
@@ -77,14 +80,14 @@ public:
     /**
      * Stop tasks.
      *
-     * @param type Task type you want to stop.
+     * @param type Task type you want to stop, the tasks of this type not started yet are discarded.
      */
     void stopTasks(TaskType type);
     
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others.
      * @param callback callback when the task is finished. The callback is called in the main thread instead of task thread.
      * @param callbackParam parameter used by the callback.
      * @param task: task can be lambda function to be performed off thread.
@@ -95,136 +98,33 @@ public:
     /**
     * Enqueue a asynchronous task.
     *
-    * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+    * @param type task type is io task, network task or others.
     * @param task: task can be lambda function to be performed off thread.
     * @lua NA
     */
     void enqueue(AsyncTaskPool::TaskType type, std::function<void()> task);
+
+    /**
+     * Returns the job system running the tasks.
+     * It can be used directly to schedule jobs with priorities, dependencies and completion callbacks.
+     * @lua NA
+     */
+    JobSystem* getJobSystem() { return &_jobSystem; }
     
 CC_CONSTRUCTOR_ACCESS:
     AsyncTaskPool();
     ~AsyncTaskPool();
     
 protected:
-    
-    // thread tasks internally used
-    class ThreadTasks {
-        struct AsyncTaskCallBack
-        {
-            TaskCallBack          callback;
-            void*                 callbackParam;
-        };
-    public:
-        ThreadTasks()
-        : _stop(false)
-        {
-            _thread = std::thread(
-                                  [this]
-                                  {
-                                      for(;;)
-                                      {
-                                          std::function<void()> task;
-                                          AsyncTaskCallBack callback;
-                                          {
-                                              std::unique_lock<std::mutex> lock(this->_queueMutex);
-                                              this->_condition.wait(lock,
-                                                                    [this]{ return this->_stop || !this->_tasks.empty(); });
-                                              if(this->_stop && this->_tasks.empty())
-                                                  return;
-                                              task = std::move(this->_tasks.front());
-                                              callback = std::move(this->_taskCallBacks.front());
-                                              this->_tasks.pop();
-                                              this->_taskCallBacks.pop();
-                                          }
-                                          
-                                          task();
-                                          Director::getInstance()->getScheduler()->performFunctionInCocosThread(std::bind(callback.callback, callback.callbackParam));
-                                      }
-                                  }
-                                  );
-        }
-        ~ThreadTasks()
-        {
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                _stop = true;
-                
-                while(_tasks.size())
-                    _tasks.pop();
-                while (_taskCallBacks.size())
-                    _taskCallBacks.pop();
-            }
-            _condition.notify_all();
-            _thread.join();
-        }
-        void clear()
-        {
-            std::unique_lock<std::mutex> lock(_queueMutex);
-            while(_tasks.size())
-                _tasks.pop();
-            while (_taskCallBacks.size())
-                _taskCallBacks.pop();
-        }
-
-        void enqueue(TaskCallBack callback, void* callbackParam, std::function<void()> task)
-        {
-            AsyncTaskCallBack taskCallBack;
-            taskCallBack.callback = std::move(callback);
-            taskCallBack.callbackParam = callbackParam;
+    // incremented by stopTasks(), a task is discarded if the generation of its type changed since it was enqueued
+    std::atomic<unsigned int> _generations[int(TaskType::TASK_MAX_TYPE)];
 
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                
-                // don't allow enqueueing after stopping the pool
-                if(_stop)
-                {
-                    CC_ASSERT(0 && "already stop");
-                    return;
-                }
-                
-                _tasks.push(std::move(task));
-                _taskCallBacks.push(std::move(taskCallBack));
-            }
-            _condition.notify_one();
-        }
-    private:
-        
-        // need to keep track of thread so we can join them
-        std::thread _thread;
-        // the task queue
-        std::queue< std::function<void()> > _tasks;
-        std::queue<AsyncTaskCallBack> _taskCallBacks;
-        
-        // synchronization
-        std::mutex _queueMutex;
-        std::condition_variable _condition;
-        bool _stop;
-    };
-    
-    //tasks
-    ThreadTasks _threadTasks[int(TaskType::TASK_MAX_TYPE)];
+    // destroyed first, so the running tasks can still read the generations
+    JobSystem _jobSystem;
     
     static AsyncTaskPool* s_asyncTaskPool;
 };
 
-inline void AsyncTaskPool::stopTasks(TaskType type)
-{
-    auto& threadTask = _threadTasks[(int)type];
-    threadTask.clear();
-}
-
-inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, TaskCallBack callback, void* callbackParam, std::function<void()> task)
-{
-    auto& threadTask = _threadTasks[(int)type];
-    
-    threadTask.enqueue(std::move(callback), callbackParam, std::move(task));
-}
-
-inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, std::function<void()> task)
-{
-    enqueue(type, [](void*) {}, nullptr, std::move(task));
-}
-
 NS_CC_END
 // end group
 /// @}
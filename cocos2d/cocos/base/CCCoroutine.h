@@ -0,0 +1,428 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * C++20 coroutines are only available when the game is compiled as C++20, the engine itself is C++11.
+ * CC_COROUTINES_SUPPORTED tells whether the types of this file are defined.
+ */
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define CC_COROUTINES_SUPPORTED 1
+#else
+#define CC_COROUTINES_SUPPORTED 0
+#endif
+
+#if CC_COROUTINES_SUPPORTED
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCAsyncTaskPool.h"
+#include "platform/CCFileUtils.h"
+#include "renderer/CCTextureCache.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+template <typename T> class Task;
+
+/**
+ * @class AsyncOperation
+ * @brief Result of an asynchronous operation, which can be awaited by a coroutine.
+ * The operation is started when it is created, so several operations can run in parallel before being awaited.
+ * The awaiting coroutine is always resumed in the cocos thread, by Scheduler::performFunctionInCocosThread().
+ * Any callback based API can be adapted by completing the operation from its callback:
+ * @code
+ * AsyncOperation<network::HttpResponse*> response;
+ * request->setResponseCallback([response](network::HttpClient*, network::HttpResponse* r) {
+ *     r->retain();
+ *     response.complete(r);
+ * });
+ * network::HttpClient::getInstance()->send(request);
+ * auto r = co_await response;
+ * @endcode
+ * @js NA
+ */
+template <typename T>
+class AsyncOperation
+{
+public:
+    AsyncOperation() : _state(std::make_shared<State>()) {}
+
+    /** Completes the operation with its result, from any thread. Only the first call is taken into account. */
+    void complete(T value) const
+    {
+        auto state = _state;
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([state, value = std::move(value)]() mutable {
+            if (state->value)
+                return;
+
+            state->value.emplace(std::move(value));
+            if (state->continuation)
+            {
+                std::exchange(state->continuation, nullptr).resume();
+            }
+        });
+    }
+
+    /** Whether the result is available, from the cocos thread. */
+    bool isDone() const { return _state->value.has_value(); }
+
+    bool await_ready() const noexcept { return isDone(); }
+    void await_suspend(std::coroutine_handle<> continuation) const noexcept { _state->continuation = continuation; }
+
+    /** The result is moved to the awaiting coroutine, an operation should be awaited once. */
+    T await_resume() const { return std::move(*_state->value); }
+
+private:
+    struct State
+    {
+        std::optional<T> value;
+        std::coroutine_handle<> continuation;
+    };
+    std::shared_ptr<State> _state;
+};
+
+/** AsyncOperation without result. */
+template <>
+class AsyncOperation<void>
+{
+public:
+    AsyncOperation() : _state(std::make_shared<State>()) {}
+
+    void complete() const
+    {
+        auto state = _state;
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([state]() {
+            completeState(*state);
+        });
+    }
+
+    /** Completes the operation from the cocos thread, the awaiting coroutine is resumed before it returns. */
+    void completeInCocosThread() const { completeState(*_state); }
+
+    bool isDone() const { return _state->done; }
+
+    bool await_ready() const noexcept { return isDone(); }
+    void await_suspend(std::coroutine_handle<> continuation) const noexcept { _state->continuation = continuation; }
+    void await_resume() const noexcept {}
+
+private:
+    struct State
+    {
+        bool done = false;
+        std::coroutine_handle<> continuation;
+    };
+
+    static void completeState(State& state)
+    {
+        if (state.done)
+            return;
+
+        state.done = true;
+        if (state.continuation)
+        {
+            std::exchange(state.continuation, nullptr).resume();
+        }
+    }
+
+    std::shared_ptr<State> _state;
+};
+
+namespace coroutine_detail
+{
+    struct TaskPromiseBase
+    {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+        bool detached = false;
+
+        // a task starts when it is awaited or started
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+            {
+                auto& promise = handle.promise();
+                if (promise.continuation)
+                    return promise.continuation;
+
+                if (promise.detached)
+                    handle.destroy();
+                return std::noop_coroutine();
+            }
+
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    template <typename T>
+    struct TaskPromise : TaskPromiseBase
+    {
+        std::optional<T> value;
+
+        Task<T> get_return_object();
+
+        template <typename U>
+        void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+        T result()
+        {
+            if (exception)
+                std::rethrow_exception(exception);
+            return std::move(*value);
+        }
+    };
+
+    template <>
+    struct TaskPromise<void> : TaskPromiseBase
+    {
+        Task<void> get_return_object();
+
+        void return_void() {}
+
+        void result()
+        {
+            if (exception)
+                std::rethrow_exception(exception);
+        }
+    };
+}
+
+/**
+ * @class Task
+ * @brief Coroutine returning a T, run in the cocos thread.
+ * A task starts when it is awaited by another coroutine, or when start() is invoked.
+ * Exceptions thrown by the coroutine are rethrown to the awaiting coroutine, those of a started task are lost.
+ * @code
+ * Task<void> loadVillage()
+ * {
+ *     // both loads run in parallel
+ *     auto texture = async::loadTexture("village.png");
+ *     auto layout = async::loadFileString("village.json");
+ *     auto villageTexture = co_await texture;
+ *     auto villageLayout = co_await layout;
+ *     co_await async::delay(0.5f);
+ *     Director::getInstance()->replaceScene(VillageScene::create(villageTexture, villageLayout));
+ * }
+ *
+ * loadVillage().start();
+ * @endcode
+ * A coroutine is not bound to a node: if it uses a node which may be released while it is suspended, the node should be retained.
+ * @js NA
+ */
+template <typename T = void>
+class Task
+{
+public:
+    typedef coroutine_detail::TaskPromise<T> promise_type;
+
+    Task(Task&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (_handle)
+                _handle.destroy();
+            _handle = std::exchange(other._handle, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    /** Destroys the coroutine if it was not started, or if it is done. */
+    ~Task()
+    {
+        if (_handle)
+            _handle.destroy();
+    }
+
+    /** Starts the task without awaiting it, the coroutine is destroyed once it returns. */
+    void start()
+    {
+        auto handle = std::exchange(_handle, nullptr);
+        if (handle)
+        {
+            handle.promise().detached = true;
+            handle.resume();
+        }
+    }
+
+    bool await_ready() const noexcept { return !_handle || _handle.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+    {
+        _handle.promise().continuation = continuation;
+        return _handle;
+    }
+
+    T await_resume() { return _handle.promise().result(); }
+
+private:
+    friend struct coroutine_detail::TaskPromise<T>;
+    explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+namespace coroutine_detail
+{
+    template <typename T>
+    inline Task<T> TaskPromise<T>::get_return_object()
+    {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object()
+    {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+
+    // completes async::nextFrame() from the function queue of the next Scheduler::update()
+    struct NextFrame
+    {
+        AsyncOperation<void> operation;
+        unsigned int updateCount;
+
+        void operator()() const
+        {
+            // queued by a scheduled callback, the queue runs at the end of the same update()
+            auto scheduler = Director::getInstance()->getScheduler();
+            if (scheduler->getUpdateCount() == updateCount)
+                scheduler->performFunctionInCocosThread(*this);
+            else
+                operation.completeInCocosThread();
+        }
+    };
+}
+
+/**
+ * Awaitable versions of the asynchronous engine APIs.
+ */
+namespace async
+{
+    /** Loads a texture with TextureCache::addImageAsync(), the result is null if it can't be loaded. */
+    inline AsyncOperation<Texture2D*> loadTexture(const std::string& path)
+    {
+        AsyncOperation<Texture2D*> operation;
+        Director::getInstance()->getTextureCache()->addImageAsync(path, [operation](Texture2D* texture) {
+            operation.complete(texture);
+        });
+        return operation;
+    }
+
+    /** Reads a file with FileUtils::getDataFromFile(). */
+    inline AsyncOperation<Data> loadFileData(const std::string& path)
+    {
+        AsyncOperation<Data> operation;
+        FileUtils::getInstance()->getDataFromFile(path, [operation](Data data) {
+            operation.complete(std::move(data));
+        });
+        return operation;
+    }
+
+    /** Reads a file with FileUtils::getStringFromFile(). */
+    inline AsyncOperation<std::string> loadFileString(const std::string& path)
+    {
+        AsyncOperation<std::string> operation;
+        FileUtils::getInstance()->getStringFromFile(path, [operation](std::string content) {
+            operation.complete(std::move(content));
+        });
+        return operation;
+    }
+
+    /** Runs a function in the JobSystem of the AsyncTaskPool, the result is its return value. */
+    template <typename F>
+    inline auto runInBackground(F function, JobSystem::Priority priority = JobSystem::Priority::NORMAL)
+        -> AsyncOperation<typename std::invoke_result<F>::type>
+    {
+        typedef typename std::invoke_result<F>::type Result;
+        AsyncOperation<Result> operation;
+        AsyncTaskPool::getInstance()->getJobSystem()->schedule([operation, function = std::move(function)]() mutable {
+            if constexpr (std::is_void<Result>::value)
+            {
+                function();
+                operation.complete();
+            }
+            else
+            {
+                operation.complete(function());
+            }
+        }, priority);
+        return operation;
+    }
+
+    /** Completes after the given time of the scheduler, so it follows its time scale.
+     * The delay waits in the timer wheel of the scheduler, it costs nothing per frame until it expires.
+     */
+    inline AsyncOperation<void> delay(float seconds)
+    {
+        // all delays share a target, each has its own key
+        static int s_delayTarget = 0;
+        static unsigned int s_delayCount = 0;
+
+        AsyncOperation<void> operation;
+        Director::getInstance()->getScheduler()->schedule([operation](float) {
+            operation.complete();
+        }, &s_delayTarget, 0, 0, seconds, false, "cocos2d::async::delay" + std::to_string(s_delayCount++));
+        return operation;
+    }
+
+    /** Completes in the next frame, the awaiting coroutine is resumed at the end of the next Scheduler::update(),
+     * whether it is awaited from a scheduled callback, from a coroutine resumed by the scheduler or between two frames.
+     */
+    inline AsyncOperation<void> nextFrame()
+    {
+        AsyncOperation<void> operation;
+        auto scheduler = Director::getInstance()->getScheduler();
+        scheduler->performFunctionInCocosThread(coroutine_detail::NextFrame{operation, scheduler->getUpdateCount()});
+        return operation;
+    }
+}
+
+NS_CC_END
+// end group
+/// @}
+
+#endif // CC_COROUTINES_SUPPORTED
@@ -46,6 +46,8 @@ THE SOFTWARE.
 #include "renderer/CCRenderer.h"
 #include "renderer/CCRenderState.h"
 #include "2d/CCCamera.h"
+#include "2d/CCParallelVisitor.h"
+#include "2d/CCActionPool.h"
 #include "base/CCUserDefault.h"
 #include "base/ccUtils.h"
 #include "base/ccFPSImages.h"
@@ -77,6 +79,19 @@ THE SOFTWARE.
 using namespace std;
 
 NS_CC_BEGIN
+
+namespace {
+    // Matrix stacks of a thread visiting nodes in parallel, @see Director::beginThreadMatrixStacks()
+    struct ThreadMatrixStacks
+    {
+        std::stack<Mat4> modelView;
+        std::stack<Mat4> projection;
+        std::stack<Mat4> texture;
+        bool enabled = false;
+    };
+    thread_local ThreadMatrixStacks t_threadMatrixStacks;
+}
+
 // FIXME: it should be a Director ivar. Move it there once support for multiple directors is added
 
 // singleton stuff
@@ -352,6 +367,11 @@ void Director::calculateDeltaTime()
             _lastUpdate = now;
         }
         _deltaTime = MAX(0, _deltaTime);
+
+        if (_deltaTimeSmoothing && !_deltaTimePassedByCaller)
+        {
+            smoothDeltaTime();
+        }
     }
 
 #if COCOS2D_DEBUG
@@ -434,6 +454,83 @@ void Director::setNextDeltaTimeZero(bool nextDeltaTimeZero)
     _nextDeltaTimeZero = nextDeltaTimeZero;
 }
 
+void Director::setDeltaTimeSmoothingEnabled(bool enabled)
+{
+    _deltaTimeSmoothing = enabled;
+    _deltaTimeHistoryCount = 0;
+    _deltaTimeHistoryIndex = 0;
+}
+
+void Director::smoothDeltaTime()
+{
+    // a hitch is given as is, averaging it would slow down the following frames
+    float interval = _adaptiveFrameRateIdle ? _idleAnimationInterval : _animationInterval;
+    if (_deltaTime > interval * DELTA_TIME_HISTORY_SIZE)
+    {
+        _deltaTimeHistoryCount = 0;
+        _deltaTimeHistoryIndex = 0;
+        return;
+    }
+
+    _deltaTimeHistory[_deltaTimeHistoryIndex] = _deltaTime;
+    _deltaTimeHistoryIndex = (_deltaTimeHistoryIndex + 1) % DELTA_TIME_HISTORY_SIZE;
+    _deltaTimeHistoryCount = MIN(_deltaTimeHistoryCount + 1, DELTA_TIME_HISTORY_SIZE);
+
+    float sum = 0;
+    for (int i = 0; i < _deltaTimeHistoryCount; ++i)
+    {
+        sum += _deltaTimeHistory[i];
+    }
+    _deltaTime = sum / _deltaTimeHistoryCount;
+}
+
+void Director::setAdaptiveFrameRate(bool enabled, float idleInterval, float idleDelay)
+{
+    _adaptiveFrameRate = enabled;
+    _idleAnimationInterval = idleInterval;
+    _idleDelay = idleDelay;
+    notifyActivity();
+
+    if (!enabled && _adaptiveFrameRateIdle)
+    {
+        _adaptiveFrameRateIdle = false;
+        if (!_invalid && !_paused)
+        {
+            Application::getInstance()->setAnimationInterval(_animationInterval);
+        }
+    }
+}
+
+void Director::notifyActivity()
+{
+    if (!_adaptiveFrameRate)
+        return;
+
+    _lastActivity = std::chrono::steady_clock::now();
+    if (_adaptiveFrameRateIdle)
+    {
+        _adaptiveFrameRateIdle = false;
+        if (!_invalid && !_paused)
+        {
+            Application::getInstance()->setAnimationInterval(_animationInterval);
+        }
+    }
+}
+
+void Director::updateAdaptiveFrameRate()
+{
+    // the director has its own interval while paused
+    if (_adaptiveFrameRateIdle || _paused || _idleAnimationInterval <= _animationInterval)
+        return;
+
+    float idleTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _lastActivity).count() / 1000000.0f;
+    if (idleTime >= _idleDelay)
+    {
+        _adaptiveFrameRateIdle = true;
+        Application::getInstance()->setAnimationInterval(_idleAnimationInterval);
+    }
+}
+
 //
 // FIXME TODO
 // Matrix code MUST NOT be part of the Director
@@ -467,124 +564,95 @@ void Director::resetMatrixStack()
     initMatrixStack();
 }
 
-void Director::popMatrix(MATRIX_STACK_TYPE type)
+std::stack<Mat4>* Director::getMatrixStack(MATRIX_STACK_TYPE type) const
 {
+    // threads visiting nodes in parallel have their own stacks
+    auto& threadStacks = t_threadMatrixStacks;
+    auto self = const_cast<Director*>(this);
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.pop();
+        return threadStacks.enabled ? &threadStacks.modelView : &self->_modelViewMatrixStack;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
-        _projectionMatrixStack.pop();
+        return threadStacks.enabled ? &threadStacks.projection : &self->_projectionMatrixStack;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
     {
-        _textureMatrixStack.pop();
-    }
-    else
-    {
-        CCASSERT(false, "unknown matrix stack type");
+        return threadStacks.enabled ? &threadStacks.texture : &self->_textureMatrixStack;
     }
+    return nullptr;
 }
 
-void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
+void Director::beginThreadMatrixStacks(const Mat4& modelView, const Mat4& projection, const Mat4& texture)
 {
-    if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
-    {
-        _modelViewMatrixStack.top() = Mat4::IDENTITY;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
-    {
-        _projectionMatrixStack.top() = Mat4::IDENTITY;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
-    {
-        _textureMatrixStack.top() = Mat4::IDENTITY;
-    }
-    else
-    {
-        CCASSERT(false, "unknown matrix stack type");
-    }
+    auto& stacks = t_threadMatrixStacks;
+    CCASSERT(!stacks.enabled, "the thread matrix stacks are already in use");
+    stacks.modelView.push(modelView);
+    stacks.projection.push(projection);
+    stacks.texture.push(texture);
+    stacks.enabled = true;
+}
+
+void Director::endThreadMatrixStacks()
+{
+    auto& stacks = t_threadMatrixStacks;
+    CCASSERT(stacks.enabled && stacks.modelView.size() == 1 && stacks.projection.size() == 1 && stacks.texture.size() == 1,
+             "unbalanced matrix stack push and pop");
+    stacks.modelView.pop();
+    stacks.projection.pop();
+    stacks.texture.pop();
+    stacks.enabled = false;
 }
 
+void Director::popMatrix(MATRIX_STACK_TYPE type)
+{
+    auto stack = getMatrixStack(type);
+    CCASSERT(stack, "unknown matrix stack type");
+    if (stack)
+        stack->pop();
+}
+
+void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
+{
+    auto stack = getMatrixStack(type);
+    CCASSERT(stack, "unknown matrix stack type");
+    if (stack)
+        stack->top() = Mat4::IDENTITY;
+}
 
 void Director::loadMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
-    if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
-    {
-        _modelViewMatrixStack.top() = mat;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
-    {
-        _projectionMatrixStack.top() = mat;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
-    {
-        _textureMatrixStack.top() = mat;
-    }
-    else
-    {
-        CCASSERT(false, "unknown matrix stack type");
-    }
+    auto stack = getMatrixStack(type);
+    CCASSERT(stack, "unknown matrix stack type");
+    if (stack)
+        stack->top() = mat;
 }
 
 void Director::multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
-    if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
-    {
-        _modelViewMatrixStack.top() *= mat;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
-    {
-        _projectionMatrixStack.top() *= mat;
-    }
-    else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
-    {
-        _textureMatrixStack.top() *= mat;
-    }
-    else
-    {
-        CCASSERT(false, "unknown matrix stack type");
-    }
+    auto stack = getMatrixStack(type);
+    CCASSERT(stack, "unknown matrix stack type");
+    if (stack)
+        stack->top() *= mat;
 }
 
 void Director::pushMatrix(MATRIX_STACK_TYPE type)
 {
-    if(type == MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)
-    {
-        _modelViewMatrixStack.push(_modelViewMatrixStack.top());
-    }
-    else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION)
-    {
-        _projectionMatrixStack.push(_projectionMatrixStack.top());
-    }
-    else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE)
-    {
-        _textureMatrixStack.push(_textureMatrixStack.top());
-    }
-    else
-    {
-        CCASSERT(false, "unknown matrix stack type");
-    }
+    auto stack = getMatrixStack(type);
+    CCASSERT(stack, "unknown matrix stack type");
+    if (stack)
+        stack->push(stack->top());
 }
 
 const Mat4& Director::getMatrix(MATRIX_STACK_TYPE type) const
 {
-    if(type == MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)
-    {
-        return _modelViewMatrixStack.top();
-    }
-    else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION)
-    {
-        return _projectionMatrixStack.top();
-    }
-    else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE)
-    {
-        return _textureMatrixStack.top();
-    }
+    auto stack = getMatrixStack(type);
+    if (stack)
+        return stack->top();
 
     CCASSERT(false, "unknown matrix stack type, will return modelview matrix instead");
-    return  _modelViewMatrixStack.top();
+    return getMatrixStack(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)->top();
 }
 
 void Director::setProjection(Projection projection)
@@ -647,6 +715,7 @@ void Director::purgeCachedData()
 {
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
+    ActionPool::getInstance()->removeUnusedActions();
 
     if (s_SharedDirector->getOpenGLView())
     {
@@ -1020,6 +1089,8 @@ void Director::reset()
     SpriteFrameCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
+    ParallelVisitor::destroyInstance();
+    ActionPool::destroyInstance();
     backend::ProgramCache::destroyInstance();
     
     
@@ -1371,6 +1442,10 @@ void Director::startAnimation(SetIntervalReason reason)
 
     Application::getInstance()->setAnimationInterval(_animationInterval);
 
+    // the interval set by the game is used until the next idle period
+    _adaptiveFrameRateIdle = false;
+    _lastActivity = _lastUpdate;
+
     // fix issue #3509, skip one fps to avoid incorrect time calculation.
     setNextDeltaTimeZero(true);
 }
@@ -1389,6 +1464,11 @@ void Director::mainLoop()
     }
     else if (! _invalid)
     {
+        if (_adaptiveFrameRate)
+        {
+            updateAdaptiveFrameRate();
+        }
+
         drawScene();
      
         // release the objects
@@ -191,6 +191,34 @@ public:
      */
     void setNextDeltaTimeZero(bool nextDeltaTimeZero);
 
+    /**
+     * Sets whether the delta time is averaged over the last frames, false by default.
+     * It evens out the jitter of the measured frame times. A frame longer than 4 animation intervals is not averaged.
+     * It has no effect when the delta time is passed to mainLoop(float).
+     */
+    void setDeltaTimeSmoothingEnabled(bool enabled);
+    /** Whether or not the delta time is averaged over the last frames. */
+    bool isDeltaTimeSmoothingEnabled() const { return _deltaTimeSmoothing; }
+
+    /**
+     * Sets the adaptive frame rate, disabled by default.
+     * When it is enabled, the frame rate drops to 1/idleInterval after idleDelay seconds without input events
+     * nor call to notifyActivity(), and gets back to 1/getAnimationInterval() on the next one.
+     * The animation interval set by the game is kept.
+     *
+     * @param enabled Whether or not the adaptive frame rate is enabled.
+     * @param idleInterval The animation interval when idle, in seconds.
+     * @param idleDelay The time without activity after which the director is idle, in seconds.
+     */
+    void setAdaptiveFrameRate(bool enabled, float idleInterval = 1.0f / 30, float idleDelay = 3.0f);
+    /** Whether or not the adaptive frame rate is enabled. */
+    bool isAdaptiveFrameRateEnabled() const { return _adaptiveFrameRate; }
+    /**
+     * Keeps the full frame rate when the adaptive frame rate is enabled.
+     * Touch, mouse, keyboard and controller events invoke it, the game should invoke it e.g. in every frame of a battle.
+     */
+    void notifyActivity();
+
     /** Whether or not the Director is paused. */
     bool isPaused() { return _paused; }
 
@@ -496,6 +524,34 @@ public:
      */
     void resetMatrixStack();
 
+    /**
+     * Sets whether every node keeps its model view transform on the top of the MODELVIEW matrix stack while it is visited.
+     * Enable it for code relying on the deprecated matrix stack during the visit of any node. If it is disabled,
+     * the stack is only updated for the nodes requiring it, @see Node::setMatrixStackRequired(). False by default.
+     * @js NA
+     */
+    void setMatrixStackCompatibilityEnabled(bool enabled) { _matrixStackCompatibilityEnabled = enabled; }
+
+    /**
+     * Gets whether every node keeps its model view transform on the MODELVIEW matrix stack while it is visited.
+     * @js NA
+     */
+    bool isMatrixStackCompatibilityEnabled() const { return _matrixStackCompatibilityEnabled; }
+
+    /**
+     * Make the calling thread use its own matrix stacks, starting with the given matrices.
+     * Used by the threads visiting nodes in parallel, so that the matrix stack functions work on them.
+     * @see ParallelVisitor
+     * @js NA
+     */
+    void beginThreadMatrixStacks(const Mat4& modelView, const Mat4& projection, const Mat4& texture);
+
+    /**
+     * Make the calling thread use the matrix stacks of the director again.
+     * @js NA
+     */
+    void endThreadMatrixStacks();
+
     /**
      * returns the cocos2d thread id.
      Useful to know if certain code is already running on the cocos2d thread
@@ -532,16 +588,20 @@ protected:
     
     /** calculates delta time since last time it was called */    
     void calculateDeltaTime();
+    void smoothDeltaTime();
+    void updateAdaptiveFrameRate();
 
     //textureCache creation or release
     void initTextureCache();
     void destroyTextureCache();
 
     void initMatrixStack();
+    std::stack<Mat4>* getMatrixStack(MATRIX_STACK_TYPE type) const;
 
     std::stack<Mat4> _modelViewMatrixStack;
     std::stack<Mat4> _textureMatrixStack;
     std::stack<Mat4> _projectionMatrixStack;
+    bool _matrixStackCompatibilityEnabled = false;
 
     /** Scheduler associated with this director
      @since v2.0
@@ -570,6 +630,20 @@ protected:
     /* delta time since last tick to main loop */
 	float _deltaTime = 0.0f;
     bool _deltaTimePassedByCaller = false;
+
+    /* last delta times, averaged when smoothing is enabled */
+    static const int DELTA_TIME_HISTORY_SIZE = 4;
+    float _deltaTimeHistory[DELTA_TIME_HISTORY_SIZE];
+    int _deltaTimeHistoryCount = 0;
+    int _deltaTimeHistoryIndex = 0;
+    bool _deltaTimeSmoothing = false;
+
+    /* adaptive frame rate */
+    bool _adaptiveFrameRate = false;
+    bool _adaptiveFrameRateIdle = false;
+    float _idleAnimationInterval = 1.0f / 30;
+    float _idleDelay = 3.0f;
+    std::chrono::steady_clock::time_point _lastActivity;
     
     /* The _openGLView, where everything is rendered, GLView is a abstract class,cocos2d-x provide GLViewImpl
      which inherit from it as default renderer context,you can have your own by inherit from it*/
@@ -202,7 +202,6 @@ void EventDispatcher::EventListenerVector::clear()
 EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
-, _nodePriorityIndex(0)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -222,73 +221,57 @@ EventDispatcher::~EventDispatcher()
     removeAllEventListeners();
 }
 
-void EventDispatcher::visitTarget(Node* node, bool isRootNode)
+const EventDispatcher::NodePriority& EventDispatcher::getNodePriority(Node* node, Node* rootNode)
 {
-    node->sortAllChildren();
-    
-    int i = 0;
-    auto& children = node->getChildren();
-    
-    auto childrenCount = children.size();
-    
-    if(childrenCount > 0)
+    auto iter = _nodePriorityMap.find(node);
+    if (iter != _nodePriorityMap.end())
+        return iter->second;
+
+    NodePriority& priority = _nodePriorityMap[node];
+    priority.globalZOrder = node->getGlobalZOrder();
+
+    // the siblings are visited in the order of Node::sortNodes()
+    Node* current = node;
+    while (current != rootNode)
     {
-        Node* child = nullptr;
-        // visit children zOrder < 0
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            
-            if ( child && child->getLocalZOrder() < 0 )
-                visitTarget(child, false);
-            else
-                break;
-        }
-        
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
+        Node* parent = current->getParent();
+        if (parent == nullptr)
         {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-        
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            if (child)
-                visitTarget(child, false);
+            priority.path.clear();
+            return priority;
         }
+
+        priority.path.push_back((std::int64_t)current->_localZOrder * 0x100000000LL + current->_orderOfArrival);
+        current = parent;
     }
-    else
+
+    std::reverse(priority.path.begin(), priority.path.end());
+    priority.inScene = true;
+    return priority;
+}
+
+bool EventDispatcher::isVisitedBefore(const NodePriority& p1, const NodePriority& p2)
+{
+    // nodes outside of the scene are not visited, they have the lowest priority
+    if (!p1.inScene || !p2.inScene)
+        return !p1.inScene && p2.inScene;
+
+    if (p1.globalZOrder != p2.globalZOrder)
+        return p1.globalZOrder < p2.globalZOrder;
+
+    size_t depth = std::min(p1.path.size(), p2.path.size());
+    for (size_t i = 0; i < depth; ++i)
     {
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-    }
-    
-    if (isRootNode)
-    {
-        std::vector<float> globalZOrders;
-        globalZOrders.reserve(_globalZOrderNodeMap.size());
-        
-        for (const auto& e : _globalZOrderNodeMap)
-        {
-            globalZOrders.push_back(e.first);
-        }
-        
-        std::stable_sort(globalZOrders.begin(), globalZOrders.end(), [](const float a, const float b){
-            return a < b;
-        });
-        
-        for (const auto& globalZ : globalZOrders)
-        {
-            for (const auto& n : _globalZOrderNodeMap[globalZ])
-            {
-                _nodePriorityMap[n] = ++_nodePriorityIndex;
-            }
-        }
-        
-        _globalZOrderNodeMap.clear();
+        if (p1.path[i] != p2.path[i])
+            return p1.path[i] < p2.path[i];
     }
+
+    // an ancestor is visited after its children of negative local Z order, and before the others
+    if (p1.path.size() < p2.path.size())
+        return p2.path[depth] >= 0;
+    if (p2.path.size() < p1.path.size())
+        return p1.path[depth] < 0;
+    return false;
 }
 
 void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/* = false */)
@@ -418,6 +401,18 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     }
     
     listeners->push_back(listener);
+
+    if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+    {
+        // remember the membership, the culling flag may be changed before the listener is removed
+        auto touchListener = static_cast<EventListenerTouchOneByOne*>(listener);
+        if (touchListener->_touchBoundsCulling)
+        {
+            _touchSpatialIndex.addNode(node);
+            touchListener->_touchBoundsIndexed = true;
+            node->_touchBoundsIndexed = true;
+        }
+    }
 }
 
 void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener* listener)
@@ -431,11 +426,23 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         if (iter != listeners->end())
         {
             listeners->erase(iter);
+
+            if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE
+                && static_cast<EventListenerTouchOneByOne*>(listener)->_touchBoundsIndexed)
+            {
+                static_cast<EventListenerTouchOneByOne*>(listener)->_touchBoundsIndexed = false;
+                if (_touchSpatialIndex.removeNode(node))
+                {
+                    node->_touchBoundsIndexed = false;
+                    node->_touchBoundsDirty = false;
+                }
+            }
         }
         
         if (listeners->empty())
         {
             _nodeListenersMap.erase(found);
+            _nodePriorityMap.erase(node);
             delete listeners;
         }
     }
@@ -902,6 +909,19 @@ void EventDispatcher::dispatchEvent(Event* event)
 {
     if (!_isEnabled)
         return;
+
+    // input events keep the full frame rate, @see Director::setAdaptiveFrameRate()
+    switch (event->getType())
+    {
+        case Event::Type::TOUCH:
+        case Event::Type::KEYBOARD:
+        case Event::Type::MOUSE:
+        case Event::Type::GAME_CONTROLLER:
+            Director::getInstance()->notifyActivity();
+            break;
+        default:
+            break;
+    }
     
     updateDirtyFlagForSceneGraph();
     
@@ -976,10 +996,19 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
     {
         auto mutableTouchesIter = mutableTouches.begin();
         
+        std::vector<Node*> touchCandidates;
+
         for (auto& touches : originalTouches)
         {
             bool isSwallowed = false;
 
+            // nodes under the touch, for the listeners with touch bounds culling
+            bool cullTouch = event->getEventCode() == EventTouch::EventCode::BEGAN && !_touchSpatialIndex.empty();
+            if (cullTouch)
+            {
+                _touchSpatialIndex.query(touches->getLocation(), touchCandidates);
+            }
+
             auto onTouchEvent = [&](EventListener* l) -> bool { // Return true to break
                 EventListenerTouchOneByOne* listener = static_cast<EventListenerTouchOneByOne*>(l);
                 
@@ -996,6 +1025,13 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 
                 if (eventCode == EventTouch::EventCode::BEGAN)
                 {
+                    // the bounds are in world space, which is the space of the touches only for the default camera
+                    if (cullTouch && listener->_touchBoundsIndexed && Camera::getVisitingCamera() == Camera::getDefaultCamera()
+                        && !std::binary_search(touchCandidates.begin(), touchCandidates.end(), listener->_node))
+                    {
+                        return false;
+                    }
+
                     if (listener->onTouchBegan)
                     {
                         isClaimed = listener->onTouchBegan(touches, event);
@@ -1322,22 +1358,23 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
-
-    visitTarget(rootNode, true);
+    // The priorities of the nodes which were not made dirty since the last sort are reused
+    for (auto& l : *sceneGraphListeners)
+    {
+        getNodePriority(l->getAssociatedNode(), rootNode);
+    }
     
     // After sort: priority < 0, > 0
     std::stable_sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
+        return isVisitedBefore(_nodePriorityMap[l2->getAssociatedNode()], _nodePriorityMap[l1->getAssociatedNode()]);
     });
     
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
     for (auto& l : *sceneGraphListeners)
     {
-        log("listener priority: node ([%s]%p), priority (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node]);
+        const auto& priority = _nodePriorityMap[l->_node];
+        log("listener priority: node ([%s]%p), global Z (%f), depth (%d)", typeid(*l->_node).name(), l->_node, priority.globalZOrder, (int)priority.path.size());
     }
 #endif
 }
@@ -1534,6 +1571,7 @@ void EventDispatcher::setDirtyForNode(Node* node)
     {
         _dirtyNodes.insert(node);
     }
+    _nodePriorityMap.erase(node);
 
     // Also set the dirty flag for node's children
     const auto& children = node->getChildren();
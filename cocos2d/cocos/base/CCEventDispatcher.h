@@ -26,6 +26,7 @@
 #ifndef __CC_EVENT_DISPATCHER_H__
 #define __CC_EVENT_DISPATCHER_H__
 
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <unordered_map>
@@ -35,6 +36,7 @@
 #include "platform/CCPlatformMacros.h"
 #include "base/CCEventListener.h"
 #include "base/CCEvent.h"
+#include "base/CCTouchSpatialIndex.h"
 #include "platform/CCStdC.h"
 
 /**
@@ -309,8 +311,23 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
-    void visitTarget(Node* node, bool isRootNode);
+    /**
+     * Dispatching order of a node associated with scene graph priority listeners: nodes are ordered by global Z order,
+     * then in the order the scene graph is visited.
+     */
+    struct NodePriority
+    {
+        bool inScene = false;
+        float globalZOrder = 0;
+        /** Local Z order and order of arrival of the ancestors of the node below the scene, and of the node */
+        std::vector<std::int64_t> path;
+    };
+
+    /** Gets the cached priority of a node, it is computed from its ancestors if the node is dirty, without visiting the scene graph. */
+    const NodePriority& getNodePriority(Node* node, Node* rootNode);
+
+    /** Whether the first node is visited before the second one, so that it has a lower priority. */
+    static bool isVisitedBefore(const NodePriority& p1, const NodePriority& p2);
 
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
@@ -324,11 +341,11 @@ protected:
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
     
-    /** The map of node and its event priority */
-    std::unordered_map<Node*, int> _nodePriorityMap;
-    
-    /** key: Global Z Order, value: Sorted Nodes */
-    std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
+    /** The map of node and its event priority, a node is removed when it is dirty */
+    std::unordered_map<Node*, NodePriority> _nodePriorityMap;
+
+    /** Bounds of the nodes of the one by one touch listeners with touch bounds culling */
+    TouchSpatialIndex _touchSpatialIndex;
     
     /** The listeners to be added after dispatching event */
     std::vector<EventListener*> _toAddedListeners;
@@ -345,8 +362,6 @@ protected:
     /** Whether to enable dispatching event */
     bool _isEnabled;
     
-    int _nodePriorityIndex;
-    
     std::set<std::string> _internalCustomListenerIDs;
 };
 
@@ -40,6 +40,8 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _touchBoundsCulling(false)
+, _touchBoundsIndexed(false)
 {
 }
 
@@ -68,6 +70,16 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setTouchBoundsCulling(bool enabled)
+{
+    _touchBoundsCulling = enabled;
+}
+
+bool EventListenerTouchOneByOne::isTouchBoundsCulling() const
+{
+    return _touchBoundsCulling;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new (std::nothrow) EventListenerTouchOneByOne();
@@ -109,6 +121,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
         
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_touchBoundsCulling = _touchBoundsCulling;
     }
     else
     {
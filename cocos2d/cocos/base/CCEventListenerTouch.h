@@ -68,6 +68,20 @@ public:
      * @return True if needs to swall touches.
      */
     bool isSwallowTouches();
+
+    /**
+     * Sets whether the listener only claims touches inside the bounding box of its node, false by default.
+     * The bounding box is the content size of the node transformed to world space. When it is enabled,
+     * the dispatcher finds the nodes under a touch with a spatial index, and onTouchBegan is not invoked
+     * for a touch outside of the bounding box, if the node is visited by the default camera.
+     * It must be set before the listener is added to the dispatcher with scene graph priority,
+     * changing it later takes effect when the listener is added again.
+     *
+     * @param enabled True if touches outside of the bounding box of the node can be skipped.
+     */
+    void setTouchBoundsCulling(bool enabled);
+    /** Whether touches outside the bounding box of the node are skipped. */
+    bool isTouchBoundsCulling() const;
     
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
@@ -91,6 +105,8 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _touchBoundsCulling;
+    bool _touchBoundsIndexed;
     
     friend class EventDispatcher;
 };
@@ -0,0 +1,190 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCFunctionQueue.h"
+
+#include <chrono>
+
+NS_CC_BEGIN
+
+namespace
+{
+    // Nodes freed by the consumers, producers take the whole list at once so that popping is free from ABA issues
+    std::atomic<void*> s_freeNodes(nullptr);
+
+    // Nodes taken from s_freeNodes by the current thread
+    struct NodeCache
+    {
+        void* nodes = nullptr;
+        void (*release)(void* nodes) = nullptr;
+
+        ~NodeCache()
+        {
+            if (release)
+                release(nodes);
+        }
+    };
+    thread_local NodeCache t_nodeCache;
+}
+
+FunctionQueue::Node* FunctionQueue::allocateNode()
+{
+    auto& cache = t_nodeCache;
+    if (cache.nodes == nullptr)
+    {
+        cache.nodes = s_freeNodes.exchange(nullptr, std::memory_order_acquire);
+        cache.release = [](void* nodes) {
+            for (Node* node = static_cast<Node*>(nodes); node != nullptr; )
+            {
+                Node* next = node->nextFree;
+                delete node;
+                node = next;
+            }
+        };
+    }
+
+    Node* node = static_cast<Node*>(cache.nodes);
+    if (node)
+        cache.nodes = node->nextFree;
+    else
+        node = new Node();
+    return node;
+}
+
+void FunctionQueue::freeNode(Node* node)
+{
+    void* head = s_freeNodes.load(std::memory_order_relaxed);
+    do
+    {
+        node->nextFree = static_cast<Node*>(head);
+    } while (!s_freeNodes.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+}
+
+FunctionQueue::FunctionQueue()
+: _head(&_stub)
+, _tail(&_stub)
+, _deferred(nullptr)
+, _nextSequence(0)
+, _discardBefore(0)
+{
+    _stub.next.store(nullptr, std::memory_order_relaxed);
+}
+
+FunctionQueue::~FunctionQueue()
+{
+    clear();
+    run();
+}
+
+void FunctionQueue::enqueue(Node* node)
+{
+    node->sequence = _nextSequence.fetch_add(1, std::memory_order_relaxed);
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = _head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+FunctionQueue::Node* FunctionQueue::dequeue()
+{
+    Node* tail = _tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &_stub)
+    {
+        if (next == nullptr)
+            return nullptr;
+        _tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next)
+    {
+        _tail = next;
+        return tail;
+    }
+
+    // a producer is between the exchange and the link, its node is taken next time
+    if (tail != _head.load(std::memory_order_acquire))
+        return nullptr;
+
+    // tail is the last node, the stub is queued behind it so that it can be unlinked
+    _stub.next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = _head.exchange(&_stub, std::memory_order_acq_rel);
+    previous->next.store(&_stub, std::memory_order_release);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next)
+    {
+        _tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+size_t FunctionQueue::run(float timeBudget)
+{
+    typedef std::chrono::steady_clock Clock;
+    auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(timeBudget));
+    uint64_t end = _nextSequence.load(std::memory_order_acquire);
+    size_t count = 0;
+
+    while (true)
+    {
+        Node* node = _deferred ? _deferred : dequeue();
+        _deferred = nullptr;
+        if (node == nullptr)
+            break;
+
+        if (node->sequence >= end)
+        {
+            _deferred = node;
+            break;
+        }
+
+        if (node->sequence >= _discardBefore.load(std::memory_order_relaxed))
+        {
+            node->invoke(&node->storage);
+            ++count;
+        }
+        node->destroy(&node->storage);
+        freeNode(node);
+
+        // reading the clock every few functions is enough, most of them are short
+        if (timeBudget > 0 && (count & 7) == 0 && Clock::now() >= deadline)
+            break;
+    }
+    return count;
+}
+
+void FunctionQueue::clear()
+{
+    _discardBefore.store(_nextSequence.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+bool FunctionQueue::empty() const
+{
+    return _deferred == nullptr && _tail == &_stub && _stub.next.load(std::memory_order_acquire) == nullptr;
+}
+
+NS_CC_END
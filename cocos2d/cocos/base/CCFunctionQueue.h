@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class FunctionQueue
+ * @brief Lock-free queue of functions pushed by any thread and run by one thread.
+ * Pushing never takes a lock: the node is linked with one atomic exchange, as in the intrusive queue of Dmitry Vyukov.
+ * The nodes are recycled through a pool, and callables of up to STORAGE_SIZE bytes are stored inside the node,
+ * so pushing a small lambda doesn't allocate once the pool is warm.
+ * @js NA
+ */
+class CC_DLL FunctionQueue
+{
+public:
+    /** Callables up to this size are stored in the nodes, bigger ones are allocated. */
+    static const size_t STORAGE_SIZE = 64;
+
+    FunctionQueue();
+    ~FunctionQueue();
+
+    /** Queues a callable taking no argument, from any thread. */
+    template <typename F>
+    void push(F&& function)
+    {
+        typedef typename std::decay<F>::type Callable;
+        Node* node = allocateNode();
+        store<Callable>(node, std::forward<F>(function),
+                        std::integral_constant<bool, sizeof(Callable) <= STORAGE_SIZE
+                                                     && std::alignment_of<Callable>::value <= std::alignment_of<Storage>::value>());
+        enqueue(node);
+    }
+
+    /**
+     * Runs the queued functions in order, must always be invoked by the same thread.
+     * The functions queued while running, by them or by other threads, are left for the next call.
+     *
+     * @param timeBudget The time in seconds after which the remaining functions are left for the next call,
+     *                   0 runs all of them.
+     * @return The number of functions run.
+     */
+    size_t run(float timeBudget = 0);
+
+    /** Discards the functions queued so far without running them, from any thread. */
+    void clear();
+
+    /** Whether there might be queued functions, it is cheap enough to be invoked before run(). */
+    bool empty() const;
+
+private:
+    typedef std::aligned_storage<STORAGE_SIZE>::type Storage;
+
+    struct Node
+    {
+        std::atomic<Node*> next;
+        Node* nextFree;
+        uint64_t sequence;
+        void (*invoke)(void* storage);
+        void (*destroy)(void* storage);
+        Storage storage;
+    };
+
+    template <typename Callable, typename F>
+    static void store(Node* node, F&& function, std::true_type /*fits*/)
+    {
+        new (&node->storage) Callable(std::forward<F>(function));
+        node->invoke = [](void* storage) { (*static_cast<Callable*>(storage))(); };
+        node->destroy = [](void* storage) { static_cast<Callable*>(storage)->~Callable(); };
+    }
+
+    template <typename Callable, typename F>
+    static void store(Node* node, F&& function, std::false_type /*fits*/)
+    {
+        *reinterpret_cast<Callable**>(&node->storage) = new Callable(std::forward<F>(function));
+        node->invoke = [](void* storage) { (**static_cast<Callable**>(storage))(); };
+        node->destroy = [](void* storage) { delete *static_cast<Callable**>(storage); };
+    }
+
+    static Node* allocateNode();
+    static void freeNode(Node* node);
+
+    void enqueue(Node* node);
+    Node* dequeue();
+
+    // producers link after _head, the consumer unlinks from _tail
+    std::atomic<Node*> _head;
+    Node* _tail;
+    Node _stub;
+    Node* _deferred;
+    std::atomic<uint64_t> _nextSequence;
+    std::atomic<uint64_t> _discardBefore;
+};
+
+NS_CC_END
+// end of base group
+/// @}
@@ -0,0 +1,269 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "base/CCJobSystem.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // worker of the current thread, to queue the jobs it schedules in its own queues
+    thread_local JobSystem* t_jobSystem = nullptr;
+    thread_local int t_workerIndex = -1;
+}
+
+Job::Job()
+: _unfinishedDependencies(0)
+, _done(false)
+, _priority((int)JobSystem::Priority::NORMAL)
+{
+}
+
+JobSystem::JobSystem(unsigned int threadCount)
+: _queuedJobs(0)
+, _stop(false)
+{
+    if (threadCount == 0)
+    {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 4 ? hardwareThreads - 1 : 3;
+    }
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        _workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+    // started once all workers exist, they steal from each other
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        _workers[i]->thread = std::thread(&JobSystem::run, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker->thread.join();
+    }
+}
+
+JobHandle JobSystem::schedule(std::function<void()> task, Priority priority)
+{
+    return scheduleAfter(std::vector<JobHandle>(), std::move(task), nullptr, priority);
+}
+
+JobHandle JobSystem::schedule(std::function<void()> task, std::function<void()> completion, Priority priority)
+{
+    return scheduleAfter(std::vector<JobHandle>(), std::move(task), std::move(completion), priority);
+}
+
+JobHandle JobSystem::scheduleAfter(const std::vector<JobHandle>& dependencies, std::function<void()> task,
+                                   std::function<void()> completion, Priority priority)
+{
+    JobHandle job(new (std::nothrow) Job());
+    job->_task = std::move(task);
+    job->_completion = std::move(completion);
+    job->_priority = (int)priority;
+
+    // one more dependency held while registering, so the job can't be queued by a dependency finishing meanwhile
+    job->_unfinishedDependencies.store((int)dependencies.size() + 1);
+    for (const auto& dependency : dependencies)
+    {
+        bool done = true;
+        if (dependency)
+        {
+            std::lock_guard<std::mutex> lock(dependency->_mutex);
+            done = dependency->isDone();
+            if (!done)
+            {
+                dependency->_continuations.push_back(job);
+            }
+        }
+        if (done)
+        {
+            --job->_unfinishedDependencies;
+        }
+    }
+
+    if (--job->_unfinishedDependencies == 0)
+    {
+        push(job);
+    }
+    return job;
+}
+
+void JobSystem::wait(const JobHandle& job)
+{
+    int index = (t_jobSystem == this) ? t_workerIndex : -1;
+    while (job && !job->isDone())
+    {
+        JobHandle other = take(index);
+        if (other)
+        {
+            execute(other);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::run(unsigned int index)
+{
+    t_jobSystem = this;
+    t_workerIndex = (int)index;
+
+    // the queued jobs are discarded once stopping
+    while (!_stop.load())
+    {
+        JobHandle job = take((int)index);
+        if (job)
+        {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepCondition.wait(lock, [this] { return _stop.load() || _queuedJobs.load() > 0; });
+    }
+}
+
+void JobSystem::push(const JobHandle& job)
+{
+    // the jobs scheduled by a worker stay in its queues, the others are shared by all workers
+    if (t_jobSystem == this)
+    {
+        Worker* worker = _workers[t_workerIndex].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->queues[job->_priority].push_back(job);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(_injectionMutex);
+        _injectionQueues[job->_priority].push_back(job);
+    }
+    ++_queuedJobs;
+
+    // a worker checks _queuedJobs with _sleepMutex locked before waiting, so it can't miss the notification
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+}
+
+JobHandle JobSystem::take(int index)
+{
+    const int workerCount = (int)_workers.size();
+    for (int priority = 0; priority < (int)Priority::COUNT; ++priority)
+    {
+        // newest job of its own queue first, it is likely still in cache
+        if (index >= 0)
+        {
+            Worker* worker = _workers[index].get();
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            auto& queue = worker->queues[priority];
+            if (!queue.empty())
+            {
+                JobHandle job = std::move(queue.back());
+                queue.pop_back();
+                --_queuedJobs;
+                return job;
+            }
+        }
+
+        // then the oldest job scheduled by other threads
+        {
+            std::lock_guard<std::mutex> lock(_injectionMutex);
+            auto& queue = _injectionQueues[priority];
+            if (!queue.empty())
+            {
+                JobHandle job = std::move(queue.front());
+                queue.pop_front();
+                --_queuedJobs;
+                return job;
+            }
+        }
+
+        // then the oldest job of another worker
+        for (int i = 1; i <= workerCount; ++i)
+        {
+            int victim = (index + i) % workerCount;
+            if (victim == index)
+                continue;
+
+            Worker* worker = _workers[victim].get();
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            auto& queue = worker->queues[priority];
+            if (!queue.empty())
+            {
+                JobHandle job = std::move(queue.front());
+                queue.pop_front();
+                --_queuedJobs;
+                return job;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(const JobHandle& job)
+{
+    if (job->_task)
+    {
+        job->_task();
+        job->_task = nullptr;
+    }
+
+    if (job->_completion)
+    {
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread(std::move(job->_completion));
+        job->_completion = nullptr;
+    }
+
+    std::vector<JobHandle> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->_mutex);
+        job->_done.store(true, std::memory_order_release);
+        continuations.swap(job->_continuations);
+    }
+
+    for (const auto& continuation : continuations)
+    {
+        if (--continuation->_unfinishedDependencies == 0)
+        {
+            push(continuation);
+        }
+    }
+}
+
+NS_CC_END
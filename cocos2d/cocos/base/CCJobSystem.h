@@ -0,0 +1,165 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+class Job;
+class JobSystem;
+
+/** Reference to a job, used to wait for it or to schedule jobs depending on it. */
+typedef std::shared_ptr<Job> JobHandle;
+
+/**
+ * @class Job
+ * @brief A task scheduled in a JobSystem.
+ * @js NA
+ */
+class CC_DLL Job
+{
+public:
+    /** Whether the task of the job has been run. */
+    bool isDone() const { return _done.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+    Job();
+
+    std::function<void()> _task;
+    std::function<void()> _completion;
+    std::vector<JobHandle> _continuations;
+    std::mutex _mutex;
+    std::atomic<int> _unfinishedDependencies;
+    std::atomic<bool> _done;
+    int _priority;
+};
+
+/**
+ * @class JobSystem
+ * @brief Pool of worker threads sharing the jobs by work stealing.
+ * Each worker has its own queues, one per priority, for the jobs it schedules itself. A worker runs the last
+ * job it queued first, then the jobs scheduled by other threads in the order they were scheduled, and when
+ * these queues are empty it steals the oldest job of another worker, higher priorities first.
+ * A job can depend on other jobs: it is queued once all of them are done.
+ * @js NA
+ */
+class CC_DLL JobSystem
+{
+public:
+    enum class Priority
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+        COUNT
+    };
+
+    /**
+     * @param threadCount The number of worker threads,
+     *                    0 uses one thread per hardware thread besides the cocos thread, and at least 3
+     *                    so that blocking tasks, such as network requests, don't hold all of them.
+     */
+    explicit JobSystem(unsigned int threadCount = 0);
+
+    /** Waits for the running jobs, the jobs not started yet are discarded. */
+    ~JobSystem();
+
+    /**
+     * Schedules a task, from any thread.
+     *
+     * @param task The function run by a worker thread.
+     * @param priority The priority of the job.
+     */
+    JobHandle schedule(std::function<void()> task, Priority priority = Priority::NORMAL);
+
+    /**
+     * Schedules a task with a completion callback, from any thread.
+     *
+     * @param task The function run by a worker thread.
+     * @param completion The function run in the cocos thread once the task is done.
+     * @param priority The priority of the job.
+     */
+    JobHandle schedule(std::function<void()> task, std::function<void()> completion, Priority priority = Priority::NORMAL);
+
+    /**
+     * Schedules a task which starts once the given jobs are done, from any thread.
+     *
+     * @param dependencies The jobs to wait for, null handles are ignored.
+     * @param task The function run by a worker thread.
+     * @param completion The function run in the cocos thread once the task is done, may be null.
+     * @param priority The priority of the job.
+     */
+    JobHandle scheduleAfter(const std::vector<JobHandle>& dependencies, std::function<void()> task,
+                            std::function<void()> completion = nullptr, Priority priority = Priority::NORMAL);
+
+    /**
+     * Blocks until the job is done. The calling thread runs the queued jobs meanwhile.
+     * Completion callbacks are not run, so the cocos thread must not wait for a job scheduled by a completion callback.
+     */
+    void wait(const JobHandle& job);
+
+    /** Returns the number of worker threads. */
+    unsigned int getThreadCount() const { return (unsigned int)_workers.size(); }
+
+protected:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<JobHandle> queues[(int)Priority::COUNT];
+        std::thread thread;
+    };
+
+    void run(unsigned int index);
+    void push(const JobHandle& job);
+    JobHandle take(int index);
+    void execute(const JobHandle& job);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    // jobs scheduled by threads which are not workers, run in FIFO order
+    std::mutex _injectionMutex;
+    std::deque<JobHandle> _injectionQueues[(int)Priority::COUNT];
+    std::atomic<int> _queuedJobs;
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::atomic<bool> _stop;
+};
+
+NS_CC_END
+// end group
+/// @}
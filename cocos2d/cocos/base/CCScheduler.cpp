@@ -64,6 +64,7 @@ typedef struct _hashSelectorEntry
     void                *target;
     int                 timerIndex;
     Timer               *currentTimer;
+    int                 loopTimers;     // timers updated every frame, the others are in the timer wheel
     bool                paused;
     UT_hash_handle      hh;
 } tHashTimerEntry;
@@ -80,7 +81,12 @@ Timer::Timer()
 , _delay(0.0f)
 , _interval(0.0f)
 , _aborted(false)
+, _wheelState(WheelState::LOOP)
+, _wheelTime(0)
+, _wheelPausedTime(0)
+, _wheelElement(nullptr)
 {
+    _wheelEntry.userData = this;
 }
 
 void Timer::setupTimerWithInterval(float seconds, unsigned int repeat, float delay)
@@ -151,6 +157,11 @@ bool Timer::isExhausted() const
     return !_runForever && _timesExecuted > _repeat;
 }
 
+bool Timer::isWaiting() const
+{
+    return _interval > 0 || (_useDelay && _delay > 0);
+}
+
 // TimerTargetSelector
 
 TimerTargetSelector::TimerTargetSelector()
@@ -260,12 +271,13 @@ Scheduler::Scheduler()
 , _currentTarget(nullptr)
 , _currentTargetSalvaged(false)
 , _updateHashLocked(false)
+, _updateCount(0)
+, _timerTime(0)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _performFunctionTimeBudget(0)
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
 }
 
 Scheduler::~Scheduler()
@@ -280,6 +292,145 @@ void Scheduler::removeHashElement(_hashSelectorEntry *element)
     free(element);
 }
 
+void Scheduler::addTimer(tHashTimerEntry *element, Timer *timer)
+{
+    // updated by the loop until it is started
+    timer->_wheelElement = element;
+    timer->_wheelState = Timer::WheelState::LOOP;
+    ++element->loopTimers;
+}
+
+void Scheduler::detachTimer(tHashTimerEntry *element, Timer *timer)
+{
+    if (timer->_wheelState == Timer::WheelState::WHEEL)
+    {
+        _timerWheel.remove(&timer->_wheelEntry);
+    }
+    else if (timer->_wheelState == Timer::WheelState::LOOP)
+    {
+        --element->loopTimers;
+    }
+    timer->_wheelState = Timer::WheelState::PARKED;
+    timer->_wheelElement = nullptr;
+
+    // an expired timer being updated is skipped once it is aborted
+    timer->setAborted();
+}
+
+void Scheduler::moveTimerToLoop(tHashTimerEntry *element, Timer *timer)
+{
+    if (timer->_wheelState == Timer::WheelState::LOOP)
+        return;
+
+    if (timer->_wheelState == Timer::WheelState::WHEEL)
+    {
+        _timerWheel.remove(&timer->_wheelEntry);
+    }
+    timer->_wheelState = Timer::WheelState::LOOP;
+    ++element->loopTimers;
+}
+
+void Scheduler::moveTimerToWheel(tHashTimerEntry *element, Timer *timer)
+{
+    if (timer->_wheelState == Timer::WheelState::LOOP)
+    {
+        --element->loopTimers;
+    }
+
+    timer->_wheelTime = _timerTime;
+    timer->_wheelPausedTime = 0;
+    if (element->paused)
+    {
+        timer->_wheelState = Timer::WheelState::PARKED;
+    }
+    else
+    {
+        timer->_wheelState = Timer::WheelState::WHEEL;
+        float remaining = (timer->_useDelay ? timer->_delay : timer->_interval) - timer->_elapsed;
+        _timerWheel.add(&timer->_wheelEntry, _timerTime + remaining);
+    }
+}
+
+void Scheduler::setTimersPaused(tHashTimerEntry *element, bool paused)
+{
+    if (element->paused == paused)
+        return;
+
+    element->paused = paused;
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = (Timer*)element->timers->arr[i];
+        if (paused && timer->_wheelState == Timer::WheelState::WHEEL)
+        {
+            // keep the time elapsed so far, the paused time doesn't count
+            _timerWheel.remove(&timer->_wheelEntry);
+            timer->_wheelPausedTime += (float)(_timerTime - timer->_wheelTime);
+            timer->_wheelState = Timer::WheelState::PARKED;
+        }
+        else if (!paused && timer->_wheelState == Timer::WheelState::PARKED)
+        {
+            timer->_wheelTime = _timerTime;
+            timer->_wheelState = Timer::WheelState::WHEEL;
+            float remaining = (timer->_useDelay ? timer->_delay : timer->_interval) - timer->_elapsed - timer->_wheelPausedTime;
+            _timerWheel.add(&timer->_wheelEntry, _timerTime + remaining);
+        }
+    }
+}
+
+void Scheduler::updateWheelTimers()
+{
+    _expiredTimers.clear();
+    _timerWheel.advance(_timerTime, _expiredTimers);
+
+    // the callbacks may unschedule the other expired timers
+    for (auto expired : _expiredTimers)
+    {
+        Timer *timer = static_cast<Timer*>(expired);
+        timer->retain();
+        timer->_wheelState = Timer::WheelState::FIRING;
+    }
+
+    for (auto expired : _expiredTimers)
+    {
+        Timer *timer = static_cast<Timer*>(expired);
+        // skipped if it was unscheduled, rescheduled or paused by a previous callback
+        if (! timer->isAborted() && timer->_wheelState == Timer::WheelState::FIRING)
+        {
+            if (timer->_wheelElement->paused)
+            {
+                timer->_wheelPausedTime += (float)(_timerTime - timer->_wheelTime);
+                timer->_wheelTime = _timerTime;
+                timer->_wheelState = Timer::WheelState::PARKED;
+            }
+            else
+            {
+                float elapsed = timer->_wheelPausedTime + (float)(_timerTime - timer->_wheelTime);
+                timer->update(elapsed);
+
+                if (! timer->isAborted() && timer->_wheelState == Timer::WheelState::FIRING)
+                {
+                    // a delayed timer with no interval triggers every frame once the delay is over
+                    if (timer->isWaiting())
+                        moveTimerToWheel(timer->_wheelElement, timer);
+                    else
+                        moveTimerToLoop(timer->_wheelElement, timer);
+                }
+            }
+        }
+        timer->release();
+    }
+}
+
+int Scheduler::getLoopTimerCount() const
+{
+    int count = 0;
+    for (tHashTimerEntry *element = _hashForTimers; element != nullptr; element = (tHashTimerEntry *)element->hh.next)
+    {
+        count += element->loopTimers;
+    }
+    return count;
+}
+
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
 {
     this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
@@ -321,6 +472,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
             if (timer && !timer->isExhausted() && key == timer->getKey())
             {
                 CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+                moveTimerToLoop(element, timer);
                 timer->setupTimerWithInterval(interval, repeat, delay);
                 return;
             }
@@ -330,6 +482,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
     TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
+    addTimer(element, timer);
     ccArrayAppendObject(element->timers, timer);
     timer->release();
 }
@@ -362,6 +515,7 @@ void Scheduler::unschedule(const std::string &key, void *target)
                     timer->setAborted();
                 }
 
+                detachTimer(element, timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
                 // update timerIndex in case we are in tick:, looping over the actions
@@ -642,6 +796,10 @@ void Scheduler::unscheduleAllForTarget(void *target)
             element->currentTimer->retain();
             element->currentTimer->setAborted();
         }
+        for (int i = 0; i < element->timers->num; ++i)
+        {
+            detachTimer(element, (Timer*)element->timers->arr[i]);
+        }
         ccArrayRemoveAllObjects(element->timers);
 
         if (_currentTarget == element)
@@ -690,7 +848,7 @@ void Scheduler::resumeTarget(void *target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = false;
+        setTimersPaused(element, false);
     }
 
     // update selector
@@ -712,7 +870,7 @@ void Scheduler::pauseTarget(void *target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = true;
+        setTimersPaused(element, true);
     }
 
     // update selector
@@ -761,7 +919,7 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        setTimersPaused(element, true);
         idsWithSelectors.insert(element->target);
     }
 
@@ -809,13 +967,11 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(std::function<void ()> function)
 {
-    std::lock_guard<std::mutex> lock(_performMutex);
-    _functionsToPerform.push_back(std::move(function));
+    _functionsToPerform.push(std::move(function));
 }
 
 void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
     _functionsToPerform.clear();
 }
 
@@ -823,11 +979,13 @@ void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 void Scheduler::update(float dt)
 {
     _updateHashLocked = true;
+    ++_updateCount;
 
     if (_timeScale != 1.0f)
     {
         dt *= _timeScale;
     }
+    _timerTime += dt;
 
     //
     // Selector callbacks
@@ -869,7 +1027,8 @@ void Scheduler::update(float dt)
         _currentTarget = elt;
         _currentTargetSalvaged = false;
 
-        if (! _currentTarget->paused)
+        // the timers waiting in the timer wheel are updated by updateWheelTimers()
+        if (! _currentTarget->paused && _currentTarget->loopTimers > 0)
         {
             // The 'timers' array may change while inside this loop
             for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
@@ -879,6 +1038,12 @@ void Scheduler::update(float dt)
                   ( !elt->currentTimer->isAborted(),
                     "An aborted timer should not be updated" );
 
+                if (elt->currentTimer->_wheelState != Timer::WheelState::LOOP)
+                {
+                    elt->currentTimer = nullptr;
+                    continue;
+                }
+
                 elt->currentTimer->update(dt);
 
                 if (elt->currentTimer->isAborted())
@@ -888,6 +1053,11 @@ void Scheduler::update(float dt)
                     // it. Now that step is done, it's safe to release it.
                     elt->currentTimer->release();
                 }
+                else if (elt->currentTimer->isWaiting() && elt->currentTimer->_wheelState == Timer::WheelState::LOOP)
+                {
+                    // started, it waits in the wheel until its next trigger, or until its delay for scheduleOnce()
+                    moveTimerToWheel(elt, elt->currentTimer);
+                }
 
                 elt->currentTimer = nullptr;
             }
@@ -913,6 +1083,8 @@ void Scheduler::update(float dt)
     _updateHashLocked = false;
     _currentTarget = nullptr;
 
+    updateWheelTimers();
+
 #if CC_ENABLE_SCRIPT_BINDING
     //
     // Script callbacks
@@ -939,17 +1111,10 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
+    // Almost never there will be functions scheduled to be called.
+    // The functions added by the callbacks are run in the next frame, as when fixing #4123.
     if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = std::move(_functionsToPerform);
-        _performMutex.unlock();
-        
-        for (const auto &function : temp) {
-            function();
-        }
+        _functionsToPerform.run(_performFunctionTimeBudget);
     }
 }
 
@@ -988,6 +1153,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
             if (timer && !timer->isExhausted() && selector == timer->getSelector())
             {
                 CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+                moveTimerToLoop(element, timer);
                 timer->setupTimerWithInterval(interval, repeat, delay);
                 return;
             }
@@ -997,6 +1163,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
+    addTimer(element, timer);
     ccArrayAppendObject(element->timers, timer);
     timer->release();
 }
@@ -1062,6 +1229,7 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
                     timer->setAborted();
                 }
                 
+                detachTimer(element, timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
                 
                 // update timerIndex in case we are in tick:, looping over the actions
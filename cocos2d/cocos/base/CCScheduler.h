@@ -35,6 +35,8 @@ THE SOFTWARE.
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
+#include "base/CCFunctionQueue.h"
+#include "base/CCTimerWheel.h"
 #include "base/uthash.h"
 
 NS_CC_BEGIN
@@ -72,6 +74,24 @@ protected:
     float _delay;
     float _interval;
     bool _aborted;
+
+    // whether the next trigger is after an interval or a delay, rather than on the next frame
+    bool isWaiting() const;
+
+    // Timers with an interval or a delay wait in the TimerWheel of their Scheduler between two triggers
+    enum class WheelState : unsigned char
+    {
+        LOOP,       // updated every frame, until it is started if it is waiting
+        WHEEL,      // in the wheel
+        PARKED,     // out of the wheel while its target is paused
+        FIRING      // expired, being updated
+    };
+    TimerWheelEntry _wheelEntry;
+    WheelState _wheelState;
+    double _wheelTime;          // time of the scheduler when the timer was last updated
+    float _wheelPausedTime;     // time elapsed before the target was paused, not given to update() yet
+    struct _hashSelectorEntry* _wheelElement;
+    friend class Scheduler;
 };
 
 
@@ -211,6 +231,12 @@ public:
      */
     void update(float dt);
 
+    /** Gets the number of timers updated every frame.
+     The timers waiting for their interval or their delay are in the timer wheel, and are not counted.
+     It is meant for tests and benchmarks.
+     */
+    int getLoopTimerCount() const;
+
     /////////////////////////////////////
     
     // schedule
@@ -428,6 +454,41 @@ public:
      @js NA
      */
     void performFunctionInCocosThread(std::function<void()> function);
+
+    /** Calls a callable on the cocos2d thread, like performFunctionInCocosThread(std::function<void()>).
+     Small callables such as lambdas capturing a few values are stored without being converted to a std::function,
+     so queuing them doesn't allocate memory.
+     This function is thread safe.
+     @param function The callable to be run in cocos2d thread, taking no argument.
+     @js NA
+     @lua NA
+     */
+    template <typename F>
+    void performFunctionInCocosThread(F&& function)
+    {
+        _functionsToPerform.push(std::forward<F>(function));
+    }
+
+    /**
+     * Sets the time the functions queued with performFunctionInCocosThread can take in each frame.
+     * The functions not run when the budget is spent are run in the next frames, in the same order.
+     * It avoids a long frame when thousands of asynchronous operations complete together.
+     * @param seconds The time budget in seconds, 0 runs all the functions queued before the frame. The default is 0.
+     * @js NA
+     */
+    void setPerformFunctionTimeBudget(float seconds) { _performFunctionTimeBudget = seconds; }
+
+    /** Gets the time the functions queued with performFunctionInCocosThread can take in each frame.
+     * @js NA
+     */
+    float getPerformFunctionTimeBudget() const { return _performFunctionTimeBudget; }
+
+    /** Gets the number of update() calls started so far.
+     * The functions queued with performFunctionInCocosThread run at the end of update(), a function can compare
+     * the count with the one when it was queued to know whether it runs in the same frame.
+     * @js NA
+     */
+    unsigned int getUpdateCount() const { return _updateCount; }
     
     /**
      * Remove all pending functions queued to be performed with Scheduler::performFunctionInCocosThread
@@ -450,6 +511,15 @@ protected:
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
     void removeHashElement(struct _hashSelectorEntry *element);
+
+    // timer wheel specific
+
+    void addTimer(struct _hashSelectorEntry *element, Timer *timer);
+    void detachTimer(struct _hashSelectorEntry *element, Timer *timer);
+    void moveTimerToLoop(struct _hashSelectorEntry *element, Timer *timer);
+    void moveTimerToWheel(struct _hashSelectorEntry *element, Timer *timer);
+    void setTimersPaused(struct _hashSelectorEntry *element, bool paused);
+    void updateWheelTimers();
     void removeUpdateFromHash(struct _listEntry *entry);
 
     // update specific
@@ -475,14 +545,20 @@ protected:
     bool _currentTargetSalvaged;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
+    unsigned int _updateCount;
+
+    // Used for "selectors with interval" waiting for their next trigger
+    TimerWheel _timerWheel;
+    double _timerTime;
+    std::vector<void*> _expiredTimers;
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
 #endif
     
     // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    FunctionQueue _functionsToPerform;
+    float _performFunctionTimeBudget;
 };
 
 // end of base group
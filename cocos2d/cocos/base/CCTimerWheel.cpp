@@ -0,0 +1,182 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCTimerWheel.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+TimerWheel::TimerWheel(double tickDuration)
+: _tickDuration(tickDuration)
+, _nextTick(0)
+, _count(0)
+{
+    for (auto& level : _slots)
+    {
+        for (auto& head : level)
+        {
+            head.prev = head.next = &head;
+        }
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+    clear();
+}
+
+void TimerWheel::link(TimerWheelEntry* head, TimerWheelEntry* entry)
+{
+    entry->prev = head->prev;
+    entry->next = head;
+    head->prev->next = entry;
+    head->prev = entry;
+}
+
+void TimerWheel::unlink(TimerWheelEntry* entry)
+{
+    entry->prev->next = entry->next;
+    entry->next->prev = entry->prev;
+    entry->prev = entry->next = nullptr;
+}
+
+void TimerWheel::add(TimerWheelEntry* entry, double time)
+{
+    CCASSERT(!entry->isLinked(), "the entry is already in a wheel");
+    uint64_t expiry = time > 0 ? (uint64_t)(time / _tickDuration) : 0;
+    addTick(entry, expiry);
+    ++_count;
+}
+
+void TimerWheel::addTick(TimerWheelEntry* entry, uint64_t expiry)
+{
+    const uint64_t mask = SLOTS - 1;
+    TimerWheelEntry* head;
+    if (expiry < _nextTick)
+    {
+        // already expired, it expires with the next tick
+        expiry = _nextTick;
+        head = &_slots[0][expiry & mask];
+    }
+    else
+    {
+        uint64_t delta = expiry - _nextTick;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (uint64_t)1 << (SLOT_BITS * (level + 1)))
+            ++level;
+
+        const uint64_t maxDelta = ((uint64_t)1 << (SLOT_BITS * LEVELS)) - 1;
+        if (delta > maxDelta)
+        {
+            // it waits in the last level and is added again when cascading
+            expiry = _nextTick + maxDelta;
+        }
+        head = &_slots[level][(expiry >> (SLOT_BITS * level)) & mask];
+    }
+
+    entry->expiry = expiry;
+    link(head, entry);
+}
+
+void TimerWheel::remove(TimerWheelEntry* entry)
+{
+    CCASSERT(entry->isLinked(), "the entry isn't in a wheel");
+    unlink(entry);
+    --_count;
+}
+
+void TimerWheel::clear()
+{
+    for (auto& level : _slots)
+    {
+        for (auto& head : level)
+        {
+            while (head.next != &head)
+                unlink(head.next);
+        }
+    }
+    _count = 0;
+}
+
+int TimerWheel::cascade(int level, int index)
+{
+    // move the entries of the slot to the lower levels
+    TimerWheelEntry* head = &_slots[level][index];
+    TimerWheelEntry list;
+    list.prev = list.next = &list;
+    if (head->next != head)
+    {
+        list.next = head->next;
+        list.prev = head->prev;
+        list.next->prev = &list;
+        list.prev->next = &list;
+        head->prev = head->next = head;
+    }
+
+    while (list.next != &list)
+    {
+        TimerWheelEntry* entry = list.next;
+        unlink(entry);
+        addTick(entry, entry->expiry);
+    }
+    return index;
+}
+
+void TimerWheel::advance(double time, std::vector<void*>& expired)
+{
+    const uint64_t mask = SLOTS - 1;
+    uint64_t target = time > 0 ? (uint64_t)(time / _tickDuration) : 0;
+
+    while (_nextTick <= target)
+    {
+        if (_count == 0)
+        {
+            // nothing to expire, jump to the target
+            _nextTick = target + 1;
+            break;
+        }
+
+        int index = (int)(_nextTick & mask);
+        if (index == 0)
+        {
+            for (int level = 1; level < LEVELS; ++level)
+            {
+                if (cascade(level, (int)((_nextTick >> (SLOT_BITS * level)) & mask)) != 0)
+                    break;
+            }
+        }
+        ++_nextTick;
+
+        TimerWheelEntry* head = &_slots[0][index];
+        while (head->next != head)
+        {
+            TimerWheelEntry* entry = head->next;
+            unlink(entry);
+            --_count;
+            expired.push_back(entry->userData);
+        }
+    }
+}
+
+NS_CC_END
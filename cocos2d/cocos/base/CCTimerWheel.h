@@ -0,0 +1,102 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * An entry of a TimerWheel, embedded in the object it schedules.
+ */
+struct CC_DLL TimerWheelEntry
+{
+    TimerWheelEntry* prev = nullptr;
+    TimerWheelEntry* next = nullptr;
+    uint64_t expiry = 0;            ///< tick at which the entry expires
+    void* userData = nullptr;       ///< returned by TimerWheel::advance()
+
+    /** Whether the entry is in a wheel. */
+    bool isLinked() const { return prev != nullptr; }
+};
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel: adding and removing an entry is O(1), and expiring entries costs O(1) amortized.
+ * Time is counted in ticks, 4 levels of 64 slots cover 2^24 ticks, later entries wait in the last level.
+ * An entry never expires after its time, but it may expire up to one tick earlier since times are rounded down.
+ * @js NA
+ */
+class CC_DLL TimerWheel
+{
+public:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    /** @param tickDuration Duration of a tick in seconds. */
+    explicit TimerWheel(double tickDuration = 1.0 / 128);
+    ~TimerWheel();
+
+    /** Adds an unlinked entry which expires at the given time in seconds, on the clock of advance(). */
+    void add(TimerWheelEntry* entry, double time);
+
+    /** Removes a linked entry. */
+    void remove(TimerWheelEntry* entry);
+
+    /** Removes all entries. */
+    void clear();
+
+    /**
+     * Moves the clock to the given time in seconds, the user data of the expired entries are appended to expired.
+     * The expired entries are unlinked.
+     */
+    void advance(double time, std::vector<void*>& expired);
+
+    /** Returns the number of linked entries. */
+    size_t getCount() const { return _count; }
+
+private:
+    void addTick(TimerWheelEntry* entry, uint64_t expiry);
+    int cascade(int level, int index);
+    static void link(TimerWheelEntry* head, TimerWheelEntry* entry);
+    static void unlink(TimerWheelEntry* entry);
+
+    double _tickDuration;
+    uint64_t _nextTick;     // the next tick to expire
+    size_t _count;
+    TimerWheelEntry _slots[LEVELS][SLOTS];  // heads of circular lists
+};
+
+NS_CC_END
+// end of base group
+/// @}
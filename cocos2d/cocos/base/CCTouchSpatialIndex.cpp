@@ -0,0 +1,201 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "base/CCTouchSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "2d/CCNode.h"
+#include "math/CCAffineTransform.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // cell coordinates are clamped, so the bounds of far away nodes don't overflow
+    const float MAX_CELL = 1 << 20;
+
+    void eraseNode(std::vector<Node*>& nodes, Node* node)
+    {
+        auto iter = std::find(nodes.begin(), nodes.end(), node);
+        if (iter != nodes.end())
+        {
+            *iter = nodes.back();
+            nodes.pop_back();
+        }
+    }
+}
+
+TouchSpatialIndex::TouchSpatialIndex(float cellSize)
+: _cellSize(cellSize)
+{
+    CCASSERT(cellSize > 0, "The cell size must be positive");
+}
+
+void TouchSpatialIndex::addNode(Node* node)
+{
+    if (++_entries[node].listenerCount == 1)
+        markDirty(node);
+}
+
+bool TouchSpatialIndex::removeNode(Node* node)
+{
+    auto iter = _entries.find(node);
+    if (iter == _entries.end())
+        return false;
+
+    if (--iter->second.listenerCount > 0)
+        return false;
+
+    unlink(node, iter->second);
+    _entries.erase(iter);
+    return true;
+}
+
+void TouchSpatialIndex::markDirty(Node* node)
+{
+    std::lock_guard<std::mutex> lock(_dirtyMutex);
+    _dirtyNodes.push_back(node);
+}
+
+void TouchSpatialIndex::query(const Vec2& point, std::vector<Node*>& nodes)
+{
+    nodes.clear();
+    updateBounds();
+
+    auto cell = _cells.find(getCellKey(getCell(point.x), getCell(point.y)));
+    if (cell != _cells.end())
+    {
+        for (auto node : cell->second)
+        {
+            if (_entries[node].bounds.containsPoint(point))
+                nodes.push_back(node);
+        }
+    }
+
+    for (auto node : _oversizedNodes)
+    {
+        if (_entries[node].bounds.containsPoint(point))
+            nodes.push_back(node);
+    }
+
+    std::sort(nodes.begin(), nodes.end());
+}
+
+void TouchSpatialIndex::updateBounds()
+{
+    {
+        std::lock_guard<std::mutex> lock(_dirtyMutex);
+        _updatingNodes.swap(_dirtyNodes);
+    }
+
+    for (auto node : _updatingNodes)
+    {
+        // the node may have been removed after it was queued
+        auto iter = _entries.find(node);
+        if (iter == _entries.end())
+            continue;
+
+        Entry& entry = iter->second;
+        unlink(node, entry);
+        entry.bounds = RectApplyTransform(Rect(Vec2::ZERO, node->getContentSize()), node->getNodeToWorldTransform());
+        node->_touchBoundsDirty = false;
+        link(node, entry);
+    }
+    _updatingNodes.clear();
+}
+
+void TouchSpatialIndex::link(Node* node, Entry& entry)
+{
+    entry.minX = getCell(entry.bounds.getMinX());
+    entry.minY = getCell(entry.bounds.getMinY());
+    entry.maxX = getCell(entry.bounds.getMaxX());
+    entry.maxY = getCell(entry.bounds.getMaxY());
+
+    std::int64_t cellCount = (std::int64_t)(entry.maxX - entry.minX + 1) * (entry.maxY - entry.minY + 1);
+    entry.oversized = cellCount > MAX_CELLS_PER_NODE;
+    if (entry.oversized)
+    {
+        _oversizedNodes.push_back(node);
+    }
+    else
+    {
+        for (int y = entry.minY; y <= entry.maxY; ++y)
+        {
+            for (int x = entry.minX; x <= entry.maxX; ++x)
+            {
+                _cells[getCellKey(x, y)].push_back(node);
+            }
+        }
+    }
+    entry.linked = true;
+}
+
+void TouchSpatialIndex::unlink(Node* node, Entry& entry)
+{
+    if (!entry.linked)
+        return;
+
+    if (entry.oversized)
+    {
+        eraseNode(_oversizedNodes, node);
+    }
+    else
+    {
+        for (int y = entry.minY; y <= entry.maxY; ++y)
+        {
+            for (int x = entry.minX; x <= entry.maxX; ++x)
+            {
+                auto cell = _cells.find(getCellKey(x, y));
+                if (cell == _cells.end())
+                    continue;
+
+                eraseNode(cell->second, node);
+                if (cell->second.empty())
+                {
+                    _cells.erase(cell);
+                }
+            }
+        }
+    }
+    entry.linked = false;
+}
+
+int TouchSpatialIndex::getCell(float coordinate) const
+{
+    float cell = std::floor(coordinate / _cellSize);
+    // NaN bounds end up in the first cell
+    if (!(cell > -MAX_CELL))
+        return (int)-MAX_CELL;
+    if (cell > MAX_CELL)
+        return (int)MAX_CELL;
+    return (int)cell;
+}
+
+std::int64_t TouchSpatialIndex::getCellKey(int x, int y)
+{
+    return (std::int64_t)(((std::uint64_t)(std::uint32_t)x << 32) | (std::uint32_t)y);
+}
+
+NS_CC_END
@@ -0,0 +1,115 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/CCGeometry.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+class Node;
+
+/**
+ * @class TouchSpatialIndex
+ * @brief Uniform grid of the world space bounding boxes of nodes, used by EventDispatcher to find
+ * the nodes under a touch without invoking the listeners of all of them.
+ * The bounds of a node are the bounding box of its content size. They are recomputed on the next query
+ * for the nodes queued by markDirty() because their transform or content size changed while they were visited.
+ * @js NA
+ */
+class CC_DLL TouchSpatialIndex
+{
+public:
+    /** Nodes covering more cells are not stored in the grid, they are tested on each query. */
+    static const int MAX_CELLS_PER_NODE = 64;
+
+    /** @param cellSize The size of a cell of the grid, in points. */
+    explicit TouchSpatialIndex(float cellSize = 128.0f);
+
+    /** Adds a node, or counts one more listener for it if it is already indexed. */
+    void addNode(Node* node);
+
+    /**
+     * Counts one less listener for a node.
+     * @return True if it was the last listener of the node, which is not indexed anymore.
+     */
+    bool removeNode(Node* node);
+
+    /**
+     * Gets the nodes whose bounds contain a point.
+     *
+     * @param point The point in world coordinates.
+     * @param nodes Filled with the nodes containing the point, sorted by address.
+     */
+    void query(const Vec2& point, std::vector<Node*>& nodes);
+
+    /**
+     * Queues an indexed node whose transform or content size changed, its bounds are recomputed on the next query.
+     * It is thread-safe, Node invokes it while being visited, maybe in the threads of ParallelVisitor.
+     */
+    void markDirty(Node* node);
+
+    /** Whether no node is indexed. */
+    bool empty() const { return _entries.empty(); }
+
+private:
+    struct Entry
+    {
+        int listenerCount = 0;
+        bool linked = false;
+        bool oversized = false;
+        Rect bounds;
+        int minX = 0;
+        int minY = 0;
+        int maxX = 0;
+        int maxY = 0;
+    };
+
+    void updateBounds();
+    void link(Node* node, Entry& entry);
+    void unlink(Node* node, Entry& entry);
+    int getCell(float coordinate) const;
+    static std::int64_t getCellKey(int x, int y);
+
+    std::unordered_map<Node*, Entry> _entries;
+    std::unordered_map<std::int64_t, std::vector<Node*>> _cells;
+    std::vector<Node*> _oversizedNodes;
+    std::vector<Node*> _dirtyNodes;
+    std::vector<Node*> _updatingNodes;
+    std::mutex _dirtyMutex;
+    float _cellSize;
+};
+
+NS_CC_END
+// end group
+/// @}
@@ -108,7 +108,7 @@ public:
     const_reverse_iterator crend() const { return _data.crend(); }
     
     /** Constructor. */
-    Vector<T>()
+    Vector()
     : _data()
     {
         static_assert(std::is_convertible<T, Ref*>::value, "Invalid Type for cocos2d::Vector<T>!");
@@ -118,7 +118,7 @@ public:
      * Constructor with a capacity. 
      * @param capacity Capacity of the Vector.
      */
-    explicit Vector<T>(ssize_t capacity)
+    explicit Vector(ssize_t capacity)
     : _data()
     {
         static_assert(std::is_convertible<T, Ref*>::value, "Invalid Type for cocos2d::Vector<T>!");
@@ -127,7 +127,7 @@ public:
     }
 
     /** Constructor with initializer list. */
-    Vector<T>(std::initializer_list<T> list)
+    Vector(std::initializer_list<T> list)
     {
         for (auto& element : list)
         {
@@ -136,14 +136,14 @@ public:
     }
 
     /** Destructor. */
-    ~Vector<T>()
+    ~Vector()
     {
         CCLOGINFO("In the destructor of Vector.");
         clear();
     }
 
     /** Copy constructor. */
-    Vector<T>(const Vector<T>& other)
+    Vector(const Vector<T>& other)
     {
         static_assert(std::is_convertible<T, Ref*>::value, "Invalid Type for cocos2d::Vector<T>!");
         CCLOGINFO("In the copy constructor!");
@@ -152,7 +152,7 @@ public:
     }
     
     /** Constructor with std::move semantic. */
-    Vector<T>(Vector<T>&& other)
+    Vector(Vector<T>&& other)
     {
         static_assert(std::is_convertible<T, Ref*>::value, "Invalid Type for cocos2d::Vector<T>!");
         CCLOGINFO("In the move constructor of Vector!");
@@ -47,12 +47,11 @@ THE SOFTWARE.
 
 /** @def CC_ENABLE_GL_STATE_CACHE
  * If enabled, cocos2d will maintain an OpenGL state cache internally to avoid unnecessary switches.
- * In order to use them, you have to use the following functions, instead of the GL ones:
- *  - ccGLUseProgram() instead of glUseProgram().
- *  - GL::deleteProgram() instead of glDeleteProgram().
- *  - GL::blendFunc() instead of glBlendFunc().
+ * The opengl backend sets program, buffer, texture, blend, depth, stencil, cull and scissor state through backend::StateCacheGL,
+ * and skips uniform values which are not changed since the program was last used.
+ * If you change these states with GL calls directly, invoke backend::StateCacheGL::invalidate() afterwards.
 
- * If this functionality is disabled, then ccGLUseProgram(), GL::deleteProgram(), GL::blendFunc() will call the GL ones, without using the cache.
+ * If this functionality is disabled, then backend::StateCacheGL will call the GL ones, without using the cache.
 
  * It is recommended to enable whenever possible to improve speed.
  * If you are migrating your code from GL ES 1.1, then keep it disabled. Once all your code works as expected, turn it on.
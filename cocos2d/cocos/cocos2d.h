@@ -40,6 +40,7 @@ THE SOFTWARE.
 
 // base
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCCoroutine.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCConsole.h"
@@ -106,6 +107,7 @@ THE SOFTWARE.
 #include "2d/CCActionInterval.h"
 #include "2d/CCActionManager.h"
 #include "2d/CCActionPageTurn3D.h"
+#include "2d/CCActionPool.h"
 #include "2d/CCActionProgressTimer.h"
 #include "2d/CCActionTiledGrid.h"
 #include "2d/CCActionTween.h"
@@ -125,6 +127,7 @@ THE SOFTWARE.
 #include "2d/CCMotionStreak.h"
 #include "2d/CCNode.h"
 #include "2d/CCNodeGrid.h"
+#include "2d/CCParallelVisitor.h"
 #include "2d/CCParticleBatchNode.h"
 #include "2d/CCParticleExamples.h"
 #include "2d/CCParticleSystem.h"
@@ -168,6 +168,7 @@ void SkeletonNode::updateVertices()
         }
 
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        invalidateSubtreeBounds();
     }
 }
 
@@ -184,18 +184,14 @@ void NavMeshDebugDraw::draw(Renderer* renderer)
         _vertexBuffer->updateData(_vertices.data(), sizeof(_vertices[0]) * _vertices.size());
         _dirtyBuffer = false;
     }
-    int idx = 0;
-    if (_commands.size() < _primitiveList.size())
-    {
-        _commands.resize(_primitiveList.size());
-    }
     for (auto &iter : _primitiveList) {
         if (iter->type == backend::PrimitiveType::POINT)
             continue;
         if (iter->end - iter->start <= 0)
             continue;
 
-        auto &command = _commands[idx];
+        // the commands live until the frame is rendered, so they stay valid when draw() is invoked again meanwhile
+        auto &command = *renderer->createFrameCommand<CustomCommand>();
 
         initCustomCommand(command);
         command.setBeforeCallback(CC_CALLBACK_0(NavMeshDebugDraw::onBeforeEachCommand, this, iter->depthMask));
@@ -211,7 +207,6 @@ void NavMeshDebugDraw::draw(Renderer* renderer)
         renderer->addCommand(&command);
 
         CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, iter->end - iter->start);
-        idx++;
     }
 
     renderer->addCommand(&_afterCommand);
@@ -106,7 +106,6 @@ private:
     std::vector<V3F_C4F>        _vertices;
     std::vector<Primitive*>     _primitiveList;
     backend::UniformLocation    _locMVP;
-    std::vector<CustomCommand>  _commands;
 
     CallbackCommand             _beforeCommand;
     CallbackCommand             _afterCommand;
@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "platform/desktop/CCFramePacer-desktop.h"
+
+#include <algorithm>
+#include <thread>
+
+NS_CC_BEGIN
+
+namespace
+{
+    // bounds of the spinned margin before a deadline
+    const std::chrono::microseconds MIN_SPIN_MARGIN(200);
+    const std::chrono::microseconds MAX_SPIN_MARGIN(4000);
+}
+
+FramePacer::FramePacer()
+: _interval(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(1.0f / 60.0f)))
+, _oversleep(std::chrono::microseconds(1000))
+, _started(false)
+{
+}
+
+void FramePacer::setInterval(float interval)
+{
+    _interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(interval));
+}
+
+float FramePacer::getInterval() const
+{
+    return std::chrono::duration_cast<std::chrono::duration<float>>(_interval).count();
+}
+
+void FramePacer::reset()
+{
+    _started = false;
+}
+
+void FramePacer::waitForNextFrame()
+{
+    auto now = Clock::now();
+    if (!_started)
+    {
+        _started = true;
+        _deadline = now;
+    }
+
+    _deadline += _interval;
+    if (now >= _deadline)
+    {
+        // a slightly late frame is caught up by the next one, a frame late by more than a whole frame restarts the cadence
+        if (now - _deadline >= _interval)
+        {
+            _deadline = now;
+        }
+        return;
+    }
+
+    for (;;)
+    {
+        auto margin = std::min(std::max(_oversleep, Clock::duration(MIN_SPIN_MARGIN)), Clock::duration(MAX_SPIN_MARGIN));
+        auto before = Clock::now();
+        auto remaining = _deadline - before;
+        if (remaining <= margin)
+            break;
+
+        auto requested = remaining - margin;
+        std::this_thread::sleep_for(requested);
+
+        auto overslept = (Clock::now() - before) - requested;
+        if (overslept > _oversleep)
+            _oversleep = overslept;
+        else
+            _oversleep += (overslept - _oversleep) / 16;
+    }
+
+    while (Clock::now() < _deadline)
+    {
+        std::this_thread::yield();
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,73 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <chrono>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/**
+ * Paces the frames of a run loop on a steady clock.
+ * The frames are aligned on absolute deadlines, so the sleep errors don't accumulate.
+ * Most of the wait is slept, and the end of it is spun: the spin margin follows the oversleep measured
+ * on the previous sleeps, so the timer slack of the system doesn't make the frames miss their deadline.
+ */
+class CC_DLL FramePacer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    FramePacer();
+
+    /** Sets the duration of a frame in seconds. */
+    void setInterval(float interval);
+    float getInterval() const;
+
+    /**
+     * Waits until the deadline of the next frame.
+     * If the frame is late by more than a whole frame, the deadlines are aligned on the current time instead of catching up.
+     */
+    void waitForNextFrame();
+
+    /** Aligns the next deadline on the current time, e.g. after the loop was suspended. */
+    void reset();
+
+private:
+    Clock::duration _interval;
+    Clock::time_point _deadline;
+    Clock::duration _oversleep;     // estimated oversleep of the system, rises fast and decays slowly
+    bool _started;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
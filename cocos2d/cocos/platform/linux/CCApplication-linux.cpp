@@ -24,8 +24,6 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "platform/linux/CCApplication-linux.h"
-#include <unistd.h>
-#include <sys/time.h>
 #include <string>
 #include "base/CCDirector.h"
 #include "base/ccUtils.h"
@@ -37,17 +35,7 @@ NS_CC_BEGIN
 // sharedApplication pointer
 Application * Application::sm_pSharedApplication = nullptr;
 
-static long getCurrentMillSecond() {
-    long lLastTime;
-    struct timeval stCurrentTime;
-
-    gettimeofday(&stCurrentTime,NULL);
-    lLastTime = stCurrentTime.tv_sec*1000+stCurrentTime.tv_usec*0.001; // milliseconds
-    return lLastTime;
-}
-
 Application::Application()
-: _animationInterval(1.0f/60.0f*1000.0f)
 {
     CC_ASSERT(! sm_pSharedApplication);
     sm_pSharedApplication = this;
@@ -68,27 +56,19 @@ int Application::run()
         return 0;
     }
 
-    long lastTime = 0L;
-    long curTime = 0L;
-
     auto director = Director::getInstance();
     auto glview = director->getOpenGLView();
 
     // Retain glview to avoid glview being released in the while loop
     glview->retain();
 
+    _framePacer.reset();
     while (!glview->windowShouldClose())
     {
-        lastTime = getCurrentMillSecond();
-
         director->mainLoop();
         glview->pollEvents();
 
-        curTime = getCurrentMillSecond();
-        if (curTime - lastTime < _animationInterval)
-        {
-            usleep((_animationInterval - curTime + lastTime)*1000);
-        }
+        _framePacer.waitForNextFrame();
     }
     /* Only work on Desktop
     *  Director::mainLoop is really one frame logic
@@ -107,8 +87,7 @@ int Application::run()
 
 void Application::setAnimationInterval(float interval)
 {
-    //TODO do something else
-    _animationInterval = interval*1000.0f;
+    _framePacer.setInterval(interval);
 }
 
 void Application::setResourceRootPath(const std::string& rootResDir)
@@ -27,6 +27,7 @@ THE SOFTWARE.
 
 #include "platform/CCCommon.h"
 #include "platform/CCApplicationProtocol.h"
+#include "platform/desktop/CCFramePacer-desktop.h"
 #include <string>
 
 NS_CC_BEGIN
@@ -104,7 +105,7 @@ public:
      */
     virtual Platform getTargetPlatform() override;
 protected:
-    long       _animationInterval;  //micro second
+    FramePacer _framePacer;
     std::string _resourceRootPath;
     
     static Application * sm_pSharedApplication;
@@ -27,6 +27,7 @@ THE SOFTWARE.
 
 #include "platform/CCCommon.h"
 #include "platform/CCApplicationProtocol.h"
+#include "platform/desktop/CCFramePacer-desktop.h"
 #include <string>
 
 NS_CC_BEGIN
@@ -99,7 +100,7 @@ public:
 protected:
     static Application * sm_pSharedApplication;
     
-    long _animationInterval;  //micro second
+    FramePacer _framePacer;
     std::string _resourceRootPath;
     std::string _startupScriptFilename;
 };
@@ -36,20 +36,9 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
-static long getCurrentMillSecond()
-{
-    long lLastTime = 0;
-    struct timeval stCurrentTime;
-    
-    gettimeofday(&stCurrentTime,NULL);
-    lLastTime = stCurrentTime.tv_sec*1000+stCurrentTime.tv_usec*0.001; // milliseconds
-    return lLastTime;
-}
-
 Application* Application::sm_pSharedApplication = nullptr;
 
 Application::Application()
-: _animationInterval(1.0f/60.0f*1000.0f)
 {
     CCASSERT(! sm_pSharedApplication, "sm_pSharedApplication already exist");
     sm_pSharedApplication = this;
@@ -69,27 +58,19 @@ int Application::run()
         return 1;
     }
     
-    long lastTime = 0L;
-    long curTime = 0L;
-    
     auto director = Director::getInstance();
     auto glview = director->getOpenGLView();
     
     // Retain glview to avoid glview being released in the while loop
     glview->retain();
 
+    _framePacer.reset();
     while (!glview->windowShouldClose())
     {
-        lastTime = getCurrentMillSecond();
-        
         director->mainLoop();
         glview->pollEvents();
 
-        curTime = getCurrentMillSecond();
-        if (curTime - lastTime < _animationInterval)
-        {
-            usleep(static_cast<useconds_t>((_animationInterval - curTime + lastTime)*1000));
-        }
+        _framePacer.waitForNextFrame();
     }
 
     /* Only work on Desktop
@@ -110,7 +91,7 @@ int Application::run()
 
 void Application::setAnimationInterval(float interval)
 {
-    _animationInterval = interval*1000.0f;
+    _framePacer.setInterval(interval);
 }
 
 Application::Platform Application::getTargetPlatform()
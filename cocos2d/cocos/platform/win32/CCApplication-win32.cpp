@@ -45,7 +45,6 @@ Application::Application()
 , _accelTable(nullptr)
 {
     _instance    = GetModuleHandle(nullptr);
-    _animationInterval.QuadPart = 0;
     CC_ASSERT(! sm_pSharedApplication);
     sm_pSharedApplication = this;
 }
@@ -72,12 +71,6 @@ int Application::run()
         timeBeginPeriod(wTimerRes);
     }
 
-    // Main message loop:
-    LARGE_INTEGER nLast;
-    LARGE_INTEGER nNow;
-
-    QueryPerformanceCounter(&nLast);
-
     initGLContextAttrs();
 
     // Initialize instance and cocos2d.
@@ -92,33 +85,15 @@ int Application::run()
     // Retain glview to avoid glview being released in the while loop
     glview->retain();
 
-    LONGLONG interval = 0LL;
-    LONG waitMS = 0L;
-
-    LARGE_INTEGER freq;
-    QueryPerformanceFrequency(&freq);
-
+    // Main message loop:
+    // the timer resolution set above keeps the sleeps of the frame pacer short, it spins the rest of the wait
+    _framePacer.reset();
     while(!glview->windowShouldClose())
     {
-        QueryPerformanceCounter(&nNow);
-        interval = nNow.QuadPart - nLast.QuadPart;
-        if (interval >= _animationInterval.QuadPart)
-        {
-            nLast.QuadPart = nNow.QuadPart;
-            director->mainLoop();
-            glview->pollEvents();
-        }
-        else
-        {
-            // The precision of timer on Windows is set to highest (1ms) by 'timeBeginPeriod' from above code,
-            // but it's still not precise enough. For example, if the precision of timer is 1ms,
-            // Sleep(3) may make a sleep of 2ms or 4ms. Therefore, we subtract 1ms here to make Sleep time shorter.
-            // If 'waitMS' is equal or less than 1ms, don't sleep and run into next loop to
-            // boost CPU to next frame accurately.
-            waitMS = static_cast<LONG>((_animationInterval.QuadPart - interval) * 1000LL / freq.QuadPart - 1L);
-            if (waitMS > 1L)
-                Sleep(waitMS);
-        }
+        director->mainLoop();
+        glview->pollEvents();
+
+        _framePacer.waitForNextFrame();
     }
 
     // Director should still do a cleanup if the window was closed manually.
@@ -142,9 +117,7 @@ int Application::run()
 
 void Application::setAnimationInterval(float interval)
 {
-    LARGE_INTEGER freq;
-    QueryPerformanceFrequency(&freq);
-    _animationInterval.QuadPart = (LONGLONG)(interval * freq.QuadPart);
+    _framePacer.setInterval(interval);
 }
 
 //////////////////////////////////////////////////////////////////////////
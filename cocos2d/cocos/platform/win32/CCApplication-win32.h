@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "platform/CCStdC.h"
 #include "platform/CCCommon.h"
 #include "platform/CCApplicationProtocol.h"
+#include "platform/desktop/CCFramePacer-desktop.h"
 #include <string>
 
 NS_CC_BEGIN
@@ -102,7 +103,7 @@ public:
 protected:
     HINSTANCE           _instance;
     HACCEL              _accelTable;
-    LARGE_INTEGER       _animationInterval;
+    FramePacer          _framePacer;
     std::string         _resourceRootPath;
     std::string         _startupScriptFilename;
 
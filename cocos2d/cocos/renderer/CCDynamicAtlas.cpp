@@ -0,0 +1,348 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCDynamicAtlas.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureCache.h"
+#include "platform/CCImage.h"
+
+NS_CC_BEGIN
+
+namespace {
+    // Every image is surrounded by a copy of its border pixels, so that linear filtering doesn't sample the neighbours.
+    const int EXTRUDE = 1;
+}
+
+DynamicAtlas::DynamicAtlas(int pageSize, int maxPages, int maxImageSize)
+: _pageSize(pageSize)
+, _maxPages(maxPages)
+, _maxImageSize(std::min(maxImageSize, pageSize - 2 * EXTRUDE))
+{
+}
+
+DynamicAtlas::~DynamicAtlas()
+{
+    removeAllImages();
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    for (auto page : _retiredPages)
+    {
+        page->texture->release();
+        delete page;
+    }
+#endif
+}
+
+bool DynamicAtlas::canPack(Image* image) const
+{
+    if (image == nullptr || image->isCompressed())
+        return false;
+
+    if (image->getWidth() > _maxImageSize || image->getHeight() > _maxImageSize)
+        return false;
+
+    auto format = image->getPixelFormat();
+    return (format == backend::PixelFormat::RGBA8888 && image->hasPremultipliedAlpha()) ||
+           format == backend::PixelFormat::RGB888;
+}
+
+const DynamicAtlas::Region* DynamicAtlas::addImage(const std::string& key, Image* image)
+{
+    if (!canPack(image))
+        return nullptr;
+
+    auto it = _regions.find(key);
+    if (it != _regions.end())
+    {
+        auto& region = it->second;
+        if (region.rect.size.width == image->getWidth() && region.rect.size.height == image->getHeight())
+        {
+            for (auto page : _pages)
+            {
+                if (page->texture == region.page)
+                {
+                    upload(page, image, (int)region.rect.origin.x - EXTRUDE, (int)region.rect.origin.y - EXTRUDE);
+                    page->lastUsed = ++_useCounter;
+                    return &region;
+                }
+            }
+        }
+        _regions.erase(it);
+    }
+
+    int width = image->getWidth() + 2 * EXTRUDE;
+    int height = image->getHeight() + 2 * EXTRUDE;
+    int x = 0;
+    int y = 0;
+    Page* target = nullptr;
+    for (auto page : _pages)
+    {
+        if (insert(page, width, height, x, y))
+        {
+            target = page;
+            break;
+        }
+    }
+
+    if (target == nullptr)
+    {
+        if (static_cast<int>(_pages.size()) >= _maxPages)
+        {
+            auto lru = std::min_element(_pages.begin(), _pages.end(), [](const Page* a, const Page* b) {
+                return a->lastUsed < b->lastUsed;
+            });
+            removePage(*lru);
+        }
+
+        target = createPage();
+        if (target == nullptr || !insert(target, width, height, x, y))
+            return nullptr;
+    }
+
+    upload(target, image, x, y);
+    target->lastUsed = ++_useCounter;
+
+    Region region;
+    region.page = target->texture;
+    region.rect = Rect(x + EXTRUDE, y + EXTRUDE, image->getWidth(), image->getHeight());
+    return &(_regions[key] = region);
+}
+
+const DynamicAtlas::Region* DynamicAtlas::getRegion(const std::string& key)
+{
+    auto it = _regions.find(key);
+    if (it == _regions.end())
+        return nullptr;
+
+    for (auto page : _pages)
+    {
+        if (page->texture == it->second.page)
+        {
+            page->lastUsed = ++_useCounter;
+            break;
+        }
+    }
+    return &it->second;
+}
+
+void DynamicAtlas::removeImage(const std::string& key)
+{
+    _regions.erase(key);
+}
+
+void DynamicAtlas::removeAllImages()
+{
+    while (!_pages.empty())
+        removePage(_pages.back());
+}
+
+void DynamicAtlas::removeUnusedPages()
+{
+    // Iterate on a copy, removePage() erases from _pages.
+    auto pages = _pages;
+    for (auto page : pages)
+    {
+        if (page->texture->getReferenceCount() == 1)
+            removePage(page);
+    }
+    releaseRetiredPages();
+}
+
+DynamicAtlas::Page* DynamicAtlas::createPage()
+{
+    releaseRetiredPages();
+
+    std::vector<unsigned char> data(_pageSize * _pageSize * 4, 0);
+    auto texture = new (std::nothrow) Texture2D();
+    if (texture == nullptr ||
+        !texture->initWithData(data.data(), data.size(), backend::PixelFormat::RGBA8888, _pageSize, _pageSize, Size(_pageSize, _pageSize), true))
+    {
+        CC_SAFE_RELEASE(texture);
+        return nullptr;
+    }
+
+    auto page = new Page();
+    page->texture = texture;
+    page->skyline.push_back({0, 0, _pageSize});
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    page->data = std::move(data);
+    VolatileTextureMgr::addDataTexture(texture, page->data.data(), (int)page->data.size(), backend::PixelFormat::RGBA8888, Size(_pageSize, _pageSize));
+#endif
+    _pages.push_back(page);
+    return page;
+}
+
+void DynamicAtlas::removePage(Page* page)
+{
+    for (auto it = _regions.begin(); it != _regions.end(); )
+    {
+        if (it->second.page == page->texture)
+            it = _regions.erase(it);
+        else
+            ++it;
+    }
+
+    _pages.erase(std::find(_pages.begin(), _pages.end(), page));
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // Sprites may keep the texture alive, keep the pixels to restore it until they release it.
+    if (page->texture->getReferenceCount() > 1)
+    {
+        _retiredPages.push_back(page);
+        return;
+    }
+#endif
+    page->texture->release();
+    delete page;
+}
+
+void DynamicAtlas::releaseRetiredPages()
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    for (auto it = _retiredPages.begin(); it != _retiredPages.end(); )
+    {
+        auto page = *it;
+        if (page->texture->getReferenceCount() == 1)
+        {
+            page->texture->release();
+            delete page;
+            it = _retiredPages.erase(it);
+        }
+        else
+            ++it;
+    }
+#endif
+}
+
+bool DynamicAtlas::insert(Page* page, int width, int height, int& x, int& y)
+{
+    auto& skyline = page->skyline;
+    int bestIndex = -1;
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+    int bestY = 0;
+
+    for (int i = 0; i < static_cast<int>(skyline.size()); ++i)
+    {
+        // The rect lies on the highest node it spans.
+        int left = skyline[i].x;
+        if (left + width > _pageSize)
+            break;
+
+        int top = 0;
+        int remaining = width;
+        for (int j = i; remaining > 0; ++j)
+        {
+            top = std::max(top, skyline[j].y);
+            remaining -= skyline[j].width;
+        }
+        if (top + height > _pageSize)
+            continue;
+
+        if (top + height < bestTop || (top + height == bestTop && skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestTop = top + height;
+            bestWidth = skyline[i].width;
+            bestY = top;
+        }
+    }
+
+    if (bestIndex < 0)
+        return false;
+
+    x = skyline[bestIndex].x;
+    y = bestY;
+    skyline.insert(skyline.begin() + bestIndex, {x, y + height, width});
+
+    // Shrink or remove the nodes covered by the new one.
+    for (auto i = bestIndex + 1; i < static_cast<int>(skyline.size()); )
+    {
+        auto& previous = skyline[i - 1];
+        auto& node = skyline[i];
+        int overlap = previous.x + previous.width - node.x;
+        if (overlap <= 0)
+            break;
+
+        if (overlap < node.width)
+        {
+            node.x += overlap;
+            node.width -= overlap;
+            break;
+        }
+        skyline.erase(skyline.begin() + i);
+    }
+
+    // Merge the neighbours at the same height.
+    for (auto i = 1; i < static_cast<int>(skyline.size()); )
+    {
+        if (skyline[i - 1].y == skyline[i].y)
+        {
+            skyline[i - 1].width += skyline[i].width;
+            skyline.erase(skyline.begin() + i);
+        }
+        else
+            ++i;
+    }
+    return true;
+}
+
+void DynamicAtlas::upload(Page* page, Image* image, int x, int y)
+{
+    int imageWidth = image->getWidth();
+    int imageHeight = image->getHeight();
+    int width = imageWidth + 2 * EXTRUDE;
+    int height = imageHeight + 2 * EXTRUDE;
+    int bytesPerPixel = image->getPixelFormat() == backend::PixelFormat::RGB888 ? 3 : 4;
+    const unsigned char* src = image->getData();
+
+    std::vector<unsigned char> pixels(width * height * 4);
+    for (int row = 0; row < height; ++row)
+    {
+        int srcRow = std::min(std::max(row - EXTRUDE, 0), imageHeight - 1);
+        auto dst = pixels.data() + row * width * 4;
+        for (int column = 0; column < width; ++column, dst += 4)
+        {
+            int srcColumn = std::min(std::max(column - EXTRUDE, 0), imageWidth - 1);
+            auto pixel = src + (srcRow * imageWidth + srcColumn) * bytesPerPixel;
+            dst[0] = pixel[0];
+            dst[1] = pixel[1];
+            dst[2] = pixel[2];
+            dst[3] = bytesPerPixel == 4 ? pixel[3] : 255;
+        }
+    }
+
+    page->texture->updateWithData(pixels.data(), x, y, width, height);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    for (int row = 0; row < height; ++row)
+        memcpy(page->data.data() + ((y + row) * _pageSize + x) * 4, pixels.data() + row * width * 4, width * 4);
+#endif
+}
+
+NS_CC_END
@@ -0,0 +1,154 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "base/ccConfig.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+class Texture2D;
+class Image;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @brief Packs small images into shared textures at runtime.
+ * Sprites made from separate image files use different textures and can't be drawn in one batch.
+ * When the dynamic atlas of the TextureCache is enabled, small images are also copied into pages of the atlas as they are loaded,
+ * and sprites created from these files use the page texture with the rect of the image in it, as if the images were packed
+ * in a sprite sheet.
+ * Pages are filled with a skyline packer. When all pages are full, the least recently used page is dropped from the atlas,
+ * sprites using it keep it alive until they are released.
+ * Only RGBA8888 images with premultiplied alpha and RGB888 images are packed, 9-patch images are never packed.
+ */
+class CC_DLL DynamicAtlas
+{
+public:
+    /** The location of a packed image. */
+    struct Region
+    {
+        /** The page texture. */
+        Texture2D* page = nullptr;
+        /** The rect of the image in the page, in pixels. */
+        Rect rect;
+    };
+
+    /**
+     * @param pageSize Width and height of a page in pixels.
+     * @param maxPages Max number of pages, the least recently used page is dropped to create a new one.
+     * @param maxImageSize Images wider or higher than it aren't packed.
+     */
+    DynamicAtlas(int pageSize = 1024, int maxPages = 4, int maxImageSize = 256);
+    ~DynamicAtlas();
+
+    /** Copy an image into a page.
+     * If an image with the same key and size is already packed, its pixels are replaced.
+     * @param key The key of the image, usually its full path.
+     * @param image The image to pack.
+     * @return The region of the image, or nullptr if the image can't be packed.
+     */
+    const Region* addImage(const std::string& key, Image* image);
+
+    /** Get the region of a packed image, and mark its page as used.
+     * @return The region, or nullptr if the image isn't packed.
+     */
+    const Region* getRegion(const std::string& key);
+
+    /** Whether the image can be packed, it depends on its pixel format and size. */
+    bool canPack(Image* image) const;
+
+    /** Remove an image from the atlas, sprites already using its region aren't changed. */
+    void removeImage(const std::string& key);
+
+    /** Remove all the images and pages. */
+    void removeAllImages();
+
+    /** Drop the pages which are not used by any sprite. */
+    void removeUnusedPages();
+
+    /** Number of pages. */
+    int getPageCount() const { return static_cast<int>(_pages.size()); }
+
+    /** Number of packed images. */
+    int getImageCount() const { return static_cast<int>(_regions.size()); }
+
+    /** Size in pixels of a page. */
+    int getPageSize() const { return _pageSize; }
+
+protected:
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    struct Page
+    {
+        Texture2D* texture = nullptr;
+        std::vector<SkylineNode> skyline;
+        unsigned int lastUsed = 0;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // The pixels are kept to restore the page when the GL context is recreated.
+        std::vector<unsigned char> data;
+#endif
+    };
+
+    Page* createPage();
+
+    /** Drop a page and the images in it. */
+    void removePage(Page* page);
+
+    /** Delete the dropped pages which are not used anymore. */
+    void releaseRetiredPages();
+
+    /** Find a place for a rect in a page with the skyline bottom-left heuristic. */
+    bool insert(Page* page, int width, int height, int& x, int& y);
+
+    /** Copy the image into the page, with its borders extruded by 1 pixel. */
+    void upload(Page* page, Image* image, int x, int y);
+
+    int _pageSize;
+    int _maxPages;
+    int _maxImageSize;
+    unsigned int _useCounter = 0;
+    std::vector<Page*> _pages;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    std::vector<Page*> _retiredPages;
+#endif
+    std::unordered_map<std::string, Region> _regions;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
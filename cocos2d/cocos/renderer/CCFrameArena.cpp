@@ -0,0 +1,94 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCFrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+NS_CC_BEGIN
+
+FrameArena::FrameArena(std::size_t blockSize)
+{
+    _blocks.reserve(8);
+    addBlock(blockSize);
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+    for (auto& block : _blocks)
+        delete[] block.data;
+}
+
+void* FrameArena::allocate(std::size_t size, std::size_t alignment)
+{
+    auto address = reinterpret_cast<std::uintptr_t>(_current);
+    auto aligned = (address + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+    if (aligned + size > reinterpret_cast<std::uintptr_t>(_end))
+    {
+        addBlock(size + alignment);
+        address = reinterpret_cast<std::uintptr_t>(_current);
+        aligned = (address + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+    }
+
+    _usedSize += aligned + size - address;
+    _current = reinterpret_cast<char*>(aligned + size);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void FrameArena::reset()
+{
+    for (auto destructor = _destructors; destructor; destructor = destructor->next)
+        destructor->destroy(destructor->object);
+    _destructors = nullptr;
+
+    if (_blocks.size() > 1)
+    {
+        // The frame didn't fit, replace the blocks with one block large enough for it.
+        for (auto& block : _blocks)
+            delete[] block.data;
+        _blocks.clear();
+        auto capacity = _capacity;
+        _capacity = 0;
+        addBlock(capacity);
+    }
+    else
+    {
+        _current = _blocks.front().data;
+    }
+    _usedSize = 0;
+}
+
+void FrameArena::addBlock(std::size_t minSize)
+{
+    auto size = std::max(minSize, _blocks.empty() ? minSize : _blocks.back().size * 2);
+    Block block = {new char[size], size};
+    _blocks.push_back(block);
+    _capacity += size;
+    _current = block.data;
+    _end = block.data + size;
+}
+
+NS_CC_END
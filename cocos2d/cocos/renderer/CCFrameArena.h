@@ -0,0 +1,122 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+/**
+ * Bump allocator for the objects living until the end of a frame, such as transient render commands and vertex data.
+ * Allocating is a pointer increment, reset() runs the destructors and rewinds the memory.
+ * When a frame needs more than one block, the blocks are merged into one at reset(), so that the following frames
+ * don't allocate from the heap anymore.
+ */
+class CC_DLL FrameArena
+{
+public:
+    /**
+     * @param blockSize Size in bytes of the first block.
+     */
+    explicit FrameArena(std::size_t blockSize = 64 * 1024);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * Allocate memory valid until the next reset().
+     * @param size Specifies the size in bytes.
+     * @param alignment Specifies the alignment, must be a power of 2.
+     */
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Construct an object valid until the next reset(), its destructor is invoked by reset().
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        auto object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value)
+        {
+            auto destructor = static_cast<Destructor*>(allocate(sizeof(Destructor), alignof(Destructor)));
+            destructor->destroy = [](void* p) { static_cast<T*>(p)->~T(); };
+            destructor->object = object;
+            destructor->next = _destructors;
+            _destructors = destructor;
+        }
+        return object;
+    }
+
+    /**
+     * Destroy the created objects in reverse order and release all the allocations.
+     */
+    void reset();
+
+    /** Bytes allocated since the last reset(). */
+    std::size_t getUsedSize() const { return _usedSize; }
+
+    /** Bytes reserved from the heap. */
+    std::size_t getCapacity() const { return _capacity; }
+
+private:
+    struct Destructor
+    {
+        void (*destroy)(void*);
+        void* object;
+        Destructor* next;
+    };
+
+    struct Block
+    {
+        char* data;
+        std::size_t size;
+    };
+
+    void addBlock(std::size_t minSize);
+
+    std::vector<Block> _blocks;
+    char* _current = nullptr;
+    char* _end = nullptr;
+    std::size_t _usedSize = 0;
+    std::size_t _capacity = 0;
+    Destructor* _destructors = nullptr;
+};
+
+// end of renderer group
+/// @}
+NS_CC_END
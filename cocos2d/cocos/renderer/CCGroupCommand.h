@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <unordered_map>
+#include <mutex>
 
 #include "base/CCRef.h"
 #include "renderer/CCRenderCommand.h"
@@ -54,6 +55,8 @@ protected:
     bool init();
     std::unordered_map<int, bool> _groupMapping;
     std::vector<int> _unusedIDs;
+    // group commands may be initialized by threads visiting nodes in parallel
+    std::mutex _mutex;
 };
 
 /**
@@ -68,11 +68,20 @@ public:
 
     void init(float globalZOrder, const Mat4 &transform);
 
+    /**
+    Set the color of this mesh instance. It is used instead of the u_color uniform
+    when the command is drawn with an instanced program.
+    */
+    void setInstanceColor(const Vec4& color) { _instanceColor = color; }
+    const Vec4& getInstanceColor() const { return _instanceColor; }
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     void listenRendererRecreated(EventCustom* event);
 #endif
 
 protected:
+    Vec4 _instanceColor = Vec4::ONE;
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _rendererRecreatedListener;
 #endif
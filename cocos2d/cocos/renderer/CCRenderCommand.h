@@ -98,7 +98,17 @@ public:
 
     const Mat4 & getMV() const { return _mv; }
 
+    /**
+     Get the packed sort key, it is generated when the command is pushed into a `RenderQueue`.
+     Layout from the most significant bit: queue group (3 bits), order (32 bits), material ID (29 bits).
+     The order field is the global Z order for 2D queues and the inverted depth for transparent 3D queue,
+     encoded so that unsigned comparison gives the drawing order.
+     */
+    uint64_t getSortKey() const { return _sortKey; }
+
 protected:
+    friend class RenderQueue;
+
     /**Constructor.*/
     RenderCommand();
     /**Destructor.*/
@@ -129,6 +139,9 @@ protected:
 
     Mat4 _mv;
 
+    /** Packed sort key, see `getSortKey()`. */
+    uint64_t _sortKey = 0;
+
     PipelineDescriptor _pipelineDescriptor;
 };
 
@@ -46,35 +46,87 @@
 #include "xxhash.h"
 
 #include "renderer/backend/Backend.h"
+#include "renderer/backend/capture/FrameCapture.h"
 
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// Maps a float to an unsigned integer whose unsigned order matches the float order.
+static inline uint32_t floatToSortableBits(float value)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    // flip all bits of negative values, only the sign bit of positive values
+    uint32_t mask = static_cast<uint32_t>(-static_cast<int32_t>(bits >> 31)) | 0x80000000;
+    return bits ^ mask;
 }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
+static bool isInstancedProgram(backend::ProgramState* programState)
 {
-    return  a->getDepth() > b->getDepth();
+    auto programType = programState->getProgram()->getProgramType();
+    return programType == backend::ProgramType::POSITION_TEXTURE_3D_INSTANCED ||
+           programType == backend::ProgramType::POSITION_3D_INSTANCED;
 }
 
+// Whether the MeshCommands draw the same geometry with the same program state, only transform and color differ.
+// Program states are the same, or share their uniforms and textures without callback uniforms.
+static bool isSameProgramState(backend::ProgramState* a, backend::ProgramState* b)
+{
+    return a == b ||
+           (a->getProgram() == b->getProgram() &&
+            a->getCallbackUniforms().empty() && b->getCallbackUniforms().empty() &&
+            a->getMaterialID() == b->getMaterialID());
+}
+
+static bool canBeInstanced(MeshCommand* a, MeshCommand* b)
+{
+    return !a->isSkipBatching() && !b->isSkipBatching() &&
+           isSameProgramState(a->getPipelineDescriptor().programState, b->getPipelineDescriptor().programState) &&
+           a->getVertexBuffer() == b->getVertexBuffer() &&
+           a->getIndexBuffer() == b->getIndexBuffer() &&
+           a->getIndexFormat() == b->getIndexFormat() &&
+           a->getIndexDrawOffset() == b->getIndexDrawOffset() &&
+           a->getIndexDrawCount() == b->getIndexDrawCount() &&
+           a->getPrimitiveType() == b->getPrimitiveType();
+}
+
+// How many batches are searched backwards for one with the same material when reordering TrianglesCommands.
+static const int BATCH_REORDER_SEARCH_DEPTH = 8;
+
+// Commands fewer than this are sorted by std::stable_sort, the radix histograms don't pay off.
+static const size_t RADIX_SORT_THRESHOLD = 64;
+
 // queue
 RenderQueue::RenderQueue()
 {
 }
 
+uint64_t RenderQueue::generateSortKey(RenderCommand* command, QUEUE_GROUP group)
+{
+    uint32_t order = 0;
+    if (group == QUEUE_GROUP::TRANSPARENT_3D)
+        order = ~floatToSortableBits(command->getDepth()); // far to near
+    else
+        order = floatToSortableBits(command->getGlobalOrder());
+
+    uint32_t materialID = 0;
+    if (command->getType() == RenderCommand::Type::TRIANGLES_COMMAND)
+        materialID = static_cast<TrianglesCommand*>(command)->getMaterialID();
+
+    return (static_cast<uint64_t>(group) << 61) | (static_cast<uint64_t>(order) << 29) | (materialID & 0x1FFFFFFF);
+}
+
 void RenderQueue::push_back(RenderCommand* command)
 {
+    QUEUE_GROUP group;
     float z = command->getGlobalOrder();
     if(z < 0)
     {
-        _commands[QUEUE_GROUP::GLOBALZ_NEG].push_back(command);
+        group = QUEUE_GROUP::GLOBALZ_NEG;
     }
     else if(z > 0)
     {
-        _commands[QUEUE_GROUP::GLOBALZ_POS].push_back(command);
+        group = QUEUE_GROUP::GLOBALZ_POS;
     }
     else
     {
@@ -82,18 +134,21 @@ void RenderQueue::push_back(RenderCommand* command)
         {
             if(command->isTransparent())
             {
-                _commands[QUEUE_GROUP::TRANSPARENT_3D].push_back(command);
+                group = QUEUE_GROUP::TRANSPARENT_3D;
             }
             else
             {
-                _commands[QUEUE_GROUP::OPAQUE_3D].push_back(command);
+                group = QUEUE_GROUP::OPAQUE_3D;
             }
         }
         else
         {
-            _commands[QUEUE_GROUP::GLOBALZ_ZERO].push_back(command);
+            group = QUEUE_GROUP::GLOBALZ_ZERO;
         }
     }
+
+    command->_sortKey = generateSortKey(command, group);
+    _commands[group].push_back(command);
 }
 
 ssize_t RenderQueue::size() const
@@ -110,9 +165,73 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    radixSort(_commands[QUEUE_GROUP::TRANSPARENT_3D]);
+    radixSort(_commands[QUEUE_GROUP::GLOBALZ_NEG]);
+    radixSort(_commands[QUEUE_GROUP::GLOBALZ_POS]);
+}
+
+void RenderQueue::radixSort(std::vector<RenderCommand*>& commands)
+{
+    const size_t count = commands.size();
+    if (count < 2)
+        return;
+
+    // Only the order field takes part in sorting. The queue group is the same for the whole sub queue,
+    // and commands with the same order must keep their submission order whatever their material is.
+    if (count < RADIX_SORT_THRESHOLD)
+    {
+        std::stable_sort(std::begin(commands), std::end(commands), [](RenderCommand* a, RenderCommand* b) {
+            return (uint32_t)(a->getSortKey() >> 29) < (uint32_t)(b->getSortKey() >> 29);
+        });
+        return;
+    }
+
+    if (_sortBuffer.size() < count)
+    {
+        _sortBuffer.resize(count);
+        _sortScratch.resize(count);
+    }
+
+    // extract keys and build the histograms of all 4 digits in one pass
+    uint32_t histograms[4][256] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t key = (uint32_t)(commands[i]->getSortKey() >> 29);
+        _sortBuffer[i].key = key;
+        _sortBuffer[i].command = commands[i];
+        ++histograms[0][key & 0xFF];
+        ++histograms[1][(key >> 8) & 0xFF];
+        ++histograms[2][(key >> 16) & 0xFF];
+        ++histograms[3][key >> 24];
+    }
+
+    SortEntry* src = _sortBuffer.data();
+    SortEntry* dst = _sortScratch.data();
+    for (int pass = 0; pass < 4; ++pass)
+    {
+        uint32_t* histogram = histograms[pass];
+        const int shift = pass * 8;
+
+        // skip the pass if all keys share this digit, usual for the high bytes of global Z
+        if (histogram[(src[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (int digit = 0; digit < 256; ++digit)
+        {
+            uint32_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+            dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+        std::swap(src, dst);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        commands[i] = src[i].command;
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -153,10 +272,18 @@ void RenderQueue::realloc(size_t reserveSize)
 //
 static const int DEFAULT_RENDER_QUEUE = 0;
 
+// commands added by the current thread are recorded into it if not null, @see Renderer::beginRecording()
+static thread_local CommandRecording* s_recording = nullptr;
+
+// frame arena of the current thread if it isn't the one owning the renderer, @see Renderer::getFrameArena()
+static thread_local FrameArena* s_threadFrameArena = nullptr;
+static thread_local Renderer* s_threadFrameArenaOwner = nullptr;
+
 //
 // constructors, destructor, init
 //
 Renderer::Renderer()
+: _threadId(std::this_thread::get_id())
 {
     _groupCommandManager = new (std::nothrow) GroupCommandManager();
     
@@ -177,6 +304,7 @@ Renderer::~Renderer()
     
     free(_triBatchesToDraw);
     
+    CC_SAFE_RELEASE(_instanceBuffer);
     CC_SAFE_RELEASE(_commandBuffer);
     CC_SAFE_RELEASE(_renderPipeline);
 }
@@ -190,12 +318,19 @@ void Renderer::init()
 
     auto device = backend::Device::getInstance();
     _commandBuffer = device->newCommandBuffer();
+    _instancingSupported = device->getDeviceInfo()->checkForFeatureSupported(backend::FeatureType::INSTANCING);
     _renderPipeline = device->newRenderPipeline();
     _commandBuffer->setRenderPipeline(_renderPipeline);
 }
 
 void Renderer::addCommand(RenderCommand* command)
 {
+    if (s_recording)
+    {
+        s_recording->_entries.push_back({CommandRecording::Entry::Type::ADD, command, -1});
+        return;
+    }
+
     int renderQueueID =_commandGroupStack.top();
     addCommand(command, renderQueueID);
 }
@@ -206,21 +341,78 @@ void Renderer::addCommand(RenderCommand* command, int renderQueueID)
     CCASSERT(renderQueueID >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
+    if (s_recording)
+    {
+        s_recording->_entries.push_back({CommandRecording::Entry::Type::ADD_TO_QUEUE, command, renderQueueID});
+        return;
+    }
+
     _renderGroups[renderQueueID].push_back(command);
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    if (s_recording)
+    {
+        s_recording->_entries.push_back({CommandRecording::Entry::Type::PUSH_GROUP, nullptr, renderQueueID});
+        return;
+    }
     _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    if (s_recording)
+    {
+        s_recording->_entries.push_back({CommandRecording::Entry::Type::POP_GROUP, nullptr, -1});
+        return;
+    }
     _commandGroupStack.pop();
 }
 
+void Renderer::beginRecording(CommandRecording* recording)
+{
+    CCASSERT(recording, "Invalid recording");
+    CCASSERT(!s_recording, "The thread is already recording");
+    s_recording = recording;
+}
+
+void Renderer::endRecording()
+{
+    CCASSERT(s_recording, "The thread is not recording");
+    s_recording = nullptr;
+}
+
+bool Renderer::isRecording()
+{
+    return s_recording != nullptr;
+}
+
+void Renderer::replay(const CommandRecording& recording)
+{
+    CCASSERT(!s_recording, "Cannot replay while recording");
+    for (const auto& entry : recording._entries)
+    {
+        switch (entry.type)
+        {
+            case CommandRecording::Entry::Type::ADD:
+                addCommand(entry.command);
+                break;
+            case CommandRecording::Entry::Type::ADD_TO_QUEUE:
+                addCommand(entry.command, entry.renderQueueID);
+                break;
+            case CommandRecording::Entry::Type::PUSH_GROUP:
+                pushGroup(entry.renderQueueID);
+                break;
+            case CommandRecording::Entry::Type::POP_GROUP:
+                popGroup();
+                break;
+        }
+    }
+}
+
 int Renderer::createRenderQueue()
 {
     RenderQueue newRenderQueue;
@@ -263,28 +455,42 @@ void Renderer::processRenderCommand(RenderCommand* command)
                 drawBatchedTriangles();
 
                 _queuedTotalIndexCount = _queuedTotalVertexCount = 0;
-#ifdef CC_USE_METAL
                 _queuedIndexCount = _queuedVertexCount = 0;
                 _triangleCommandBufferManager.prepareNextBuffer();
                 _vertexBuffer = _triangleCommandBufferManager.getVertexBuffer();
                 _indexBuffer = _triangleCommandBufferManager.getIndexBuffer();
-#endif
             }
             
             // queue it
             _queuedTriangleCommands.push_back(cmd);
-#ifdef CC_USE_METAL
             _queuedIndexCount += cmd->getIndexCount();
             _queuedVertexCount += cmd->getVertexCount();
-#endif
             _queuedTotalVertexCount += cmd->getVertexCount();
             _queuedTotalIndexCount += cmd->getIndexCount();
 
         }
             break;
         case RenderCommand::Type::MESH_COMMAND:
+        {
             flush2D();
-            drawMeshCommand(command);
+
+            auto cmd = static_cast<MeshCommand*>(command);
+            if (isInstancedProgram(cmd->getPipelineDescriptor().programState))
+            {
+                // flush own queue when the command can't be merged or the queue is full
+                if (!_queuedMeshCommands.empty() &&
+                    (!canBeInstanced(_queuedMeshCommands.front(), cmd) || _queuedMeshCommands.size() >= MAX_MESH_INSTANCES))
+                {
+                    drawInstancedMeshCommands();
+                }
+                _queuedMeshCommands.push_back(cmd);
+            }
+            else
+            {
+                flush3D();
+                drawMeshCommand(command);
+            }
+        }
             break;
         case RenderCommand::Type::GROUP_COMMAND:
             processGroupCommand(static_cast<GroupCommand*>(command));
@@ -376,18 +582,22 @@ void Renderer::render()
 
 void Renderer::beginFrame()
 {
+    auto frameCapture = backend::FrameCapture::getInstance();
+    if (frameCapture->isCaptureRequested())
+        _commandBuffer = frameCapture->beginCapture(_commandBuffer);
+
     _commandBuffer->beginFrame();
 }
 
 void Renderer::endFrame()
 {
     _commandBuffer->endFrame();
+    if (backend::FrameCapture::isCapturing())
+        _commandBuffer = backend::FrameCapture::getInstance()->endCapture();
 
-#ifdef CC_USE_METAL
     _triangleCommandBufferManager.putbackAllBuffers();
     _vertexBuffer = _triangleCommandBufferManager.getVertexBuffer();
     _indexBuffer = _triangleCommandBufferManager.getIndexBuffer();
-#endif
     _queuedTotalIndexCount = 0;
     _queuedTotalVertexCount = 0;
 }
@@ -407,6 +617,31 @@ void Renderer::clean()
 
     // Clear batch commands
     _queuedTriangleCommands.clear();
+    _queuedMeshCommands.clear();
+
+    // Destroy the frame commands, all of them have been rendered
+    _frameArena.reset();
+    std::lock_guard<std::mutex> lock(_threadFrameArenasMutex);
+    for (auto& arena : _threadFrameArenas)
+    {
+        arena->reset();
+    }
+}
+
+FrameArena& Renderer::getFrameArena()
+{
+    if (std::this_thread::get_id() == _threadId)
+        return _frameArena;
+
+    CCASSERT(s_recording, "Only the threads recording commands can allocate frame memory besides the renderer thread");
+    if (s_threadFrameArenaOwner != this)
+    {
+        std::lock_guard<std::mutex> lock(_threadFrameArenasMutex);
+        _threadFrameArenas.emplace_back(new (std::nothrow) FrameArena(16 * 1024));
+        s_threadFrameArena = _threadFrameArenas.back().get();
+        s_threadFrameArenaOwner = this;
+    }
+    return *s_threadFrameArena;
 }
 
 void Renderer::setDepthTest(bool value)
@@ -549,19 +784,143 @@ void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int
     _filledIndex += indexCount;
 }
 
+// Number of draw calls drawBatchedTriangles() issues for the commands, following its batching rules.
+static int countTrianglesBatches(const std::vector<TrianglesCommand*>& commands)
+{
+    int batches = 0;
+    int64_t prevMaterialID = -1;
+    for (const auto& cmd : commands)
+    {
+        if (cmd->isSkipBatching())
+        {
+            ++batches;
+            prevMaterialID = -1;
+        }
+        else if (cmd->getMaterialID() != prevMaterialID)
+        {
+            ++batches;
+            prevMaterialID = cmd->getMaterialID();
+        }
+    }
+    return batches;
+}
+
+void Renderer::reorderTrianglesCommands()
+{
+    const int count = (int)_queuedTriangleCommands.size();
+    if (count < 3)
+        return;
+
+    _triBatchesToReorder.clear();
+    _reorderNextCommand.assign(count, -1);
+
+    for (int i = 0; i < count; ++i)
+    {
+        auto cmd = _queuedTriangleCommands[i];
+        const uint32_t materialID = cmd->getMaterialID();
+        // 3D commands are not moved, their screen space bounds depend on the projection
+        const bool batchable = !cmd->isSkipBatching() && !cmd->is3D();
+
+        // screen space bounds: local bounds of the vertices transformed by the model view matrix
+        const V3F_C4B_T2F* verts = cmd->getVertices();
+        const size_t vertexCount = cmd->getVertexCount();
+        float lminX = FLT_MAX, lminY = FLT_MAX, lmaxX = -FLT_MAX, lmaxY = -FLT_MAX;
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            lminX = std::min(lminX, verts[v].vertices.x);
+            lmaxX = std::max(lmaxX, verts[v].vertices.x);
+            lminY = std::min(lminY, verts[v].vertices.y);
+            lmaxY = std::max(lmaxY, verts[v].vertices.y);
+        }
+        const Mat4& mv = cmd->getModelView();
+        float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+        const float cornersX[4] = {lminX, lmaxX, lminX, lmaxX};
+        const float cornersY[4] = {lminY, lminY, lmaxY, lmaxY};
+        for (int c = 0; c < 4; ++c)
+        {
+            const float x = mv.m[0] * cornersX[c] + mv.m[4] * cornersY[c] + mv.m[12];
+            const float y = mv.m[1] * cornersX[c] + mv.m[5] * cornersY[c] + mv.m[13];
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+
+        // Search backwards for a batch with the same material. The command can only be moved in front of
+        // the batches it doesn't overlap, otherwise the drawing order would be visible.
+        int target = -1;
+        if (batchable)
+        {
+            const int last = (int)_triBatchesToReorder.size() - 1;
+            for (int b = last; b >= 0 && b > last - BATCH_REORDER_SEARCH_DEPTH; --b)
+            {
+                const auto& batch = _triBatchesToReorder[b];
+                if (batch.batchable && batch.materialID == materialID)
+                {
+                    target = b;
+                    break;
+                }
+                const bool overlapped = minX < batch.maxX && batch.minX < maxX && minY < batch.maxY && batch.minY < maxY;
+                if (overlapped || !batch.batchable)
+                    break;
+            }
+        }
+
+        if (target >= 0)
+        {
+            auto& batch = _triBatchesToReorder[target];
+            _reorderNextCommand[batch.tail] = i;
+            batch.tail = i;
+            batch.minX = std::min(batch.minX, minX);
+            batch.minY = std::min(batch.minY, minY);
+            batch.maxX = std::max(batch.maxX, maxX);
+            batch.maxY = std::max(batch.maxY, maxY);
+        }
+        else
+        {
+            TriBatchToReorder batch;
+            batch.materialID = materialID;
+            batch.batchable = batchable;
+            batch.minX = minX;
+            batch.minY = minY;
+            batch.maxX = maxX;
+            batch.maxY = maxY;
+            batch.head = batch.tail = i;
+            _triBatchesToReorder.push_back(batch);
+        }
+    }
+
+    if ((int)_triBatchesToReorder.size() == count)
+        return;
+
+    _reorderedTriangleCommands.clear();
+    for (const auto& batch : _triBatchesToReorder)
+    {
+        for (int i = batch.head; i >= 0; i = _reorderNextCommand[i])
+            _reorderedTriangleCommands.push_back(_queuedTriangleCommands[i]);
+    }
+
+    const int batchesBefore = countTrianglesBatches(_queuedTriangleCommands);
+    const int batchesAfter = countTrianglesBatches(_reorderedTriangleCommands);
+    if (batchesAfter < batchesBefore)
+    {
+        _queuedTriangleCommands.swap(_reorderedTriangleCommands);
+        _savedBatches += batchesBefore - batchesAfter;
+    }
+}
+
 void Renderer::drawBatchedTriangles()
 {
     if(_queuedTriangleCommands.empty())
         return;
+
+    if (_isBatchReorderEnabled)
+        reorderTrianglesCommands();
     
     /************** 1: Setup up vertices/indices *************/
-#ifdef CC_USE_METAL
+    // Append to the regions of the buffers not used yet in this frame, the GPU may still read the previous regions.
     unsigned int vertexBufferFillOffset = _queuedTotalVertexCount - _queuedVertexCount;
     unsigned int indexBufferFillOffset = _queuedTotalIndexCount - _queuedIndexCount;
-#else
-    unsigned int vertexBufferFillOffset = 0;
-    unsigned int indexBufferFillOffset = 0;
-#endif
 
     _triBatchesToDraw[0].offset = indexBufferFillOffset;
     _triBatchesToDraw[0].indicesToDraw = 0;
@@ -617,13 +976,14 @@ void Renderer::drawBatchedTriangles()
         firstCommand = false;
     }
     batchesTotal++;
-#ifdef CC_USE_METAL
+    // The first batch of the frame wraps the ring around to buffers drawn FRAMES_IN_FLIGHT frames ago,
+    // orphan them instead of relying on the swap chain latency to have retired those draws.
+    if (vertexBufferFillOffset == 0)
+        _vertexBuffer->orphanData();
+    if (indexBufferFillOffset == 0)
+        _indexBuffer->orphanData();
     _vertexBuffer->updateSubData(_verts, vertexBufferFillOffset * sizeof(_verts[0]), _filledVertex * sizeof(_verts[0]));
     _indexBuffer->updateSubData(_indices, indexBufferFillOffset * sizeof(_indices[0]), _filledIndex * sizeof(_indices[0]));
-#else
-    _vertexBuffer->updateData(_verts, _filledVertex * sizeof(_verts[0]));
-    _indexBuffer->updateData(_indices,  _filledIndex * sizeof(_indices[0]));
-#endif
 
     /************** 2: Draw *************/
     for (int i = 0; i < batchesTotal; ++i)
@@ -646,10 +1006,8 @@ void Renderer::drawBatchedTriangles()
     /************** 3: Cleanup *************/
     _queuedTriangleCommands.clear();
 
-#ifdef CC_USE_METAL
     _queuedIndexCount = 0;
     _queuedVertexCount = 0;
-#endif
 }
 
 void Renderer::drawCustomCommand(RenderCommand *command)
@@ -693,6 +1051,87 @@ void Renderer::drawMeshCommand(RenderCommand *command)
 }
 
 
+const backend::VertexLayout& Renderer::getInstanceLayout(backend::Program* program)
+{
+    auto iter = _instanceLayouts.find(program);
+    if (iter != _instanceLayouts.end())
+        return iter->second;
+
+    static const char* attributeNames[] = {
+        backend::ATTRIBUTE_NAME_INSTANCE_MVP0,
+        backend::ATTRIBUTE_NAME_INSTANCE_MVP1,
+        backend::ATTRIBUTE_NAME_INSTANCE_MVP2,
+        backend::ATTRIBUTE_NAME_INSTANCE_MVP3,
+        backend::ATTRIBUTE_NAME_INSTANCE_COLOR
+    };
+
+    // every attribute is a vec4: the 4 columns of MVP matrix, then color
+    backend::VertexLayout layout;
+    for (int i = 0; i < 5; ++i)
+    {
+        int location = program->getAttributeLocation(attributeNames[i]);
+        if (location >= 0)
+            layout.setAttribute(attributeNames[i], location, backend::VertexFormat::FLOAT4, i * sizeof(Vec4), false);
+    }
+    layout.setLayout(sizeof(MeshInstanceData));
+
+    return _instanceLayouts.emplace(program, layout).first->second;
+}
+
+void Renderer::drawInstancedMeshCommands()
+{
+    if (_queuedMeshCommands.empty())
+        return;
+
+    auto firstCmd = _queuedMeshCommands.front();
+    auto programState = firstCmd->getPipelineDescriptor().programState;
+    const size_t instanceCount = _queuedMeshCommands.size();
+
+    // Same as Pass::updateMVPUniform(), but per instance.
+    const auto& projection = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    const size_t dataSize = instanceCount * sizeof(MeshInstanceData);
+    auto instanceData = static_cast<MeshInstanceData*>(_frameArena.allocate(dataSize, alignof(MeshInstanceData)));
+    for (size_t i = 0; i < instanceCount; ++i)
+    {
+        auto cmd = _queuedMeshCommands[i];
+        Mat4::multiply(projection, cmd->getMV(), &instanceData[i].mvp);
+        instanceData[i].color = cmd->getInstanceColor();
+    }
+
+    if (!_instanceBuffer || _instanceBuffer->getSize() < dataSize)
+    {
+        size_t bufferSize = _instanceBuffer ? _instanceBuffer->getSize() : 0;
+        bufferSize = std::max(dataSize, bufferSize * 2);
+        CC_SAFE_RELEASE(_instanceBuffer);
+        _instanceBuffer = backend::Device::getInstance()->newBuffer(bufferSize, backend::BufferType::VERTEX, backend::BufferUsage::DYNAMIC);
+    }
+    _instanceBuffer->updateData(instanceData, dataSize);
+
+    // the commands share the pass, so the state applied by the first one applies to all
+    if (firstCmd->getBeforeCallback()) firstCmd->getBeforeCallback()();
+
+    beginRenderPass(firstCmd);
+    _commandBuffer->setVertexBuffer(firstCmd->getVertexBuffer());
+    _commandBuffer->setIndexBuffer(firstCmd->getIndexBuffer());
+    _commandBuffer->setProgramState(programState);
+    _commandBuffer->setInstanceBuffer(_instanceBuffer, getInstanceLayout(programState->getProgram()), instanceData);
+    _commandBuffer->setLineWidth(firstCmd->getLineWidth());
+    _commandBuffer->drawElementsInstanced(firstCmd->getPrimitiveType(),
+                                          firstCmd->getIndexFormat(),
+                                          firstCmd->getIndexDrawCount(),
+                                          firstCmd->getIndexDrawOffset(),
+                                          instanceCount);
+    _commandBuffer->endRenderPass();
+
+    if (firstCmd->getAfterCallback()) firstCmd->getAfterCallback()();
+
+    // without instancing support, the backend draws the instances one at a time
+    _drawnBatches += _instancingSupported ? 1 : instanceCount;
+    _drawnVertices += firstCmd->getIndexDrawCount() * instanceCount;
+
+    _queuedMeshCommands.clear();
+}
+
 void Renderer::flush()
 {
     flush2D();
@@ -706,7 +1145,7 @@ void Renderer::flush2D()
 
 void Renderer::flush3D()
 {
-    //TODO 3d batch rendering
+    drawInstancedMeshCommands();
 }
 
 void Renderer::flushTriangles()
@@ -751,6 +1190,8 @@ void Renderer::setRenderPipeline(const PipelineDescriptor& pipelineDescriptor, c
 {
     auto device = backend::Device::getInstance();
     _renderPipeline->update(pipelineDescriptor, renderPassDescriptor);
+    if (backend::FrameCapture::isCapturing())
+        backend::FrameCapture::getInstance()->recordRenderPipeline(pipelineDescriptor);
     backend::DepthStencilState* depthStencilState = nullptr;
     auto needDepthStencilAttachment = renderPassDescriptor.depthTestEnabled || renderPassDescriptor.stencilTestEnabled;
     if (needDepthStencilAttachment)
@@ -833,29 +1274,39 @@ void Renderer::clear(ClearFlag flags, const Color4F& color, float depth, unsigne
 {
     _clearFlag = flags;
 
-    CallbackCommand* command = new CallbackCommand();
+    // Invoked every frame, the command and the values are allocated in the frame arena.
+    // Capturing a pointer to the values keeps the callback small enough to not allocate either.
+    struct ClearValues
+    {
+        ClearFlag flags;
+        Color4F color;
+        float depth;
+        unsigned int stencil;
+    };
+    auto values = createFrameCommand<ClearValues>(ClearValues{flags, color, depth, stencil});
+    auto command = createFrameCommand<CallbackCommand>();
     command->init(globalOrder);
-    command->func = [=]() -> void {
+    command->func = [this, values]() -> void {
         backend::RenderPassDescriptor descriptor;
 
-        if (flags & ClearFlag::COLOR)
+        if (values->flags & ClearFlag::COLOR)
         {
-            _clearColor = color;
-            descriptor.clearColorValue = {color.r, color.g, color.b, color.a};
+            _clearColor = values->color;
+            descriptor.clearColorValue = {values->color.r, values->color.g, values->color.b, values->color.a};
             descriptor.needClearColor = true;
             descriptor.needColorAttachment = true;
             descriptor.colorAttachmentsTexture[0] = _renderPassDescriptor.colorAttachmentsTexture[0];
         }
-        if (flags & ClearFlag::DEPTH)
+        if (values->flags & ClearFlag::DEPTH)
         {
-            descriptor.clearDepthValue = depth;
+            descriptor.clearDepthValue = values->depth;
             descriptor.needClearDepth = true;
             descriptor.depthTestEnabled = true;
             descriptor.depthAttachmentTexture = _renderPassDescriptor.depthAttachmentTexture;
         }
-        if (flags & ClearFlag::STENCIL)
+        if (values->flags & ClearFlag::STENCIL)
         {
-            descriptor.clearStencilValue = stencil;
+            descriptor.clearStencilValue = values->stencil;
             descriptor.needClearStencil = true;
             descriptor.stencilTestEnabled = true;
             descriptor.stencilAttachmentTexture = _renderPassDescriptor.stencilAttachmentTexture;
@@ -863,8 +1314,6 @@ void Renderer::clear(ClearFlag flags, const Color4F& color, float depth, unsigne
 
         _commandBuffer->beginRenderPass(descriptor);
         _commandBuffer->endRenderPass();
-
-        delete command;
     };
     addCommand(command);
 }
@@ -935,11 +1384,14 @@ void Renderer::setScissorRect(float x, float y, float width, float height)
 // TriangleCommandBufferManager
 Renderer::TriangleCommandBufferManager::~TriangleCommandBufferManager()
 {
-    for (auto& vertexBuffer : _vertexBufferPool)
-        vertexBuffer->release();
+    for (auto& pool : _bufferPools)
+    {
+        for (auto& vertexBuffer : pool.vertexBuffers)
+            vertexBuffer->release();
 
-    for (auto& indexBuffer : _indexBufferPool)
-        indexBuffer->release();
+        for (auto& indexBuffer : pool.indexBuffers)
+            indexBuffer->release();
+    }
 }
 
 void Renderer::TriangleCommandBufferManager::init()
@@ -949,12 +1401,17 @@ void Renderer::TriangleCommandBufferManager::init()
 
 void Renderer::TriangleCommandBufferManager::putbackAllBuffers()
 {
+    _currentFrame = (_currentFrame + 1) % FRAMES_IN_FLIGHT;
     _currentBufferIndex = 0;
+
+    // the pools of the other frames are created when they are used for the first time
+    if (_bufferPools[_currentFrame].vertexBuffers.empty())
+        createBuffer();
 }
 
 void Renderer::TriangleCommandBufferManager::prepareNextBuffer()
 {
-    if (_currentBufferIndex < (int)_vertexBufferPool.size() - 1)
+    if (_currentBufferIndex < (int)_bufferPools[_currentFrame].vertexBuffers.size() - 1)
     {
         ++_currentBufferIndex;
         return;
@@ -966,12 +1423,12 @@ void Renderer::TriangleCommandBufferManager::prepareNextBuffer()
 
 backend::Buffer* Renderer::TriangleCommandBufferManager::getVertexBuffer() const
 {
-    return _vertexBufferPool[_currentBufferIndex];
+    return _bufferPools[_currentFrame].vertexBuffers[_currentBufferIndex];
 }
 
 backend::Buffer* Renderer::TriangleCommandBufferManager::getIndexBuffer() const
 {
-    return _indexBufferPool[_currentBufferIndex];
+    return _bufferPools[_currentFrame].indexBuffers[_currentBufferIndex];
 }
 
 void Renderer::TriangleCommandBufferManager::createBuffer()
@@ -1015,8 +1472,8 @@ void Renderer::TriangleCommandBufferManager::createBuffer()
     free(tmpData);
 #endif
 
-    _vertexBufferPool.push_back(vertexBuffer);
-    _indexBufferPool.push_back(indexBuffer);
+    _bufferPools[_currentFrame].vertexBuffers.push_back(vertexBuffer);
+    _bufferPools[_currentFrame].indexBuffers.push_back(indexBuffer);
 }
 
 void Renderer::pushStateBlock()
@@ -28,10 +28,16 @@
 #include <stack>
 #include <array>
 #include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include "platform/CCPlatformMacros.h"
 #include "renderer/CCRenderCommand.h"
+#include "renderer/CCFrameArena.h"
 #include "renderer/backend/Types.h"
+#include "renderer/backend/VertexLayout.h"
 
 /**
  * @addtogroup renderer
@@ -107,8 +113,23 @@ public:
     ssize_t getSubQueueSize(QUEUE_GROUP group) const { return _commands[group].size(); }
     
 protected:
+    /**Entry of the radix sort buffers, the order field of the sort key and its command.*/
+    struct SortEntry
+    {
+        uint32_t key;
+        RenderCommand* command;
+    };
+
+    /**Generate the packed sort key of a command pushed into the given queue group.*/
+    static uint64_t generateSortKey(RenderCommand* command, QUEUE_GROUP group);
+    /**Stable LSD radix sort of a sub queue by the order field of the sort keys.*/
+    void radixSort(std::vector<RenderCommand*>& commands);
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+    /**Scratch buffers reused by radixSort() every frame, to avoid reallocating.*/
+    std::vector<SortEntry> _sortBuffer;
+    std::vector<SortEntry> _sortScratch;
     
     /**Cull state.*/
     bool _isCullEnabled;
@@ -120,6 +141,40 @@ protected:
 
 class GroupCommandManager;
 
+/**
+ The commands added by a thread while it is recording, @see Renderer::beginRecording().
+ They are added to the render queues in the same order by Renderer::replay(), on the thread owning the renderer.
+ */
+class CC_DLL CommandRecording
+{
+public:
+    /** Removes the recorded commands, the storage is kept to be reused by the next recording. */
+    void clear() { _entries.clear(); }
+
+    /** Whether no command was recorded. */
+    bool empty() const { return _entries.empty(); }
+
+protected:
+    friend class Renderer;
+
+    struct Entry
+    {
+        enum class Type
+        {
+            ADD,
+            ADD_TO_QUEUE,
+            PUSH_GROUP,
+            POP_GROUP
+        };
+
+        Type type;
+        RenderCommand* command;
+        int renderQueueID;
+    };
+
+    std::vector<Entry> _entries;
+};
+
 
 /* Class responsible for the rendering in.
 
@@ -137,6 +192,8 @@ public:
     static const int BATCH_TRIAGCOMMAND_RESERVED_SIZE = 64;
     /**Reserved for material id, which means that the command could not be batched.*/
     static const int MATERIAL_ID_DO_NOT_BATCH = 0;
+    /**The max number of MeshCommands merged into one instanced draw.*/
+    static const int MAX_MESH_INSTANCES = 1024;
     /**Constructor.*/
     Renderer();
     /**Destructor.*/
@@ -160,12 +217,44 @@ public:
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
+    /**
+     * Records the commands added by the calling thread into recording instead of the render queues, until endRecording().
+     * addCommand(), pushGroup() and popGroup() can then be invoked by several threads at the same time,
+     * each one recording into its own CommandRecording.
+     */
+    void beginRecording(CommandRecording* recording);
+
+    /** Stops the recording of the calling thread. */
+    void endRecording();
+
+    /** Whether the calling thread is recording, @see beginRecording(). */
+    static bool isRecording();
+
+    /** Adds the recorded commands to the render queues, as if they were added now. */
+    void replay(const CommandRecording& recording);
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
-    /** Cleans all `RenderCommand`s in the queue */
+    /** Cleans all `RenderCommand`s in the queue, and destroys the objects created by createFrameCommand() */
     void clean();
 
+    /**
+     * Create a command which is destroyed when the queued commands are rendered, by the next clean().
+     * Use it for commands created every frame, it doesn't allocate from the heap in steady state.
+     * It can be invoked by the thread owning the renderer, and by the threads recording commands.
+     */
+    template <typename T, typename... Args>
+    T* createFrameCommand(Args&&... args) { return getFrameArena().create<T>(std::forward<Args>(args)...); }
+
+    /**
+     * Allocate memory valid until the next clean(), e.g. for transient vertex or index data of the queued commands.
+     * It can be invoked by the thread owning the renderer, and by the threads recording commands.
+     * @param size Specifies the size in bytes.
+     * @param alignment Specifies the alignment, must be a power of 2.
+     */
+    void* allocateFrameMemory(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) { return getFrameArena().allocate(size, alignment); }
+
     /* returns the number of drawn batches in the last frame */
     ssize_t getDrawnBatches() const { return _drawnBatches; }
     /* RenderCommands (except) TrianglesCommand should update this value */
@@ -174,8 +263,20 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of batches saved by reordering TrianglesCommands in the last frame */
+    ssize_t getSavedBatches() const { return _savedBatches; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _savedBatches = 0; }
+
+    /**
+     Enable/disable reordering of queued TrianglesCommands before batching.
+     Commands are grouped by material as long as no command with another material between them overlaps
+     in screen space, so the drawn result doesn't change. Disabled by default.
+     @param enabled true to reorder commands to save draw calls.
+     */
+    void setBatchReorderEnabled(bool enabled) { _isBatchReorderEnabled = enabled; }
+    /** Get whether TrianglesCommands are reordered before batching. */
+    bool isBatchReorderEnabled() const { return _isBatchReorderEnabled; }
 
     /**
      Set render targets. If not set, will use default render targets. It will effect all commands.
@@ -412,6 +513,9 @@ protected:
     /**
      * Create and reuse vertex and index buffer for triangleCommand.
      * When queued vertex or index count exceed the limited value, a new vertex or index buffer will be created.
+     * Each frame uses its own buffers, which are written again only after FRAMES_IN_FLIGHT frames,
+     * so updating them doesn't wait for the GPU to finish reading the previous frames.
+     * The renderer orphans a buffer before its first update of the frame, in case the GPU is more frames behind.
      */
     class TriangleCommandBufferManager
     {
@@ -425,8 +529,8 @@ protected:
         void init();
 
         /**
-         * Reset avalable buffer index to zero.
-         * That means when get vertex buffer or index buffer, the earliest created buffer object in the cache will be returned.
+         * Switch to the buffers of the next frame and reset avalable buffer index to zero.
+         * That means when get vertex buffer or index buffer, the earliest created buffer object of the frame will be returned.
          */
         void putbackAllBuffers();
 
@@ -439,17 +543,33 @@ protected:
         backend::Buffer* getIndexBuffer() const; ///< Get the index buffer.
 
     private:
+#ifdef CC_USE_METAL
+        // BufferMTL is triple buffered by itself.
+        static const int FRAMES_IN_FLIGHT = 1;
+#else
+        static const int FRAMES_IN_FLIGHT = 3;
+#endif
+
+        struct BufferPool
+        {
+            std::vector<backend::Buffer*> vertexBuffers;
+            std::vector<backend::Buffer*> indexBuffers;
+        };
+
         void createBuffer();
 
+        int _currentFrame = 0;
         int _currentBufferIndex = 0;
-        std::vector<backend::Buffer*> _vertexBufferPool;
-        std::vector<backend::Buffer*> _indexBufferPool;
+        BufferPool _bufferPools[FRAMES_IN_FLIGHT];
     };
 
     inline GroupCommandManager * getGroupCommandManager() const { return _groupCommandManager; }
     void drawBatchedTriangles();
+    void reorderTrianglesCommands();
     void drawCustomCommand(RenderCommand* command);
     void drawMeshCommand(RenderCommand* command);
+    void drawInstancedMeshCommands();
+    const backend::VertexLayout& getInstanceLayout(backend::Program* program);
     void captureScreen(RenderCommand* command);
 
     void beginFrame(); /// Indicate the begining of a frame
@@ -490,12 +610,24 @@ protected:
     CullMode _cullMode  = CullMode::NONE;
     Winding _winding    = Winding::COUNTER_CLOCK_WISE; //default front face is CCW in GL
 
-    std::stack<int> _commandGroupStack;
+    std::stack<int, std::vector<int>> _commandGroupStack;
     
     std::vector<RenderQueue> _renderGroups;
 
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
+    // MeshCommands with an instanced program, they share buffers and program state so can be drawn at once
+    std::vector<MeshCommand*> _queuedMeshCommands;
+    // per-instance attributes of instanced MeshCommands
+    struct MeshInstanceData
+    {
+        Mat4 mvp;
+        Vec4 color;
+    };
+    backend::Buffer* _instanceBuffer = nullptr;
+    bool _instancingSupported = false;
+    std::unordered_map<backend::Program*, backend::VertexLayout> _instanceLayouts;
+
     //for TrianglesCommand
     V3F_C4B_T2F _verts[VBO_SIZE];
     unsigned short _indices[INDEX_VBO_SIZE];
@@ -514,6 +646,22 @@ protected:
         unsigned int indicesToDraw = 0;
         unsigned int offset = 0;
     };
+    // Internal structure used to group queued TrianglesCommands by material
+    struct TriBatchToReorder
+    {
+        uint32_t materialID = 0;
+        bool batchable = true;
+        // screen space bounds of all the commands of the batch
+        float minX = 0, minY = 0, maxX = 0, maxY = 0;
+        // first and last command of the batch, linked by _reorderNextCommand
+        int head = -1;
+        int tail = -1;
+    };
+    std::vector<TriBatchToReorder> _triBatchesToReorder;
+    std::vector<int> _reorderNextCommand;
+    std::vector<TrianglesCommand*> _reorderedTriangleCommands;
+    bool _isBatchReorderEnabled = false;
+
     // capacity of the array of TriBatches
     int _triBatchesToDrawCapacity = 500;
     // the TriBatches
@@ -529,6 +677,7 @@ protected:
     // stats
     unsigned int _drawnBatches = 0;
     unsigned int _drawnVertices = 0;
+    unsigned int _savedBatches = 0;
     //the flag for checking whether renderer is rendering
     bool _isRendering = false;
     bool _isDepthTestFor2D = false;
@@ -558,7 +707,17 @@ protected:
         backend::CullMode  cullMode = backend::CullMode::NONE;
     };
 
-    std::deque<StateBlock> _stateBlockStack;
+    std::vector<StateBlock> _stateBlockStack;
+
+    // Arena of the calling thread: the one of the renderer for its own thread,
+    // the threads recording commands in parallel get one each.
+    FrameArena& getFrameArena();
+
+    // Storage of the objects living until the end of the frame, reset by clean().
+    FrameArena _frameArena;
+    std::thread::id _threadId;
+    std::vector<std::unique_ptr<FrameArena>> _threadFrameArenas;
+    std::mutex _threadFrameArenasMutex;
 };
 
 NS_CC_END
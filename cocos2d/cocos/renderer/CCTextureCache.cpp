@@ -77,6 +77,7 @@ TextureCache::~TextureCache()
     for (auto& texture : _textures)
         texture.second->release();
 
+    CC_SAFE_DELETE(_dynamicAtlas);
     CC_SAFE_DELETE(_loadingThread);
 }
 
@@ -460,6 +461,52 @@ void TextureCache::parseNinePatchImage(cocos2d::Image *image, cocos2d::Texture2D
 
 }
 
+void TextureCache::packImage(Image* image, const std::string& fullpath)
+{
+    if (_dynamicAtlas == nullptr)
+        return;
+
+    // 9-patch images keep their own texture, the cap insets are stored in it.
+    if (NinePatchImageParser::isNinePatchImage(fullpath) || _dynamicAtlas->addImage(fullpath, image) == nullptr)
+        _unpackedImages.insert(fullpath);
+    else
+        _unpackedImages.erase(fullpath);
+}
+
+void TextureCache::setDynamicAtlasEnabled(bool enabled)
+{
+    if (enabled == isDynamicAtlasEnabled())
+        return;
+
+    if (enabled)
+        _dynamicAtlas = new (std::nothrow) DynamicAtlas();
+    else
+        CC_SAFE_DELETE(_dynamicAtlas);
+    _unpackedImages.clear();
+}
+
+const DynamicAtlas::Region* TextureCache::addImageInDynamicAtlas(const std::string& path)
+{
+    if (_dynamicAtlas == nullptr)
+        return nullptr;
+
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(path);
+    if (fullpath.empty() || _unpackedImages.find(fullpath) != _unpackedImages.end())
+        return nullptr;
+
+    auto region = _dynamicAtlas->getRegion(fullpath);
+    if (region)
+        return region;
+
+    // only the images of sprites and sprite frames are packed, they are drawn from the page without their own texture
+    Image image;
+    if (image.initWithImageFile(fullpath))
+        packImage(&image, fullpath);
+    else
+        _unpackedImages.insert(fullpath);
+    return _dynamicAtlas->getRegion(fullpath);
+}
+
 Texture2D* TextureCache::addImage(Image *image, const std::string &key)
 {
     CCASSERT(image != nullptr, "TextureCache: image MUST not be nil");
@@ -551,6 +598,10 @@ void TextureCache::removeAllTextures()
         texture.second->release();
     }
     _textures.clear();
+
+    if (_dynamicAtlas)
+        _dynamicAtlas->removeAllImages();
+    _unpackedImages.clear();
 }
 
 void TextureCache::removeUnusedTextures()
@@ -568,6 +619,9 @@ void TextureCache::removeUnusedTextures()
         }
 
     }
+
+    if (_dynamicAtlas)
+        _dynamicAtlas->removeUnusedPages();
 }
 
 void TextureCache::removeTexture(Texture2D* texture)
@@ -579,6 +633,9 @@ void TextureCache::removeTexture(Texture2D* texture)
 
     for (auto it = _textures.cbegin(); it != _textures.cend(); /* nothing */) {
         if (it->second == texture) {
+            if (_dynamicAtlas)
+                _dynamicAtlas->removeImage(it->first);
+            _unpackedImages.erase(it->first);
             it->second->release();
             it = _textures.erase(it);
             break;
@@ -599,6 +656,9 @@ void TextureCache::removeTextureForKey(const std::string &textureKeyName)
     }
 
     if (it != _textures.end()) {
+        if (_dynamicAtlas)
+            _dynamicAtlas->removeImage(it->first);
+        _unpackedImages.erase(it->first);
         it->second->release();
         _textures.erase(it);
     }
@@ -676,6 +736,18 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    if (_dynamicAtlas)
+    {
+        auto pageSize = _dynamicAtlas->getPageSize();
+        snprintf(buftmp, sizeof(buftmp) - 1, "DynamicAtlas: %d images in %d pages of %d x %d => %lu KB\n",
+            _dynamicAtlas->getImageCount(),
+            _dynamicAtlas->getPageCount(),
+            pageSize,
+            pageSize,
+            (long)_dynamicAtlas->getPageCount() * pageSize * pageSize * 4 / 1024);
+        buffer += buftmp;
+    }
+
     return buffer;
 }
 
@@ -700,6 +772,9 @@ void TextureCache::renameTextureWithKey(const std::string& srcName, const std::s
             if (ret)
             {
                 tex->initWithImage(image);
+                if (_dynamicAtlas)
+                    _dynamicAtlas->removeImage(it->first);
+                _unpackedImages.erase(it->first);
                 _textures.emplace(fullpath, tex);
                 _textures.erase(it);
             }
@@ -36,9 +36,11 @@ THE SOFTWARE.
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <unordered_set>
 
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCDynamicAtlas.h"
 #include "platform/CCImage.h"
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -197,11 +199,34 @@ public:
     */
     void renameTextureWithKey(const std::string& srcName, const std::string& dstName);
 
+    /** Enable or disable the dynamic atlas, it is disabled by default.
+    * When it is enabled, small images of sprites and sprite frames created from files are packed into the pages
+    * of the atlas instead of their own textures, so that they can be drawn in one batch.
+    * Images loaded by addImage() are not packed.
+    * Disabling it drops the atlas, sprites already using its pages aren't changed.
+    * @see DynamicAtlas
+    */
+    void setDynamicAtlasEnabled(bool enabled);
+
+    /** Whether the dynamic atlas is enabled. */
+    bool isDynamicAtlasEnabled() const { return _dynamicAtlas != nullptr; }
+
+    /** Get the dynamic atlas, nullptr if it is disabled. */
+    DynamicAtlas* getDynamicAtlas() const { return _dynamicAtlas; }
+
+    /** Loads an image file into the dynamic atlas, and returns the region of the image in the atlas.
+    * The image gets no texture of its own, addImage() loads it if it can't be packed.
+    * @param filepath The file path.
+    * @return The region, or nullptr if the dynamic atlas is disabled or the image can't be packed.
+    */
+    const DynamicAtlas::Region* addImageInDynamicAtlas(const std::string& filepath);
+
 
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
+    void packImage(Image* image, const std::string& fullpath);
 public:
 protected:
     struct AsyncStruct;
@@ -223,6 +248,10 @@ protected:
 
     std::unordered_map<std::string, Texture2D*> _textures;
 
+    DynamicAtlas* _dynamicAtlas = nullptr;
+    // Images loaded while the dynamic atlas is enabled which can't be packed.
+    std::unordered_set<std::string> _unpackedImages;
+
     static std::string s_etc1AlphaFileSuffix;
 };
 
@@ -48,16 +48,20 @@ void TrianglesCommand::init(float globalOrder, Texture2D* texture, const BlendFu
     }
     _mv = mv;
 
-    if (_programType != _pipelineDescriptor.programState->getProgram()->getProgramType() ||
+    auto programState = _pipelineDescriptor.programState;
+    auto programStateID = programState->getMaterialID();
+    if (_programType != programState->getProgram()->getProgramType() ||
         _texture != texture->getBackendTexture() ||
-        _blendType != blendType)
+        _blendType != blendType ||
+        _programStateID != programStateID)
     {
-        _programType = _pipelineDescriptor.programState->getProgram()->getProgramType();
+        _programType = programState->getProgram()->getProgramType();
         _texture = texture->getBackendTexture();
         _blendType = blendType;
+        _programStateID = programStateID;
         
-        //since it would be too expensive to check the uniforms, simplify enable batching for built-in program.
-        if(_programType == backend::ProgramType::CUSTOM_PROGRAM)
+        //program states with equal uniforms share the material id, but callback uniforms can't be compared.
+        if(_programType == backend::ProgramType::CUSTOM_PROGRAM && !programState->getCallbackUniforms().empty())
             setSkipBatching(true);
         
         //TODO: minggo set it in Node?
@@ -89,6 +93,7 @@ void TrianglesCommand::generateMaterialID()
         backend::ProgramType programType;
         backend::BlendFactor src;
         backend::BlendFactor dst;
+        uint32_t programStateID;
     }hashMe;
 
     // NOTE: Initialize hashMe struct to make the value of padding bytes be filled with zero.
@@ -100,6 +105,7 @@ void TrianglesCommand::generateMaterialID()
     hashMe.src = _blendType.src;
     hashMe.dst = _blendType.dst;
     hashMe.programType = _programType;
+    hashMe.programStateID = _programStateID;
     _materialID = XXH32((const void*)&hashMe, sizeof(hashMe), 0);
 }
 
@@ -103,7 +103,7 @@ public:
     void updateMaterialID();
   
 protected:
-    /**Generate the material ID by textureID, glProgramState, and blend function.*/
+    /**Generate the material ID by textureID, program type, material ID of the program state, and blend function.*/
     void generateMaterialID();
     
     /**Generated material id.*/
@@ -120,6 +120,7 @@ protected:
     BlendFunc _blendType = BlendFunc::DISABLE;
     backend::ProgramType _programType = backend::ProgramType::CUSTOM_PROGRAM;
     backend::TextureBackend* _texture = nullptr;
+    uint32_t _programStateID = 0;
 };
 
 NS_CC_END
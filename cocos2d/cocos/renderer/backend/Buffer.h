@@ -70,12 +70,38 @@ public:
      */
     virtual void usingDefaultStoredData(bool needDefaultStoredData) = 0;
 
+    /**
+     * Detach the data store from the buffer, so that the following updates don't wait for the GPU to finish reading it.
+     * The contents are undefined until they are updated again, the size doesn't change.
+     */
+    virtual void orphanData() = 0;
+
+    /**
+     * Read back the contents of the buffer. It stalls the pipeline, it is meant for tools such as FrameCapture.
+     * @param data Specifies a pointer to the memory the contents are copied to.
+     * @param size Specifies the size in bytes of the memory.
+     * @return The number of bytes read, 0 if the backend can't read the buffer.
+     */
+    virtual std::size_t getData(void* data, std::size_t size) const = 0;
+
     /**
      * Get buffer size in bytes.
      * @return The buffer size in bytes.
      */
     std::size_t getSize() const { return _size; }
 
+    /**
+     * Get buffer type, BufferType::VERTEX or BufferType::INDEX.
+     * @return The buffer type.
+     */
+    BufferType getType() const { return _type; }
+
+    /**
+     * Get buffer usage, BufferUsage::STATIC or BufferUsage::DYNAMIC.
+     * @return The buffer usage.
+     */
+    BufferUsage getUsage() const { return _usage; }
+
 protected:
     /**
      * @param size Specifies the size in bytes of the buffer object's new data store.
@@ -23,6 +23,7 @@
  ****************************************************************************/
  
 #include "CommandBuffer.h"
+#include "base/ccMacros.h"
 
 CC_BACKEND_BEGIN
 
@@ -37,4 +38,28 @@ void CommandBuffer::setStencilReferenceValue(unsigned int frontRef, unsigned int
     _stencilReferenceValueBack = backRef;
 }
 
+void CommandBuffer::setInstanceBuffer(Buffer* buffer, const VertexLayout& layout, const void* data)
+{
+    _instanceLayout = layout;
+    _instanceData = static_cast<const char*>(data);
+}
+
+void CommandBuffer::drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount)
+{
+    CCASSERT(_instanceData, "Per-instance attributes in client memory are needed without instancing support.");
+    if (!_instanceData || !_instanceLayout.isValid())
+        return;
+
+    for (std::size_t i = 0; i < instanceCount; ++i)
+    {
+        setInstanceAttributes(_instanceLayout, _instanceData + i * _instanceLayout.getStride());
+        drawElements(primitiveType, indexType, count, offset);
+    }
+}
+
+void CommandBuffer::setInstanceAttributes(const VertexLayout& layout, const char* data)
+{
+    CCASSERT(false, "Constant vertex attributes are not supported by this backend.");
+}
+
 CC_BACKEND_END
@@ -134,6 +134,28 @@ public:
      * @see `drawArrays(PrimitiveType primitiveType, unsigned int start,  unsigned int count)`
     */
     virtual void drawElements(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset) = 0;
+
+    /**
+     * Set a buffer holding per-instance attributes, used by the next instanced draw.
+     * @param buffer The buffer the device will read per-instance attributes from.
+     * @param layout Layout of the per-instance attributes. Attribute index is the attribute location of current program.
+     * @param data The same attributes in client memory, it should be valid until the instanced draw.
+     * Devices without FeatureType::INSTANCING draw the instances one at a time with it, can be nullptr otherwise.
+     * @see `drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount)`
+     */
+    virtual void setInstanceBuffer(Buffer* buffer, const VertexLayout& layout, const void* data);
+
+    /**
+     * Draw several instances of primitives with an index list.
+     * The default implementation draws the instances one at a time, see `setInstanceAttributes()`.
+     * @param primitiveType The type of primitives that elements are assembled into.
+     * @param indexType The type if indexes, either 16 bit integer or 32 bit integer.
+     * @param count The number of indexes to read from the index buffer for each instance.
+     * @param offset Byte offset within indexBuffer to start reading indexes from.
+     * @param instanceCount The number of instances to draw.
+     * @see `setInstanceBuffer(Buffer* buffer, const VertexLayout& layout, const void* data)`
+     */
+    virtual void drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount);
     
     /**
      * Do some resources release.
@@ -186,9 +208,18 @@ public:
 
 protected:
     virtual ~CommandBuffer() = default;
+
+    /**
+     * Set the per-instance attributes of one instance as constant vertex attributes, used by the default `drawElementsInstanced()`.
+     * @param layout Layout of the per-instance attributes.
+     * @param data Attributes of the instance.
+     */
+    virtual void setInstanceAttributes(const VertexLayout& layout, const char* data);
     
     unsigned int _stencilReferenceValueFront = 0; ///< front stencil reference value.
     unsigned int _stencilReferenceValueBack = 0; ///< back stencil reference value.
+    VertexLayout _instanceLayout; ///< layout of the per-instance attributes.
+    const char* _instanceData = nullptr; ///< per-instance attributes in client memory.
 };
 
 // end of _backend group
@@ -70,6 +70,13 @@ struct DepthStencilDescriptor
  */
 class DepthStencilState : public cocos2d::Ref
 {
+public:
+    /**
+     * Get depth and stencil descriptor.
+     * @return Depth and stencil descriptor.
+     */
+    inline const DepthStencilDescriptor& getDepthStencilInfo() const { return _depthStencilInfo; }
+
 protected:
     /**
      * @param descriptor Specifies depth and stencil descriptor.
@@ -28,4 +28,13 @@ CC_BACKEND_BEGIN
 
 Device* Device::_instance = nullptr;
 
+void Device::setInstance(Device* device)
+{
+    if (_instance == device)
+        return;
+
+    delete _instance;
+    _instance = device;
+}
+
 CC_BACKEND_END
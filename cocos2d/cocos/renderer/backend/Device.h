@@ -64,6 +64,13 @@ public:
      * Returns a shared instance of the device. 
      */
     static Device* getInstance();
+
+    /**
+     * Replace the shared instance of the device, i.e. by a DeviceNull to run the renderer without GPU.
+     * The previous instance is deleted. It must be invoked before any backend resource is created.
+     * @param device Specifies the new device, the ownership is transferred.
+     */
+    static void setInstance(Device* device);
     
     virtual ~Device() = default;
     
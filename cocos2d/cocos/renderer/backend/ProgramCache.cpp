@@ -126,6 +126,19 @@ bool ProgramCache::init()
     addProgram(ProgramType::TERRAIN_3D);
     addProgram(ProgramType::PARTICLE_TEXTURE_3D);
     addProgram(ProgramType::PARTICLE_COLOR_3D);
+
+    // instanced programs can only be drawn by drawElementsInstanced,
+    // OpenGL draws the instances one at a time when instancing is not supported
+#ifdef CC_USE_METAL
+    bool instancingSupported = Device::getInstance()->getDeviceInfo()->checkForFeatureSupported(FeatureType::INSTANCING);
+#else
+    bool instancingSupported = true;
+#endif
+    if (instancingSupported)
+    {
+        addProgram(ProgramType::POSITION_TEXTURE_3D_INSTANCED);
+        addProgram(ProgramType::POSITION_3D_INSTANCED);
+    }
     return true;
 }
 
@@ -240,6 +253,12 @@ void ProgramCache::addProgram(ProgramType type)
         case ProgramType::PARTICLE_COLOR_3D:
             program = backend::Device::getInstance()->newProgram(CC3D_particle_vert, CC3D_particleColor_frag);
             break;
+        case ProgramType::POSITION_TEXTURE_3D_INSTANCED:
+            program = backend::Device::getInstance()->newProgram(CC3D_positionTextureInstanced_vert, CC3D_colorTextureInstanced_frag);
+            break;
+        case ProgramType::POSITION_3D_INSTANCED:
+            program = backend::Device::getInstance()->newProgram(CC3D_positionTextureInstanced_vert, CC3D_colorInstanced_frag);
+            break;
         default:
             CCASSERT(false, "Not built-in program type.");
             break;
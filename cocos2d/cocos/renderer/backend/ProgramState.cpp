@@ -30,6 +30,7 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
 #include "base/CCDirector.h"
+#include "xxhash.h"
 
 #include <algorithm>
 
@@ -80,6 +81,42 @@ namespace {
         dst[4] = src[3]; dst[5] = src[4]; dst[6] = src[5];
         dst[8] = src[6]; dst[9] = src[7]; dst[10] = src[8];
     }
+
+    bool isEqual(const TextureInfo& a, const TextureInfo& b)
+    {
+        return a.slot == b.slot && a.textures == b.textures
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+            && a.location == b.location
+#endif
+            ;
+    }
+
+    bool isEqual(const std::unordered_map<int, TextureInfo>& a, const std::unordered_map<int, TextureInfo>& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (const auto& iter : a)
+        {
+            auto other = b.find(iter.first);
+            if (other == b.end() || !isEqual(iter.second, other->second))
+                return false;
+        }
+        return true;
+    }
+
+    uint32_t computeTextureInfosHash(const std::unordered_map<int, TextureInfo>& textureInfos)
+    {
+        // Sum the hashes of the entries, the iteration order differs between equal maps.
+        uint32_t hash = 0;
+        for (const auto& iter : textureInfos)
+        {
+            auto seed = XXH32(iter.second.slot.data(), iter.second.slot.size() * sizeof(uint32_t), iter.first);
+            hash += XXH32(iter.second.textures.data(), iter.second.textures.size() * sizeof(backend::TextureBackend*), seed);
+        }
+        return hash;
+    }
+
+    uint32_t s_nextMaterialID = 1;
 }
 
 //static field
@@ -155,6 +192,70 @@ TextureInfo& TextureInfo::operator=(const TextureInfo& rhs)
     return *this;
 }
 
+ProgramState::SharedData::SharedData(const SharedData& other)
+: program(other.program)
+, vertexUniformBuffer(other.vertexUniformBuffer)
+, fragmentUniformBuffer(other.fragmentUniformBuffer)
+, vertexTextureInfos(other.vertexTextureInfos)
+, fragmentTextureInfos(other.fragmentTextureInfos)
+{
+}
+
+ProgramState::SharedData::~SharedData()
+{
+    unshare();
+}
+
+void ProgramState::SharedData::unshare()
+{
+    std::lock_guard<std::recursive_mutex> lock(getSharedDatasMutex());
+    if (id == 0)
+        return;
+
+    auto& sharedDatas = getSharedDatas();
+    auto range = sharedDatas.equal_range(hash);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (iter->second == this)
+        {
+            sharedDatas.erase(iter);
+            break;
+        }
+    }
+    id = 0;
+    self.reset();
+}
+
+bool ProgramState::SharedData::operator==(const SharedData& other) const
+{
+    return program == other.program &&
+           vertexUniformBuffer == other.vertexUniformBuffer &&
+           fragmentUniformBuffer == other.fragmentUniformBuffer &&
+           isEqual(vertexTextureInfos, other.vertexTextureInfos) &&
+           isEqual(fragmentTextureInfos, other.fragmentTextureInfos);
+}
+
+uint32_t ProgramState::SharedData::computeHash() const
+{
+    auto value = XXH32(&program, sizeof(program), 0);
+    value = XXH32(vertexUniformBuffer.data(), vertexUniformBuffer.size(), value);
+    value = XXH32(fragmentUniformBuffer.data(), fragmentUniformBuffer.size(), value);
+    return value + computeTextureInfosHash(vertexTextureInfos) * 31 + computeTextureInfosHash(fragmentTextureInfos);
+}
+
+std::unordered_multimap<uint32_t, ProgramState::SharedData*>& ProgramState::getSharedDatas()
+{
+    // Never deleted, program states may outlive the static objects at exit.
+    static auto sharedDatas = new std::unordered_multimap<uint32_t, SharedData*>();
+    return *sharedDatas;
+}
+
+std::recursive_mutex& ProgramState::getSharedDatasMutex()
+{
+    static auto mutex = new std::recursive_mutex();
+    return *mutex;
+}
+
 ProgramState::ProgramState(Program* program)
 {
     init(program);
@@ -164,14 +265,14 @@ bool ProgramState::init(Program* program)
 {
     CC_SAFE_RETAIN(program);
     _program = program;
-    _vertexUniformBufferSize = _program->getUniformBufferSize(ShaderStage::VERTEX);
-    _vertexUniformBuffer = new char[_vertexUniformBufferSize];
-    memset(_vertexUniformBuffer, 0, _vertexUniformBufferSize);
+    _data = std::make_shared<SharedData>();
+    _data->program = program;
+    _data->vertexUniformBuffer.resize(_program->getUniformBufferSize(ShaderStage::VERTEX), 0);
 #ifdef CC_USE_METAL
-    _fragmentUniformBufferSize = _program->getUniformBufferSize(ShaderStage::FRAGMENT);
-    _fragmentUniformBuffer = new char[_fragmentUniformBufferSize];
-    memset(_fragmentUniformBuffer, 0, _fragmentUniformBufferSize);
+    _data->fragmentUniformBuffer.resize(_program->getUniformBufferSize(ShaderStage::FRAGMENT), 0);
 #endif
+    //new program states of the same program share the zero filled buffers
+    shareData();
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     _backToForegroundListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom*){
@@ -188,6 +289,12 @@ void ProgramState::resetUniforms()
     if(_program == nullptr)
         return;
 
+    if(_data->vertexTextureInfos.empty())
+        return;
+
+    //the mapping only depends on the program, it is updated in place so that shared data stays shared
+    std::lock_guard<std::recursive_mutex> lock(getSharedDatasMutex());
+    auto& vertexTextureInfos = _data->vertexTextureInfos;
     const auto& uniformLocation = _program->getAllUniformsLocation();
     for(const auto& uniform : uniformLocation)
     {
@@ -195,9 +302,9 @@ void ProgramState::resetUniforms()
         auto mappedLocation = _program->getMappedLocation(location);
 
         //check if current location had been set before
-        if(_vertexTextureInfos.find(location) != _vertexTextureInfos.end())
+        if(vertexTextureInfos.find(location) != vertexTextureInfos.end())
         {
-            _vertexTextureInfos[location].location = mappedLocation;
+            vertexTextureInfos[location].location = mappedLocation;
         }
     }
 #endif
@@ -209,9 +316,8 @@ ProgramState::ProgramState()
 
 ProgramState::~ProgramState()
 {
+    _data.reset();
     CC_SAFE_RELEASE(_program);
-    CC_SAFE_DELETE_ARRAY(_vertexUniformBuffer);
-    CC_SAFE_DELETE_ARRAY(_fragmentUniformBuffer);
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     Director::getInstance()->getEventDispatcher()->removeEventListener(_backToForegroundListener);
@@ -222,17 +328,8 @@ ProgramState *ProgramState::clone() const
 {
     ProgramState *cp = new ProgramState();
     cp->_program = _program;
-    cp->_vertexUniformBufferSize = _vertexUniformBufferSize;
-    cp->_fragmentUniformBufferSize = _fragmentUniformBufferSize;
-    cp->_vertexTextureInfos = _vertexTextureInfos;
-    cp->_fragmentTextureInfos = _fragmentTextureInfos;
-    cp->_vertexUniformBuffer = new char[_vertexUniformBufferSize];
-    memcpy(cp->_vertexUniformBuffer, _vertexUniformBuffer, _vertexUniformBufferSize);
+    cp->_data = _data;
     cp->_vertexLayout = _vertexLayout;
-#ifdef CC_USE_METAL
-    cp->_fragmentUniformBuffer = new char[_fragmentUniformBufferSize];
-    memcpy(cp->_fragmentUniformBuffer, _fragmentUniformBuffer, _fragmentUniformBufferSize);
-#endif
     CC_SAFE_RETAIN(cp->_program);
 
     return cp;
@@ -351,14 +448,14 @@ void ProgramState::setVertexUniform(int location, const void* data, std::size_t
     const auto& uniformInfo = _program->getActiveUniformInfo(ShaderStage::VERTEX, location);
     if(uniformInfo.needConvert)
     {
-        convertAndCopyUniformData(uniformInfo, data, size, _vertexUniformBuffer);
+        convertAndCopyUniformData(uniformInfo, data, size, getMutableData()->vertexUniformBuffer.data());
     }
     else
     {
-        memcpy(_vertexUniformBuffer + location, data, size);
+        updateUniformBuffer(ShaderStage::VERTEX, location, data, size);
     }
 #else
-    memcpy(_vertexUniformBuffer + offset, data, size);
+    updateUniformBuffer(ShaderStage::VERTEX, offset, data, size);
 #endif
 }
 
@@ -372,28 +469,75 @@ void ProgramState::setFragmentUniform(int location, const void* data, std::size_
     const auto& uniformInfo = _program->getActiveUniformInfo(ShaderStage::FRAGMENT, location);
     if(uniformInfo.needConvert)
     {
-        convertAndCopyUniformData(uniformInfo, data, size, _fragmentUniformBuffer);
+        convertAndCopyUniformData(uniformInfo, data, size, getMutableData()->fragmentUniformBuffer.data());
     }
     else
     {
-        memcpy(_fragmentUniformBuffer + location, data, size);
+        updateUniformBuffer(ShaderStage::FRAGMENT, location, data, size);
     }
 #endif
 }
 
+void ProgramState::updateUniformBuffer(ShaderStage stage, std::size_t offset, const void* data, std::size_t size)
+{
+    const auto& buffer = stage == ShaderStage::VERTEX ? _data->vertexUniformBuffer : _data->fragmentUniformBuffer;
+    if (memcmp(buffer.data() + offset, data, size) == 0)
+        return;
+
+    std::lock_guard<std::recursive_mutex> lock(getSharedDatasMutex());
+    if (reuseChangedData(stage, offset, data, size))
+        return;
+
+    //program states sharing the data often make the same change, i.e. a new projection, the first one links the result
+    std::shared_ptr<SharedData> previous = _data->id != 0 && _data.use_count() > 1 ? _data : nullptr;
+    auto mutableData = getMutableData();
+    auto& mutableBuffer = stage == ShaderStage::VERTEX ? mutableData->vertexUniformBuffer : mutableData->fragmentUniformBuffer;
+    memcpy(mutableBuffer.data() + offset, data, size);
+    _changedFrom = previous;
+}
+
+bool ProgramState::reuseChangedData(ShaderStage stage, std::size_t offset, const void* data, std::size_t size)
+{
+    if (_data->id == 0)
+        return false;
+
+    //the changed data is shared, so it is not changed anymore, it must equal the data with this change only
+    auto changed = _data->changed.lock();
+    if (!changed || changed->id == 0 || changed->program != _data->program)
+        return false;
+
+    bool isVertex = stage == ShaderStage::VERTEX;
+    const auto& buffer = isVertex ? _data->vertexUniformBuffer : _data->fragmentUniformBuffer;
+    const auto& changedBuffer = isVertex ? changed->vertexUniformBuffer : changed->fragmentUniformBuffer;
+    const auto& otherBuffer = isVertex ? _data->fragmentUniformBuffer : _data->vertexUniformBuffer;
+    const auto& changedOtherBuffer = isVertex ? changed->fragmentUniformBuffer : changed->vertexUniformBuffer;
+    std::size_t end = offset + size;
+    if (changedBuffer.size() != buffer.size() || changedOtherBuffer != otherBuffer ||
+        memcmp(changedBuffer.data() + offset, data, size) != 0 ||
+        memcmp(changedBuffer.data(), buffer.data(), offset) != 0 ||
+        memcmp(changedBuffer.data() + end, buffer.data() + end, buffer.size() - end) != 0 ||
+        !isEqual(changed->vertexTextureInfos, _data->vertexTextureInfos) ||
+        !isEqual(changed->fragmentTextureInfos, _data->fragmentTextureInfos))
+        return false;
+
+    _data = changed;
+    _changedFrom.reset();
+    return true;
+}
+
 void ProgramState::setTexture(const backend::UniformLocation& uniformLocation, uint32_t slot, backend::TextureBackend* texture)
 {
     switch (uniformLocation.shaderStage)
     {
         case backend::ShaderStage::VERTEX:
-            setTexture(uniformLocation.location[0], slot, texture, _vertexTextureInfos);
+            setTexture(uniformLocation.location[0], slot, texture, ShaderStage::VERTEX);
             break;
         case backend::ShaderStage::FRAGMENT:
-            setTexture(uniformLocation.location[1], slot, texture, _fragmentTextureInfos);
+            setTexture(uniformLocation.location[1], slot, texture, ShaderStage::FRAGMENT);
             break;
         case backend::ShaderStage::VERTEX_AND_FRAGMENT:
-            setTexture(uniformLocation.location[0], slot, texture, _vertexTextureInfos);
-            setTexture(uniformLocation.location[1], slot, texture, _fragmentTextureInfos);
+            setTexture(uniformLocation.location[0], slot, texture, ShaderStage::VERTEX);
+            setTexture(uniformLocation.location[1], slot, texture, ShaderStage::FRAGMENT);
             break;
         default:
             break;
@@ -405,38 +549,42 @@ void ProgramState::setTextureArray(const backend::UniformLocation& uniformLocati
     switch (uniformLocation.shaderStage)
     {
         case backend::ShaderStage::VERTEX:
-            setTextureArray(uniformLocation.location[0], slots, textures, _vertexTextureInfos);
+            setTextureArray(uniformLocation.location[0], slots, textures, ShaderStage::VERTEX);
             break;
         case backend::ShaderStage::FRAGMENT:
-            setTextureArray(uniformLocation.location[1], slots, textures, _fragmentTextureInfos);
+            setTextureArray(uniformLocation.location[1], slots, textures, ShaderStage::FRAGMENT);
             break;
         case backend::ShaderStage::VERTEX_AND_FRAGMENT:
-            setTextureArray(uniformLocation.location[0], slots, textures, _vertexTextureInfos);
-            setTextureArray(uniformLocation.location[1], slots, textures, _fragmentTextureInfos);
+            setTextureArray(uniformLocation.location[0], slots, textures, ShaderStage::VERTEX);
+            setTextureArray(uniformLocation.location[1], slots, textures, ShaderStage::FRAGMENT);
             break;
         default:
             break;
     }
 }
 
-void ProgramState::setTexture(int location, uint32_t slot, backend::TextureBackend* texture, std::unordered_map<int, TextureInfo>& textureInfo)
+void ProgramState::setTexture(int location, uint32_t slot, backend::TextureBackend* texture, ShaderStage stage)
 {
     if(location < 0)
         return;
-    TextureInfo& info = textureInfo[location];
-    info.releaseTextures();
-    info.slot = {slot};
-    info.textures = {texture};
-    info.retainTextures();
-#if CC_ENABLE_CACHE_TEXTURE_DATA
-    info.location = location;
-#endif
+    setTextureArray(location, {slot}, {texture}, stage);
 }
 
-void ProgramState::setTextureArray(int location, const std::vector<uint32_t>& slots, const std::vector<backend::TextureBackend*> textures, std::unordered_map<int, TextureInfo>& textureInfo)
+void ProgramState::setTextureArray(int location, const std::vector<uint32_t>& slots, const std::vector<backend::TextureBackend*> textures, ShaderStage stage)
 {
     assert(slots.size() == textures.size());
-    TextureInfo& info = textureInfo[location];
+    const auto& textureInfos = stage == ShaderStage::VERTEX ? _data->vertexTextureInfos : _data->fragmentTextureInfos;
+    auto iter = textureInfos.find(location);
+    if(iter != textureInfos.end() && iter->second.slot == slots && iter->second.textures == textures
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+       && iter->second.location == location
+#endif
+       )
+        return;
+
+    auto mutableData = getMutableData();
+    auto& mutableTextureInfos = stage == ShaderStage::VERTEX ? mutableData->vertexTextureInfos : mutableData->fragmentTextureInfos;
+    TextureInfo& info = mutableTextureInfos[location];
     info.releaseTextures();
     info.slot = slots;
     info.textures = textures;
@@ -475,14 +623,72 @@ ProgramState::AutoBindingResolver::~AutoBindingResolver()
 
 void ProgramState::getVertexUniformBuffer(char** buffer, std::size_t& size) const
 {
-    *buffer = _vertexUniformBuffer;
-    size = _vertexUniformBufferSize;
+    *buffer = _data->vertexUniformBuffer.empty() ? nullptr : _data->vertexUniformBuffer.data();
+    size = _data->vertexUniformBuffer.size();
 }
 
 void ProgramState::getFragmentUniformBuffer(char** buffer, std::size_t& size) const
 {
-    *buffer = _fragmentUniformBuffer;
-    size = _fragmentUniformBufferSize;
+    *buffer = _data->fragmentUniformBuffer.empty() ? nullptr : _data->fragmentUniformBuffer.data();
+    size = _data->fragmentUniformBuffer.size();
+}
+
+uint32_t ProgramState::getMaterialID()
+{
+    if(_data->id == 0)
+        shareData();
+    return _data->id;
+}
+
+void ProgramState::shareData()
+{
+    std::lock_guard<std::recursive_mutex> lock(getSharedDatasMutex());
+    auto changedFrom = _changedFrom.lock();
+    _changedFrom.reset();
+
+    auto& sharedDatas = getSharedDatas();
+    auto hash = _data->computeHash();
+    auto range = sharedDatas.equal_range(hash);
+    auto iter = range.first;
+    for (; iter != range.second; ++iter)
+    {
+        //may be expired if it is being destroyed by another thread
+        auto sharedData = iter->second->self.lock();
+        if (sharedData && *sharedData == *_data)
+        {
+            _data = sharedData;
+            break;
+        }
+    }
+
+    if (iter == range.second)
+    {
+        _data->hash = hash;
+        _data->self = _data;
+        _data->id = s_nextMaterialID++;
+        if (s_nextMaterialID == 0)
+            s_nextMaterialID = 1;
+        sharedDatas.emplace(hash, _data.get());
+    }
+
+    if (changedFrom && changedFrom->id != 0)
+        changedFrom->changed = _data;
+}
+
+ProgramState::SharedData* ProgramState::getMutableData()
+{
+    std::lock_guard<std::recursive_mutex> lock(getSharedDatasMutex());
+    _changedFrom.reset();
+    if (_data.use_count() > 1)
+    {
+        _data = std::make_shared<SharedData>(*_data);
+    }
+    else
+    {
+        //not used by other program states, unshare it instead of copying
+        _data->unshare();
+    }
+    return _data.get();
 }
 
 CC_BACKEND_END
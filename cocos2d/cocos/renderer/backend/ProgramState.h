@@ -29,6 +29,8 @@
 #include <unordered_map>
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
 #include "base/CCEventListenerCustom.h"
@@ -71,6 +73,7 @@ struct TextureInfo
 /**
  * A program state object can create or reuse a program.
  * Each program state object keep its own unifroms and textures data.
+ * The data is shared by the program states of the same program with equal values, and copied when a program state changes a value.
  */
 class ProgramState : public Ref
 {
@@ -86,7 +89,7 @@ public:
     virtual ~ProgramState();
     
     /**
-     * Deep clone ProgramState
+     * Clone ProgramState, the uniforms and textures data is shared until one of the program states changes it.
      */
     ProgramState *clone() const;
     
@@ -162,13 +165,13 @@ public:
      * Get vertex texture informations
      * @return Vertex texture informations. Key is the texture location, Value store the texture informations
      */
-    inline const std::unordered_map<int, TextureInfo>& getVertexTextureInfos() const { return _vertexTextureInfos; }
+    inline const std::unordered_map<int, TextureInfo>& getVertexTextureInfos() const { return _data->vertexTextureInfos; }
 
     /**
      * Get fragment texture informations
      * @return Fragment texture informations. Key is the texture location, Value store the texture informations
      */
-    inline const std::unordered_map<int, TextureInfo>& getFragmentTextureInfos() const { return _fragmentTextureInfos; }
+    inline const std::unordered_map<int, TextureInfo>& getFragmentTextureInfos() const { return _data->fragmentTextureInfos; }
 
     /**
      * Get the uniform callback function.
@@ -178,6 +181,7 @@ public:
 
     /**
      * Get vertex uniform buffer. The buffer store all the vertex uniform's data.
+     * The buffer may be shared with other program states, it must be changed by setUniform() only.
      * @param[out] buffer Specifies the pointer points to a vertex uniform storage.
      * @param[out] size Specifies the size of the buffer in bytes.
      */
@@ -185,10 +189,19 @@ public:
 
     /**
      * Get fragment uniform buffer. The buffer store all the fragment uniform's data for metal.
+     * The buffer may be shared with other program states, it must be changed by setUniform() only.
      * @param[out] buffer Specifies the pointer points to a fragment uniform storage.
      * @param[out] size Specifies the size of the buffer in bytes.
      */
     void getFragmentUniformBuffer(char** buffer, std::size_t& size) const;
+
+    /**
+     * Get the material ID of the uniforms and textures data.
+     * Program states of the same program with equal uniform values and textures have the same ID,
+     * so they can be drawn in one batch. Callback uniforms are not part of the ID.
+     * @return The material ID, never 0.
+     */
+    uint32_t getMaterialID();
     
     /**
     * An abstract base class that can be extended to support custom material auto bindings.
@@ -278,18 +291,27 @@ protected:
      * @param location Specifies the location of texture.
      * @param slot Specifies slot selector of texture.
      * @param texture Specifies the texture to set in given location.
-     * @param textureInfo Specifies the texture information to update.
+     * @param stage Specifies the shader stage of the texture informations to update, VERTEX or FRAGMENT.
      */
-    void setTexture(int location, uint32_t slot, backend::TextureBackend* texture, std::unordered_map<int, TextureInfo>& textureInfo);
+    void setTexture(int location, uint32_t slot, backend::TextureBackend* texture, ShaderStage stage);
     
     /**
      * Set textures in array.
      * @param location Specifies the location of texture.
      * @param slots Specifies slot selector of texture.
      * @param textures Specifies the texture to set in given location.
-     * @param textureInfo Specifies the texture information to update.
+     * @param stage Specifies the shader stage of the texture informations to update, VERTEX or FRAGMENT.
      */
-    void setTextureArray(int location, const std::vector<uint32_t>& slots, const std::vector<backend::TextureBackend*> textures, std::unordered_map<int, TextureInfo>& textureInfo);
+    void setTextureArray(int location, const std::vector<uint32_t>& slots, const std::vector<backend::TextureBackend*> textures, ShaderStage stage);
+
+    /**
+     * Copy the uniform data into a uniform buffer if it is different from the current value.
+     * @param stage Specifies the uniform buffer, VERTEX or FRAGMENT.
+     * @param offset Specifies the offset of the uniform in the buffer.
+     * @param data Specifies the new values to be used for the specified uniform variable.
+     * @param size Specifies the uniform data size.
+     */
+    void updateUniformBuffer(ShaderStage stage, std::size_t offset, const void* data, std::size_t size);
     
     /**
      * Reset uniform informations when EGL context lost
@@ -317,15 +339,51 @@ protected:
     */
     void applyAutoBinding(const std::string &, const std::string &);
 
+    /**
+     * Uniform buffers and textures of a program state.
+     * A shared data is registered by its hash and never changed, program states copy it before changing a value.
+     * Texture locations remapped after the context is lost are the exception, they are not hashed and are the same for all sharers.
+     */
+    struct SharedData
+    {
+        SharedData() = default;
+        ///Copy the values, the copy is not shared.
+        SharedData(const SharedData& other);
+        ~SharedData();
+
+        ///Remove the data from the shared datas, it can be changed afterwards.
+        void unshare();
+        bool operator==(const SharedData& other) const;
+        uint32_t computeHash() const;
+
+        backend::Program* program = nullptr;
+        std::vector<char> vertexUniformBuffer;
+        std::vector<char> fragmentUniformBuffer;
+        std::unordered_map<int, TextureInfo> vertexTextureInfos;
+        std::unordered_map<int, TextureInfo> fragmentTextureInfos;
+        uint32_t id = 0; ///< material ID, 0 if the data is not shared.
+        uint32_t hash = 0;
+        std::weak_ptr<SharedData> self; ///< set while the data is shared.
+        std::weak_ptr<SharedData> changed; ///< shared data resulting from the last uniform change of this one, reused by sharers making the same change.
+    };
+
+    ///Replace the data by a shared data with equal values, or share it if there is none.
+    void shareData();
+
+    ///Get the data to change, it is copied first if it is shared.
+    SharedData* getMutableData();
+
+    ///Share the data another sharer got by the same uniform change, instead of copying and hashing it again.
+    bool reuseChangedData(ShaderStage stage, std::size_t offset, const void* data, std::size_t size);
+
+    static std::unordered_multimap<uint32_t, SharedData*>& getSharedDatas();
+    ///Guard the shared datas, program states may be changed by threads visiting nodes in parallel.
+    static std::recursive_mutex& getSharedDatasMutex();
+
     backend::Program*                                       _program = nullptr;
     std::unordered_map<UniformLocation, UniformCallback, UniformLocation>   _callbackUniforms;
-    char* _vertexUniformBuffer = nullptr;
-    char* _fragmentUniformBuffer = nullptr;
-    std::size_t _vertexUniformBufferSize = 0;
-    std::size_t _fragmentUniformBufferSize = 0;
-
-    std::unordered_map<int, TextureInfo>                    _vertexTextureInfos;
-    std::unordered_map<int, TextureInfo>                    _fragmentTextureInfos;
+    std::shared_ptr<SharedData>                             _data;
+    std::weak_ptr<SharedData>                               _changedFrom; ///< shared data _data was copied from by one uniform change.
 
     std::unordered_map<std::string, std::string>            _autoBindings;
 
@@ -361,6 +361,8 @@ enum class ProgramType : size_t
     SKINPOSITION_BUMPEDNORMAL_TEXTURE_3D,   //CC3D_skinPositionNormalTexture_vert,  CC3D_colorNormalTexture_frag
     PARTICLE_TEXTURE_3D,                    //CC3D_particle_vert,                   CC3D_particleTexture_frag
     PARTICLE_COLOR_3D,                      //CC3D_particle_vert,                   CC3D_particleColor_frag
+    POSITION_TEXTURE_3D_INSTANCED,          //CC3D_positionTextureInstanced_vert,   CC3D_colorTextureInstanced_frag
+    POSITION_3D_INSTANCED,                  //CC3D_positionTextureInstanced_vert,   CC3D_colorInstanced_frag
 
     CUSTOM_PROGRAM,                         //user-define program
 };
@@ -382,6 +384,11 @@ static const char* ATTRIBUTE_NAME_TEXCOORD = "a_texCoord";
 static const char* ATTRIBUTE_NAME_TEXCOORD1 = "a_texCoord1";
 static const char* ATTRIBUTE_NAME_TEXCOORD2 = "a_texCoord2";
 static const char* ATTRIBUTE_NAME_TEXCOORD3 = "a_texCoord3";
+static const char* ATTRIBUTE_NAME_INSTANCE_MVP0 = "a_instanceMVP0";
+static const char* ATTRIBUTE_NAME_INSTANCE_MVP1 = "a_instanceMVP1";
+static const char* ATTRIBUTE_NAME_INSTANCE_MVP2 = "a_instanceMVP2";
+static const char* ATTRIBUTE_NAME_INSTANCE_MVP3 = "a_instanceMVP3";
+static const char* ATTRIBUTE_NAME_INSTANCE_COLOR = "a_instanceColor";
 
 /**
  * @brief a structor to store blend descriptor
@@ -0,0 +1,396 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CapturedFrame.h"
+#include "platform/CCFileUtils.h"
+#include "base/CCData.h"
+
+#include <string.h>
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    const uint32_t FILE_MAGIC = 0x43464343; // "CCFC"
+    const uint32_t FILE_VERSION = 2;
+
+    class Writer
+    {
+    public:
+        template <typename T>
+        void write(const T& value)
+        {
+            writeBytes(&value, sizeof(T));
+        }
+
+        void writeBytes(const void* data, std::size_t size)
+        {
+            auto bytes = static_cast<const char*>(data);
+            _data.insert(_data.end(), bytes, bytes + size);
+        }
+
+        void writeString(const std::string& value)
+        {
+            write((uint32_t)value.size());
+            writeBytes(value.data(), value.size());
+        }
+
+        const std::vector<char>& getData() const { return _data; }
+
+    private:
+        std::vector<char> _data;
+    };
+
+    class Reader
+    {
+    public:
+        Reader(const unsigned char* data, std::size_t size) : _data(data), _size(size) {}
+
+        template <typename T>
+        bool read(T& value)
+        {
+            return readBytes(&value, sizeof(T));
+        }
+
+        bool readBytes(void* data, std::size_t size)
+        {
+            if (_offset + size > _size)
+                return false;
+            memcpy(data, _data + _offset, size);
+            _offset += size;
+            return true;
+        }
+
+        bool readString(std::string& value)
+        {
+            uint32_t size = 0;
+            if (!read(size) || _offset + size > _size)
+                return false;
+            value.assign((const char*)_data + _offset, size);
+            _offset += size;
+            return true;
+        }
+
+        /// Read the element count of a table, the count is bounded by the remaining bytes to reject corrupted files early.
+        bool readCount(uint32_t& count)
+        {
+            return read(count) && count <= _size - _offset;
+        }
+
+    private:
+        const unsigned char* _data = nullptr;
+        std::size_t _size = 0;
+        std::size_t _offset = 0;
+    };
+
+    void writeVertexLayout(Writer& writer, const VertexLayout& layout)
+    {
+        const auto& attributes = layout.getAttributes();
+        writer.write((uint32_t)attributes.size());
+        for (const auto& attribute : attributes)
+        {
+            writer.writeString(attribute.second.name);
+            writer.write((uint64_t)attribute.second.index);
+            writer.write(attribute.second.format);
+            writer.write((uint64_t)attribute.second.offset);
+            writer.write(attribute.second.needToBeNormallized);
+        }
+        writer.write((uint64_t)layout.getStride());
+    }
+
+    bool readVertexLayout(Reader& reader, VertexLayout& layout)
+    {
+        uint32_t count = 0;
+        if (!reader.readCount(count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            std::string name;
+            uint64_t index = 0, offset = 0;
+            VertexFormat format;
+            bool needToBeNormallized = false;
+            if (!reader.readString(name) || !reader.read(index) || !reader.read(format) || !reader.read(offset) || !reader.read(needToBeNormallized))
+                return false;
+            layout.setAttribute(name, (std::size_t)index, format, (std::size_t)offset, needToBeNormallized);
+        }
+        uint64_t stride = 0;
+        if (!reader.read(stride))
+            return false;
+        layout.setLayout((std::size_t)stride);
+        return true;
+    }
+
+    void writeCommand(Writer& writer, const RecordedCommand& command)
+    {
+        writer.write(command.type);
+        writer.write(command.primitiveType);
+        writer.write(command.indexFormat);
+        writer.write((uint64_t)command.offset);
+        writer.write((uint64_t)command.count);
+        writer.write((uint64_t)command.instanceCount);
+        writer.write(command.values);
+        writer.write(command.value);
+        writer.write(command.renderPass);
+        writer.write(command.payload);
+        writer.write(command.resource);
+    }
+
+    bool readCommand(Reader& reader, RecordedCommand& command)
+    {
+        uint64_t offset = 0, count = 0, instanceCount = 0;
+        bool ret = reader.read(command.type)
+            && reader.read(command.primitiveType)
+            && reader.read(command.indexFormat)
+            && reader.read(offset)
+            && reader.read(count)
+            && reader.read(instanceCount)
+            && reader.read(command.values)
+            && reader.read(command.value)
+            && reader.read(command.renderPass)
+            && reader.read(command.payload)
+            && reader.read(command.resource);
+        command.offset = (std::size_t)offset;
+        command.count = (std::size_t)count;
+        command.instanceCount = (std::size_t)instanceCount;
+        return ret;
+    }
+
+    // descriptors only hold enums, numbers and booleans
+    template <typename T>
+    void writeTable(Writer& writer, const std::vector<T>& table)
+    {
+        writer.write((uint32_t)table.size());
+        for (const auto& element : table)
+            writer.write(element);
+    }
+
+    template <typename T>
+    bool readTable(Reader& reader, std::vector<T>& table)
+    {
+        uint32_t count = 0;
+        if (!reader.readCount(count))
+            return false;
+        table.resize(count);
+        for (auto& element : table)
+        {
+            if (!reader.read(element))
+                return false;
+        }
+        return true;
+    }
+}
+
+void CapturedFrame::clear()
+{
+    commands.clear();
+    payload.clear();
+    renderPasses.clear();
+    buffers.clear();
+    textures.clear();
+    programs.clear();
+    vertexLayouts.clear();
+    programStates.clear();
+    pipelines.clear();
+    depthStencilStates.clear();
+}
+
+bool CapturedFrame::save(const std::string& filename) const
+{
+    Writer writer;
+    writer.write(FILE_MAGIC);
+    writer.write(FILE_VERSION);
+
+    writer.write((uint32_t)commands.size());
+    for (const auto& command : commands)
+        writeCommand(writer, command);
+
+    writer.write((uint32_t)payload.size());
+    writer.writeBytes(payload.data(), payload.size());
+
+    writer.write((uint32_t)renderPasses.size());
+    for (const auto& renderPass : renderPasses)
+    {
+        // the attachment pointers are meaningless in another process, they are written as null
+        RenderPassDescriptor descriptor;
+        descriptor.clearDepthValue = renderPass.descriptor.clearDepthValue;
+        descriptor.clearStencilValue = renderPass.descriptor.clearStencilValue;
+        descriptor.clearColorValue = renderPass.descriptor.clearColorValue;
+        descriptor.needColorAttachment = renderPass.descriptor.needColorAttachment;
+        descriptor.depthTestEnabled = renderPass.descriptor.depthTestEnabled;
+        descriptor.stencilTestEnabled = renderPass.descriptor.stencilTestEnabled;
+        descriptor.needClearColor = renderPass.descriptor.needClearColor;
+        descriptor.needClearDepth = renderPass.descriptor.needClearDepth;
+        descriptor.needClearStencil = renderPass.descriptor.needClearStencil;
+        writer.write(descriptor);
+        writer.write(renderPass.depthAttachment);
+        writer.write(renderPass.stencilAttachment);
+        writer.write(renderPass.colorAttachments);
+    }
+
+    writeTable(writer, buffers);
+    writeTable(writer, textures);
+
+    writer.write((uint32_t)programs.size());
+    for (const auto& program : programs)
+    {
+        writer.writeString(program.vertexShader);
+        writer.writeString(program.fragmentShader);
+        writer.write((uint32_t)program.uniforms.size());
+        for (const auto& uniform : program.uniforms)
+        {
+            writer.writeString(uniform.name);
+            writer.write(uniform.stage);
+            writer.write(uniform.offset);
+            writer.write(uniform.size);
+        }
+    }
+
+    writer.write((uint32_t)vertexLayouts.size());
+    for (const auto& layout : vertexLayouts)
+        writeVertexLayout(writer, layout);
+
+    writer.write((uint32_t)programStates.size());
+    for (const auto& programState : programStates)
+    {
+        writer.write(programState.program);
+        writer.write(programState.vertexLayout);
+        writer.write(programState.vertexUniforms);
+        writer.write(programState.vertexUniformSize);
+        writer.write(programState.fragmentUniforms);
+        writer.write(programState.fragmentUniformSize);
+        writer.write((uint32_t)programState.textures.size());
+        for (const auto& binding : programState.textures)
+        {
+            writer.writeString(binding.name);
+            writer.write(binding.stage);
+            writer.write((uint32_t)binding.slots.size());
+            writer.writeBytes(binding.slots.data(), binding.slots.size() * sizeof(uint32_t));
+            writer.writeBytes(binding.textures.data(), binding.textures.size() * sizeof(int));
+        }
+    }
+
+    writeTable(writer, pipelines);
+    writeTable(writer, depthStencilStates);
+
+    const auto& bytes = writer.getData();
+    Data data;
+    data.copy((const unsigned char*)bytes.data(), bytes.size());
+    return FileUtils::getInstance()->writeDataToFile(data, filename);
+}
+
+bool CapturedFrame::load(const std::string& filename)
+{
+    clear();
+
+    auto data = FileUtils::getInstance()->getDataFromFile(filename);
+    Reader reader(data.getBytes(), data.getSize());
+
+    uint32_t magic = 0, version = 0;
+    if (!reader.read(magic) || !reader.read(version) || magic != FILE_MAGIC || version != FILE_VERSION)
+        return false;
+
+    uint32_t count = 0;
+    if (!reader.readCount(count))
+        return false;
+    commands.resize(count);
+    for (auto& command : commands)
+    {
+        if (!readCommand(reader, command))
+            return false;
+    }
+
+    if (!reader.readCount(count))
+        return false;
+    payload.resize(count);
+    if (!reader.readBytes(payload.data(), count))
+        return false;
+
+    if (!reader.readCount(count))
+        return false;
+    renderPasses.resize(count);
+    for (auto& renderPass : renderPasses)
+    {
+        if (!reader.read(renderPass.descriptor)
+            || !reader.read(renderPass.depthAttachment)
+            || !reader.read(renderPass.stencilAttachment)
+            || !reader.read(renderPass.colorAttachments))
+            return false;
+    }
+
+    if (!readTable(reader, buffers) || !readTable(reader, textures))
+        return false;
+
+    if (!reader.readCount(count))
+        return false;
+    programs.resize(count);
+    for (auto& program : programs)
+    {
+        if (!reader.readString(program.vertexShader) || !reader.readString(program.fragmentShader) || !reader.readCount(count))
+            return false;
+        program.uniforms.resize(count);
+        for (auto& uniform : program.uniforms)
+        {
+            if (!reader.readString(uniform.name) || !reader.read(uniform.stage) || !reader.read(uniform.offset) || !reader.read(uniform.size))
+                return false;
+        }
+    }
+
+    if (!reader.readCount(count))
+        return false;
+    vertexLayouts.resize(count);
+    for (auto& layout : vertexLayouts)
+    {
+        if (!readVertexLayout(reader, layout))
+            return false;
+    }
+
+    if (!reader.readCount(count))
+        return false;
+    programStates.resize(count);
+    for (auto& programState : programStates)
+    {
+        if (!reader.read(programState.program)
+            || !reader.read(programState.vertexLayout)
+            || !reader.read(programState.vertexUniforms)
+            || !reader.read(programState.vertexUniformSize)
+            || !reader.read(programState.fragmentUniforms)
+            || !reader.read(programState.fragmentUniformSize)
+            || !reader.readCount(count))
+            return false;
+        programState.textures.resize(count);
+        for (auto& binding : programState.textures)
+        {
+            if (!reader.readString(binding.name) || !reader.read(binding.stage) || !reader.readCount(count))
+                return false;
+            binding.slots.resize(count);
+            binding.textures.resize(count);
+            if (!reader.readBytes(binding.slots.data(), count * sizeof(uint32_t)) || !reader.readBytes(binding.textures.data(), count * sizeof(int)))
+                return false;
+        }
+    }
+
+    return readTable(reader, pipelines) && readTable(reader, depthStencilStates);
+}
+
+CC_BACKEND_END
@@ -0,0 +1,149 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Macros.h"
+#include "../Types.h"
+#include "../Texture.h"
+#include "../VertexLayout.h"
+#include "../DepthStencilState.h"
+#include "../RenderPassDescriptor.h"
+#include "../null/CommandRecorder.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+CC_BACKEND_BEGIN
+/**
+ * @addtogroup _backend
+ * @{
+ */
+
+/**
+ * The backend calls of one frame and the resources they reference, written by FrameCapture and read by FrameReplayer.
+ * Objects are referenced by their index in the tables, @see RecordedCommand::resource.
+ * Uniforms and texture bindings are identified by name, so that they are valid for a program created again.
+ */
+struct CapturedFrame
+{
+    struct Buffer
+    {
+        BufferType type = BufferType::VERTEX;
+        BufferUsage usage = BufferUsage::DYNAMIC;
+        uint64_t size = 0;
+        int contents = -1;      ///< offset in the payload of the contents when the buffer is first referenced, -1 if they can't be read.
+    };
+
+    struct Texture
+    {
+        TextureDescriptor descriptor;
+        int contents = -1;      ///< offset in the payload of the RGBA8888 pixels when the texture is first referenced, -1 if they can't be read.
+    };
+
+    struct Uniform
+    {
+        std::string name;
+        ShaderStage stage = ShaderStage::VERTEX;
+        uint32_t offset = 0;    ///< offset in the uniform buffer of the stage.
+        uint32_t size = 0;      ///< size in bytes of all the elements.
+    };
+
+    struct Program
+    {
+        std::string vertexShader;
+        std::string fragmentShader;
+        std::vector<Uniform> uniforms;
+    };
+
+    struct TextureBinding
+    {
+        std::string name;
+        ShaderStage stage = ShaderStage::VERTEX;
+        std::vector<uint32_t> slots;
+        std::vector<int> textures;
+    };
+
+    /// The state of a program state when it is used, uniform buffers are stored in the payload.
+    struct ProgramState
+    {
+        int program = -1;
+        int vertexLayout = -1;
+        int vertexUniforms = -1;
+        uint32_t vertexUniformSize = 0;
+        int fragmentUniforms = -1;
+        uint32_t fragmentUniformSize = 0;
+        std::vector<TextureBinding> textures;
+    };
+
+    struct Pipeline
+    {
+        int programState = -1;
+        BlendDescriptor blendDescriptor;
+    };
+
+    /// Attachments are replaced by texture indices, the texture pointers of the descriptor are not used.
+    struct RenderPass
+    {
+        RenderPass() { std::fill(colorAttachments, colorAttachments + MAX_COLOR_ATTCHMENT, -1); }
+
+        RenderPassDescriptor descriptor;
+        int depthAttachment = -1;
+        int stencilAttachment = -1;
+        int colorAttachments[MAX_COLOR_ATTCHMENT];
+    };
+
+    /**
+     * Write the frame to a binary file.
+     * @param filename Specifies the full path of the file.
+     * @return true if succeeded.
+     */
+    bool save(const std::string& filename) const;
+
+    /**
+     * Read a frame written by save(). Files written by another version of the engine are rejected.
+     * @param filename Specifies the path of the file.
+     * @return true if succeeded.
+     */
+    bool load(const std::string& filename);
+
+    /// Remove all commands and resources.
+    void clear();
+
+    std::vector<RecordedCommand> commands;
+    std::vector<char> payload;
+    std::vector<RenderPass> renderPasses;
+    std::vector<Buffer> buffers;
+    std::vector<Texture> textures;
+    std::vector<Program> programs;
+    std::vector<VertexLayout> vertexLayouts;
+    std::vector<ProgramState> programStates;
+    std::vector<Pipeline> pipelines;
+    std::vector<DepthStencilDescriptor> depthStencilStates;
+};
+
+//end of _backend group
+/// @}
+CC_BACKEND_END
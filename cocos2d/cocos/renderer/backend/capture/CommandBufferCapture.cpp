@@ -0,0 +1,254 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CommandBufferCapture.h"
+#include "FrameCapture.h"
+#include "base/ccMacros.h"
+
+CC_BACKEND_BEGIN
+
+CommandBufferCapture::CommandBufferCapture(CommandBuffer* commandBuffer, FrameCapture* frameCapture)
+: _commandBuffer(commandBuffer)
+, _frameCapture(frameCapture)
+{
+    CC_SAFE_RETAIN(_commandBuffer);
+}
+
+CommandBufferCapture::~CommandBufferCapture()
+{
+    CC_SAFE_RELEASE(_commandBuffer);
+}
+
+void CommandBufferCapture::record(RecordedCommand::Type type, int resource)
+{
+    RecordedCommand command;
+    command.type = type;
+    command.resource = resource;
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::syncStencilReferenceValue()
+{
+    // setStencilReferenceValue() isn't virtual, the values set on this command buffer are forwarded before they are used
+    if (_stencilReferenceForwarded
+        && _forwardedStencilReferenceFront == _stencilReferenceValueFront
+        && _forwardedStencilReferenceBack == _stencilReferenceValueBack)
+        return;
+
+    _stencilReferenceForwarded = true;
+    _forwardedStencilReferenceFront = _stencilReferenceValueFront;
+    _forwardedStencilReferenceBack = _stencilReferenceValueBack;
+    _commandBuffer->setStencilReferenceValue(_stencilReferenceValueFront, _stencilReferenceValueBack);
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_STENCIL_REFERENCE;
+    command.values[0] = (float)_stencilReferenceValueFront;
+    command.values[1] = (float)_stencilReferenceValueBack;
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::recordProgramState()
+{
+    record(RecordedCommand::Type::SET_PROGRAM_STATE, _frameCapture->captureProgramState(_programState));
+}
+
+void CommandBufferCapture::beginFrame()
+{
+    _commandBuffer->beginFrame();
+    record(RecordedCommand::Type::BEGIN_FRAME);
+}
+
+void CommandBufferCapture::beginRenderPass(const RenderPassDescriptor& descriptor)
+{
+    _commandBuffer->beginRenderPass(descriptor);
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::BEGIN_RENDER_PASS;
+    command.renderPass = _frameCapture->captureRenderPass(descriptor);
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::setRenderPipeline(RenderPipeline* renderPipeline)
+{
+    _commandBuffer->setRenderPipeline(renderPipeline);
+    record(RecordedCommand::Type::SET_RENDER_PIPELINE);
+}
+
+void CommandBufferCapture::setViewport(int x, int y, unsigned int w, unsigned int h)
+{
+    _commandBuffer->setViewport(x, y, w, h);
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_VIEWPORT;
+    command.values[0] = (float)x;
+    command.values[1] = (float)y;
+    command.values[2] = (float)w;
+    command.values[3] = (float)h;
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::setCullMode(CullMode mode)
+{
+    _commandBuffer->setCullMode(mode);
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_CULL_MODE;
+    command.value = (uint32_t)mode;
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::setWinding(Winding winding)
+{
+    _commandBuffer->setWinding(winding);
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_WINDING;
+    command.value = (uint32_t)winding;
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::setVertexBuffer(Buffer* buffer)
+{
+    _commandBuffer->setVertexBuffer(buffer);
+    record(RecordedCommand::Type::SET_VERTEX_BUFFER, _frameCapture->captureBuffer(buffer));
+}
+
+void CommandBufferCapture::setProgramState(ProgramState* programState)
+{
+    _commandBuffer->setProgramState(programState);
+    _programState = programState;
+}
+
+void CommandBufferCapture::setIndexBuffer(Buffer* buffer)
+{
+    _commandBuffer->setIndexBuffer(buffer);
+    record(RecordedCommand::Type::SET_INDEX_BUFFER, _frameCapture->captureBuffer(buffer));
+}
+
+void CommandBufferCapture::setInstanceBuffer(Buffer* buffer, const VertexLayout& layout, const void* data)
+{
+    _commandBuffer->setInstanceBuffer(buffer, layout, data);
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_INSTANCE_BUFFER;
+    command.resource = _frameCapture->captureBuffer(buffer);
+    command.value = (uint32_t)_frameCapture->captureVertexLayout(layout);
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::drawArrays(PrimitiveType primitiveType, std::size_t start,  std::size_t count)
+{
+    syncStencilReferenceValue();
+    _commandBuffer->drawArrays(primitiveType, start, count);
+    recordProgramState();
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::DRAW_ARRAYS;
+    command.primitiveType = primitiveType;
+    command.offset = start;
+    command.count = count;
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::drawElements(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset)
+{
+    syncStencilReferenceValue();
+    _commandBuffer->drawElements(primitiveType, indexType, count, offset);
+    recordProgramState();
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::DRAW_ELEMENTS;
+    command.primitiveType = primitiveType;
+    command.indexFormat = indexType;
+    command.offset = offset;
+    command.count = count;
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount)
+{
+    syncStencilReferenceValue();
+    _commandBuffer->drawElementsInstanced(primitiveType, indexType, count, offset, instanceCount);
+    recordProgramState();
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::DRAW_ELEMENTS_INSTANCED;
+    command.primitiveType = primitiveType;
+    command.indexFormat = indexType;
+    command.offset = offset;
+    command.count = count;
+    command.instanceCount = instanceCount;
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::endRenderPass()
+{
+    _commandBuffer->endRenderPass();
+    record(RecordedCommand::Type::END_RENDER_PASS);
+}
+
+void CommandBufferCapture::endFrame()
+{
+    _commandBuffer->endFrame();
+    record(RecordedCommand::Type::END_FRAME);
+}
+
+void CommandBufferCapture::setLineWidth(float lineWidth)
+{
+    _commandBuffer->setLineWidth(lineWidth);
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_LINE_WIDTH;
+    command.values[0] = lineWidth;
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::setScissorRect(bool isEnabled, float x, float y, float width, float height)
+{
+    _commandBuffer->setScissorRect(isEnabled, x, y, width, height);
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_SCISSOR_RECT;
+    command.value = isEnabled ? 1 : 0;
+    command.values[0] = x;
+    command.values[1] = y;
+    command.values[2] = width;
+    command.values[3] = height;
+    _frameCapture->record(command);
+}
+
+void CommandBufferCapture::setDepthStencilState(DepthStencilState* depthStencilState)
+{
+    syncStencilReferenceValue();
+    _commandBuffer->setDepthStencilState(depthStencilState);
+    record(RecordedCommand::Type::SET_DEPTH_STENCIL_STATE, _frameCapture->captureDepthStencilState(depthStencilState));
+}
+
+void CommandBufferCapture::captureScreen(std::function<void(const unsigned char*, int, int)> callback)
+{
+    _commandBuffer->captureScreen(callback);
+    record(RecordedCommand::Type::CAPTURE_SCREEN);
+}
+
+CC_BACKEND_END
@@ -0,0 +1,91 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../CommandBuffer.h"
+#include "../null/CommandRecorder.h"
+
+CC_BACKEND_BEGIN
+
+class FrameCapture;
+
+/**
+ * @addtogroup _backend
+ * @{
+ */
+
+/**
+ * Record the calls into the frame capture, then forward them to the command buffer of the renderer.
+ * Program states are recorded at draw time, after the uniform callbacks are applied.
+ */
+class CommandBufferCapture final : public CommandBuffer
+{
+public:
+    /**
+     * @param commandBuffer Specifies the command buffer to forward the calls to.
+     * @param frameCapture Specifies the frame capture recording the calls.
+     */
+    CommandBufferCapture(CommandBuffer* commandBuffer, FrameCapture* frameCapture);
+    ~CommandBufferCapture();
+
+    /// Get the command buffer the calls are forwarded to.
+    inline CommandBuffer* getCommandBuffer() const { return _commandBuffer; }
+
+    virtual void beginFrame() override;
+    virtual void beginRenderPass(const RenderPassDescriptor& descriptor) override;
+    virtual void setRenderPipeline(RenderPipeline* renderPipeline) override;
+    virtual void setViewport(int x, int y, unsigned int w, unsigned int h) override;
+    virtual void setCullMode(CullMode mode) override;
+    virtual void setWinding(Winding winding) override;
+    virtual void setVertexBuffer(Buffer* buffer) override;
+    virtual void setProgramState(ProgramState* programState) override;
+    virtual void setIndexBuffer(Buffer* buffer) override;
+    virtual void setInstanceBuffer(Buffer* buffer, const VertexLayout& layout, const void* data) override;
+    virtual void drawArrays(PrimitiveType primitiveType, std::size_t start,  std::size_t count) override;
+    virtual void drawElements(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset) override;
+    virtual void drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount) override;
+    virtual void endRenderPass() override;
+    virtual void endFrame() override;
+    virtual void setLineWidth(float lineWidth) override;
+    virtual void setScissorRect(bool isEnabled, float x, float y, float width, float height) override;
+    virtual void setDepthStencilState(DepthStencilState* depthStencilState) override;
+    virtual void captureScreen(std::function<void(const unsigned char*, int, int)> callback) override;
+
+private:
+    void syncStencilReferenceValue();
+    void recordProgramState();
+    void record(RecordedCommand::Type type, int resource = -1);
+
+    CommandBuffer* _commandBuffer = nullptr;
+    FrameCapture* _frameCapture = nullptr;
+    ProgramState* _programState = nullptr;
+    bool _stencilReferenceForwarded = false;
+    unsigned int _forwardedStencilReferenceFront = 0;
+    unsigned int _forwardedStencilReferenceBack = 0;
+};
+
+//end of _backend group
+/// @}
+CC_BACKEND_END
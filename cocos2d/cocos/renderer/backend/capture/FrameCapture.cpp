@@ -0,0 +1,350 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "FrameCapture.h"
+#include "CommandBufferCapture.h"
+#include "../Buffer.h"
+#include "../Program.h"
+#include "../ProgramState.h"
+#include "base/ccMacros.h"
+
+#include <algorithm>
+
+CC_BACKEND_BEGIN
+
+bool FrameCapture::_capturing = false;
+
+FrameCapture* FrameCapture::getInstance()
+{
+    static FrameCapture instance;
+    return &instance;
+}
+
+void FrameCapture::requestCapture(const std::string& filename, const std::function<void(bool)>& callback)
+{
+    if (_capturing || _pendingReads > 0)
+    {
+        CCLOG("FrameCapture: %s is still being captured", _filename.c_str());
+        if (callback)
+            callback(false);
+        return;
+    }
+
+    _filename = filename;
+    _callback = callback;
+}
+
+CommandBuffer* FrameCapture::beginCapture(CommandBuffer* commandBuffer)
+{
+    CCASSERT(!_capturing, "the capture is already begun");
+
+    _frame.clear();
+    _indices.clear();
+    _commandBuffer = new (std::nothrow) CommandBufferCapture(commandBuffer, this);
+    _capturing = true;
+    return _commandBuffer;
+}
+
+CommandBuffer* FrameCapture::endCapture()
+{
+    CCASSERT(_capturing, "the capture isn't begun");
+
+    _capturing = false;
+    // the renderer still owns the command buffer
+    auto commandBuffer = _commandBuffer->getCommandBuffer();
+    CC_SAFE_RELEASE_NULL(_commandBuffer);
+
+    // otherwise the last texture read writes the file
+    if (_pendingReads == 0)
+        writeFile();
+
+    return commandBuffer;
+}
+
+void FrameCapture::writeFile()
+{
+    bool succeeded = _frame.save(_filename);
+    if (!succeeded)
+        CCLOG("FrameCapture: failed to write %s", _filename.c_str());
+
+    _frame.clear();
+    _indices.clear();
+    _filename.clear();
+    auto callback = std::move(_callback);
+    _callback = nullptr;
+    if (callback)
+        callback(succeeded);
+}
+
+void FrameCapture::record(RecordedCommand& command, const void* data, std::size_t size)
+{
+    if (data && size)
+    {
+        command.payload = (int)_frame.payload.size();
+        auto bytes = static_cast<const char*>(data);
+        _frame.payload.insert(_frame.payload.end(), bytes, bytes + size);
+    }
+    _frame.commands.push_back(command);
+}
+
+void FrameCapture::recordBufferUpdate(Buffer* buffer, const void* data, std::size_t offset, std::size_t size)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::UPDATE_BUFFER;
+    command.resource = captureBuffer(buffer);
+    command.offset = offset;
+    command.count = size;
+    record(command, data, size);
+}
+
+void FrameCapture::recordRenderPipeline(const PipelineDescriptor& pipelineDescriptor)
+{
+    CapturedFrame::Pipeline pipeline;
+    pipeline.programState = captureProgramState(pipelineDescriptor.programState);
+    pipeline.blendDescriptor = pipelineDescriptor.blendDescriptor;
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::UPDATE_RENDER_PIPELINE;
+    command.resource = (int)_frame.pipelines.size();
+    command.renderPass = (int)_frame.renderPasses.size() - 1;
+    _frame.pipelines.push_back(pipeline);
+    record(command);
+}
+
+int FrameCapture::captureBuffer(Buffer* buffer)
+{
+    if (!buffer)
+        return -1;
+
+    auto iter = _indices.find(buffer);
+    if (iter != _indices.end())
+        return iter->second;
+
+    CapturedFrame::Buffer captured;
+    captured.type = buffer->getType();
+    captured.usage = buffer->getUsage();
+    captured.size = buffer->getSize();
+
+    std::vector<char> contents((std::size_t)captured.size, 0);
+    if (!contents.empty() && buffer->getData(contents.data(), contents.size()) > 0)
+    {
+        captured.contents = (int)_frame.payload.size();
+        _frame.payload.insert(_frame.payload.end(), contents.begin(), contents.end());
+    }
+
+    int index = (int)_frame.buffers.size();
+    _frame.buffers.push_back(captured);
+    _indices[buffer] = index;
+    return index;
+}
+
+int FrameCapture::captureTexture(TextureBackend* texture)
+{
+    if (!texture)
+        return -1;
+
+    auto iter = _indices.find(texture);
+    if (iter != _indices.end())
+        return iter->second;
+
+    CapturedFrame::Texture captured;
+    captured.descriptor.textureType = texture->getTextureType();
+    captured.descriptor.textureFormat = texture->getTextureFormat();
+    captured.descriptor.textureUsage = texture->getTextureUsage();
+    // cube maps have no size getter, they are not recreated by the replay
+    if (TextureType::TEXTURE_2D == captured.descriptor.textureType)
+    {
+        auto texture2D = static_cast<Texture2DBackend*>(texture);
+        captured.descriptor.width = (uint32_t)texture2D->getWidth();
+        captured.descriptor.height = (uint32_t)texture2D->getHeight();
+    }
+
+    int index = (int)_frame.textures.size();
+    _frame.textures.push_back(captured);
+    _indices[texture] = index;
+    readTexture(texture, index);
+    return index;
+}
+
+void FrameCapture::readTexture(TextureBackend* texture, int index)
+{
+    // getBytes() returns RGBA8888 pixels on every backend only for textures of that format
+    const auto& descriptor = _frame.textures[index].descriptor;
+    if (TextureType::TEXTURE_2D != descriptor.textureType || PixelFormat::RGBA8888 != descriptor.textureFormat
+        || descriptor.width == 0 || descriptor.height == 0)
+        return;
+
+    // rows in the order of updateData(), Metal flips the rows unless asked not to
+#if defined(CC_USE_METAL)
+    const bool flipImage = true;
+#else
+    const bool flipImage = false;
+#endif
+
+    ++_pendingReads;
+    std::size_t size = descriptor.width * descriptor.height * 4;
+    texture->getBytes(0, 0, descriptor.width, descriptor.height, flipImage, [this, index, size](const unsigned char* data, std::size_t width, std::size_t height) {
+        if (data && width * height * 4 == size)
+        {
+            _frame.textures[index].contents = (int)_frame.payload.size();
+            _frame.payload.insert(_frame.payload.end(), data, data + size);
+        }
+
+        if (--_pendingReads == 0 && !_capturing)
+            writeFile();
+    });
+}
+
+int FrameCapture::captureDepthStencilState(DepthStencilState* depthStencilState)
+{
+    if (!depthStencilState)
+        return -1;
+
+    // depth stencil states are autoreleased objects created per render pass, so they are not deduplicated by address
+    _frame.depthStencilStates.push_back(depthStencilState->getDepthStencilInfo());
+    return (int)_frame.depthStencilStates.size() - 1;
+}
+
+int FrameCapture::captureVertexLayout(const VertexLayout& vertexLayout)
+{
+    // layouts are owned by program states which may be released during the frame, so they are compared by value
+    auto isSameLayout = [&vertexLayout](const VertexLayout& layout) {
+        if (layout.getStride() != vertexLayout.getStride() || layout.getAttributes().size() != vertexLayout.getAttributes().size())
+            return false;
+        for (const auto& attribute : layout.getAttributes())
+        {
+            auto iter = vertexLayout.getAttributes().find(attribute.first);
+            if (iter == vertexLayout.getAttributes().end()
+                || iter->second.index != attribute.second.index
+                || iter->second.format != attribute.second.format
+                || iter->second.offset != attribute.second.offset
+                || iter->second.needToBeNormallized != attribute.second.needToBeNormallized)
+                return false;
+        }
+        return true;
+    };
+
+    auto iter = std::find_if(_frame.vertexLayouts.begin(), _frame.vertexLayouts.end(), isSameLayout);
+    if (iter != _frame.vertexLayouts.end())
+        return (int)(iter - _frame.vertexLayouts.begin());
+
+    _frame.vertexLayouts.push_back(vertexLayout);
+    return (int)_frame.vertexLayouts.size() - 1;
+}
+
+int FrameCapture::captureRenderPass(const RenderPassDescriptor& descriptor)
+{
+    CapturedFrame::RenderPass renderPass;
+    renderPass.descriptor = descriptor;
+    renderPass.depthAttachment = captureTexture(descriptor.depthAttachmentTexture);
+    renderPass.stencilAttachment = captureTexture(descriptor.stencilAttachmentTexture);
+    for (int i = 0; i < MAX_COLOR_ATTCHMENT; ++i)
+        renderPass.colorAttachments[i] = captureTexture(descriptor.colorAttachmentsTexture[i]);
+
+    _frame.renderPasses.push_back(renderPass);
+    return (int)_frame.renderPasses.size() - 1;
+}
+
+int FrameCapture::captureProgram(Program* program)
+{
+    auto iter = _indices.find(program);
+    if (iter != _indices.end())
+        return iter->second;
+
+    CapturedFrame::Program captured;
+    captured.vertexShader = program->getVertexShader();
+    captured.fragmentShader = program->getFragmentShader();
+    for (auto stage : {ShaderStage::VERTEX, ShaderStage::FRAGMENT})
+    {
+        for (const auto& uniform : program->getAllActiveUniformInfo(stage))
+        {
+            CapturedFrame::Uniform capturedUniform;
+            capturedUniform.name = uniform.first;
+            capturedUniform.stage = stage;
+            capturedUniform.offset = uniform.second.bufferOffset;
+            capturedUniform.size = uniform.second.size * uniform.second.count;
+            captured.uniforms.push_back(capturedUniform);
+        }
+    }
+
+    int index = (int)_frame.programs.size();
+    _frame.programs.push_back(std::move(captured));
+    _indices[program] = index;
+    return index;
+}
+
+int FrameCapture::captureProgramState(ProgramState* programState)
+{
+    if (!programState)
+        return -1;
+
+    auto program = programState->getProgram();
+    CapturedFrame::ProgramState captured;
+    captured.program = captureProgram(program);
+    captured.vertexLayout = captureVertexLayout(*programState->getVertexLayout());
+
+    char* buffer = nullptr;
+    std::size_t size = 0;
+    programState->getVertexUniformBuffer(&buffer, size);
+    if (buffer && size)
+    {
+        captured.vertexUniforms = (int)_frame.payload.size();
+        captured.vertexUniformSize = (uint32_t)size;
+        _frame.payload.insert(_frame.payload.end(), buffer, buffer + size);
+    }
+    programState->getFragmentUniformBuffer(&buffer, size);
+    if (buffer && size)
+    {
+        captured.fragmentUniforms = (int)_frame.payload.size();
+        captured.fragmentUniformSize = (uint32_t)size;
+        _frame.payload.insert(_frame.payload.end(), buffer, buffer + size);
+    }
+
+    auto captureTextures = [&](ShaderStage stage, const std::unordered_map<int, TextureInfo>& textureInfos) {
+        const auto& uniforms = program->getAllActiveUniformInfo(stage);
+        for (const auto& textureInfo : textureInfos)
+        {
+            auto uniform = std::find_if(uniforms.begin(), uniforms.end(), [&](const std::pair<const std::string, UniformInfo>& element) {
+                return element.second.location == textureInfo.first;
+            });
+            if (uniform == uniforms.end())
+                continue;
+
+            CapturedFrame::TextureBinding binding;
+            binding.name = uniform->first;
+            binding.stage = stage;
+            binding.slots = textureInfo.second.slot;
+            for (auto texture : textureInfo.second.textures)
+                binding.textures.push_back(captureTexture(texture));
+            captured.textures.push_back(std::move(binding));
+        }
+    };
+    captureTextures(ShaderStage::VERTEX, programState->getVertexTextureInfos());
+    captureTextures(ShaderStage::FRAGMENT, programState->getFragmentTextureInfos());
+
+    _frame.programStates.push_back(std::move(captured));
+    return (int)_frame.programStates.size() - 1;
+}
+
+CC_BACKEND_END
@@ -0,0 +1,127 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "CapturedFrame.h"
+#include "renderer/CCPipelineDescriptor.h"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+CC_BACKEND_BEGIN
+
+class Buffer;
+class CommandBuffer;
+class CommandBufferCapture;
+class Program;
+class ProgramState;
+
+/**
+ * @addtogroup _backend
+ * @{
+ */
+
+/**
+ * Capture the backend calls of one frame and the contents of the resources they use, then write them to a file.
+ * The file can be replayed many times by FrameReplayer, detached from the game state, i.e. under a profiler.
+ * @code
+ * backend::FrameCapture::getInstance()->requestCapture(FileUtils::getInstance()->getWritablePath() + "frame.ccfc");
+ * @endcode
+ * Buffers and RGBA8888 2D textures are read back when the frame references them first, so that the replay starts from the same contents.
+ * Texture reads may complete in a later frame, the file is written once all of them are delivered.
+ * Buffers the backend can't read (OpenGL ES dynamic buffers) and textures in other formats are replayed with zeros.
+ */
+class FrameCapture
+{
+public:
+    /// Get the shared instance.
+    static FrameCapture* getInstance();
+
+    /**
+     * Capture the next frame.
+     * @param filename Specifies the full path of the file to be written.
+     * @param callback Invoked when the file is written, with whether it succeeded.
+     * The request is rejected while a capture is running or being written.
+     */
+    void requestCapture(const std::string& filename, const std::function<void(bool)>& callback = nullptr);
+
+    /// Whether a frame is being captured, cheap enough to be checked by every buffer update.
+    static inline bool isCapturing() { return _capturing; }
+
+    /// Whether requestCapture() is invoked and the capture is not begun yet.
+    inline bool isCaptureRequested() const { return !_filename.empty() && !_capturing && _pendingReads == 0; }
+
+    /**
+     * Begin capturing, invoked by the renderer before the beginning of the frame.
+     * @param commandBuffer Specifies the command buffer of the renderer.
+     * @return A command buffer which records the calls then forwards them to commandBuffer, valid until endCapture().
+     */
+    CommandBuffer* beginCapture(CommandBuffer* commandBuffer);
+
+    /**
+     * End capturing and write the file, or wait for the pending texture reads, invoked by the renderer after the end of the frame.
+     * @return The command buffer passed to beginCapture().
+     */
+    CommandBuffer* endCapture();
+
+    /// Record an update of the buffer, invoked by the backend buffers.
+    void recordBufferUpdate(Buffer* buffer, const void* data, std::size_t offset, std::size_t size);
+
+    /// Record an update of the render pipeline, invoked by the renderer.
+    void recordRenderPipeline(const PipelineDescriptor& pipelineDescriptor);
+
+    /// Append a command, data is copied into the payload.
+    void record(RecordedCommand& command, const void* data = nullptr, std::size_t size = 0);
+
+    /// @name Get the index of the object in the tables of the frame, the object is added if it isn't referenced yet.
+    /// @{
+    int captureBuffer(Buffer* buffer);
+    int captureTexture(TextureBackend* texture);
+    int captureDepthStencilState(DepthStencilState* depthStencilState);
+    int captureVertexLayout(const VertexLayout& vertexLayout);
+    int captureRenderPass(const RenderPassDescriptor& descriptor);
+    /// A program state is added each time, the values of uniforms and textures may be changed between draws.
+    int captureProgramState(ProgramState* programState);
+    /// @}
+
+private:
+    int captureProgram(Program* program);
+    void readTexture(TextureBackend* texture, int index);
+    void writeFile();
+
+    static bool _capturing;
+
+    std::string _filename;
+    std::function<void(bool)> _callback;
+    CommandBufferCapture* _commandBuffer = nullptr;
+    CapturedFrame _frame;
+    std::unordered_map<const void*, int> _indices;
+    int _pendingReads = 0;
+};
+
+//end of _backend group
+/// @}
+CC_BACKEND_END
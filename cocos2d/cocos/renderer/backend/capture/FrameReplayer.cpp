@@ -0,0 +1,280 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "FrameReplayer.h"
+#include "../Device.h"
+#include "../Buffer.h"
+#include "../CommandBuffer.h"
+#include "../Program.h"
+#include "../ProgramState.h"
+#include "../RenderPipeline.h"
+#include "base/ccMacros.h"
+
+CC_BACKEND_BEGIN
+
+FrameReplayer::~FrameReplayer()
+{
+    releaseObjects();
+}
+
+bool FrameReplayer::load(const std::string& filename, Device* device)
+{
+    releaseObjects();
+    if (!_frame.load(filename))
+    {
+        CCLOG("FrameReplayer: failed to read %s", filename.c_str());
+        _frame.clear();
+        return false;
+    }
+
+    createObjects(device ? device : Device::getInstance());
+    return true;
+}
+
+void FrameReplayer::releaseObjects()
+{
+    for (auto buffer : _buffers)
+        CC_SAFE_RELEASE(buffer);
+    for (auto texture : _textures)
+        CC_SAFE_RELEASE(texture);
+    for (auto programState : _programStates)
+        CC_SAFE_RELEASE(programState);
+    for (auto program : _programs)
+        CC_SAFE_RELEASE(program);
+    for (auto depthStencilState : _depthStencilStates)
+        CC_SAFE_RELEASE(depthStencilState);
+    _buffers.clear();
+    _textures.clear();
+    _programStates.clear();
+    _programs.clear();
+    _depthStencilStates.clear();
+    CC_SAFE_RELEASE_NULL(_renderPipeline);
+    CC_SAFE_RELEASE_NULL(_commandBuffer);
+}
+
+void FrameReplayer::createObjects(Device* device)
+{
+    _commandBuffer = device->newCommandBuffer();
+    _renderPipeline = device->newRenderPipeline();
+
+    // resources are created with their contents when the frame referenced them first, zeros if they couldn't be read
+    for (const auto& captured : _frame.buffers)
+    {
+        auto buffer = device->newBuffer((std::size_t)captured.size, captured.type, captured.usage);
+        if (buffer && captured.size > 0)
+        {
+            if (captured.contents >= 0 && captured.contents + captured.size <= _frame.payload.size())
+            {
+                buffer->updateData(_frame.payload.data() + captured.contents, (std::size_t)captured.size);
+            }
+            else
+            {
+                std::vector<char> zeros((std::size_t)captured.size, 0);
+                buffer->updateData(zeros.data(), zeros.size());
+            }
+        }
+        _buffers.push_back(buffer);
+    }
+
+    for (const auto& captured : _frame.textures)
+    {
+        if (captured.descriptor.width == 0 || captured.descriptor.height == 0)
+        {
+            _textures.push_back(nullptr);
+            continue;
+        }
+
+        auto texture = device->newTexture(captured.descriptor);
+        uint64_t size = (uint64_t)captured.descriptor.width * captured.descriptor.height * 4;
+        if (texture && captured.contents >= 0 && captured.contents + size <= _frame.payload.size())
+        {
+            auto data = (uint8_t*)_frame.payload.data() + captured.contents;
+            static_cast<Texture2DBackend*>(texture)->updateData(data, captured.descriptor.width, captured.descriptor.height, 0);
+        }
+        _textures.push_back(texture);
+    }
+
+    for (const auto& captured : _frame.programs)
+        _programs.push_back(device->newProgram(captured.vertexShader, captured.fragmentShader));
+
+    for (const auto& captured : _frame.programStates)
+    {
+        auto program = captured.program >= 0 ? _programs[captured.program] : nullptr;
+        if (!program)
+        {
+            _programStates.push_back(nullptr);
+            continue;
+        }
+
+        auto programState = new (std::nothrow) ProgramState(program);
+        if (captured.vertexLayout >= 0)
+            *programState->getVertexLayout() = _frame.vertexLayouts[captured.vertexLayout];
+
+        // uniforms are copied by name, the locations of the new program may differ from the captured ones
+        for (const auto& uniform : _frame.programs[captured.program].uniforms)
+        {
+            bool isVertex = uniform.stage == ShaderStage::VERTEX;
+            int payload = isVertex ? captured.vertexUniforms : captured.fragmentUniforms;
+            uint32_t payloadSize = isVertex ? captured.vertexUniformSize : captured.fragmentUniformSize;
+            if (payload < 0 || uniform.size == 0 || uniform.offset + uniform.size > payloadSize)
+                continue;
+
+            auto location = program->getUniformLocation(uniform.name);
+            if (location)
+                programState->setUniform(location, _frame.payload.data() + payload + uniform.offset, uniform.size);
+        }
+
+        for (const auto& binding : captured.textures)
+        {
+            std::vector<TextureBackend*> textures;
+            for (auto texture : binding.textures)
+                textures.push_back(texture >= 0 ? _textures[texture] : nullptr);
+
+            auto location = program->getUniformLocation(binding.name);
+            if (location)
+                programState->setTextureArray(location, binding.slots, textures);
+        }
+        _programStates.push_back(programState);
+    }
+
+    for (const auto& descriptor : _frame.depthStencilStates)
+    {
+        auto depthStencilState = device->createDepthStencilState(descriptor);
+        CC_SAFE_RETAIN(depthStencilState);
+        _depthStencilStates.push_back(depthStencilState);
+    }
+
+    _commandBuffer->setRenderPipeline(_renderPipeline);
+}
+
+RenderPassDescriptor FrameReplayer::getRenderPass(int index) const
+{
+    const auto& renderPass = _frame.renderPasses[index];
+    RenderPassDescriptor descriptor = renderPass.descriptor;
+    descriptor.depthAttachmentTexture = renderPass.depthAttachment >= 0 ? _textures[renderPass.depthAttachment] : nullptr;
+    descriptor.stencilAttachmentTexture = renderPass.stencilAttachment >= 0 ? _textures[renderPass.stencilAttachment] : nullptr;
+    for (int i = 0; i < MAX_COLOR_ATTCHMENT; ++i)
+    {
+        auto texture = renderPass.colorAttachments[i];
+        descriptor.colorAttachmentsTexture[i] = texture >= 0 ? _textures[texture] : nullptr;
+    }
+    return descriptor;
+}
+
+void FrameReplayer::replay()
+{
+    if (!_commandBuffer)
+        return;
+
+    auto getBuffer = [this](int index) { return index >= 0 ? _buffers[index] : nullptr; };
+    const auto payload = _frame.payload.data();
+    RenderPassDescriptor renderPass;
+
+    for (const auto& command : _frame.commands)
+    {
+        switch (command.type)
+        {
+        case RecordedCommand::Type::BEGIN_FRAME:
+            _commandBuffer->beginFrame();
+            break;
+        case RecordedCommand::Type::END_FRAME:
+            _commandBuffer->endFrame();
+            break;
+        case RecordedCommand::Type::BEGIN_RENDER_PASS:
+            renderPass = getRenderPass(command.renderPass);
+            _commandBuffer->beginRenderPass(renderPass);
+            break;
+        case RecordedCommand::Type::END_RENDER_PASS:
+            _commandBuffer->endRenderPass();
+            break;
+        case RecordedCommand::Type::SET_RENDER_PIPELINE:
+            _commandBuffer->setRenderPipeline(_renderPipeline);
+            break;
+        case RecordedCommand::Type::UPDATE_RENDER_PIPELINE:
+        {
+            const auto& pipeline = _frame.pipelines[command.resource];
+            PipelineDescriptor pipelineDescriptor;
+            pipelineDescriptor.programState = pipeline.programState >= 0 ? _programStates[pipeline.programState] : nullptr;
+            pipelineDescriptor.blendDescriptor = pipeline.blendDescriptor;
+            if (pipelineDescriptor.programState)
+                _renderPipeline->update(pipelineDescriptor, renderPass);
+            break;
+        }
+        case RecordedCommand::Type::SET_VIEWPORT:
+            _commandBuffer->setViewport((int)command.values[0], (int)command.values[1], (unsigned int)command.values[2], (unsigned int)command.values[3]);
+            break;
+        case RecordedCommand::Type::SET_CULL_MODE:
+            _commandBuffer->setCullMode((CullMode)command.value);
+            break;
+        case RecordedCommand::Type::SET_WINDING:
+            _commandBuffer->setWinding((Winding)command.value);
+            break;
+        case RecordedCommand::Type::SET_VERTEX_BUFFER:
+            _commandBuffer->setVertexBuffer(getBuffer(command.resource));
+            break;
+        case RecordedCommand::Type::SET_INDEX_BUFFER:
+            _commandBuffer->setIndexBuffer(getBuffer(command.resource));
+            break;
+        case RecordedCommand::Type::SET_INSTANCE_BUFFER:
+            _commandBuffer->setInstanceBuffer(getBuffer(command.resource), _frame.vertexLayouts[command.value], nullptr);
+            break;
+        case RecordedCommand::Type::SET_PROGRAM_STATE:
+            _commandBuffer->setProgramState(command.resource >= 0 ? _programStates[command.resource] : nullptr);
+            break;
+        case RecordedCommand::Type::SET_LINE_WIDTH:
+            _commandBuffer->setLineWidth(command.values[0]);
+            break;
+        case RecordedCommand::Type::SET_SCISSOR_RECT:
+            _commandBuffer->setScissorRect(command.value != 0, command.values[0], command.values[1], command.values[2], command.values[3]);
+            break;
+        case RecordedCommand::Type::SET_DEPTH_STENCIL_STATE:
+            _commandBuffer->setDepthStencilState(command.resource >= 0 ? _depthStencilStates[command.resource] : nullptr);
+            break;
+        case RecordedCommand::Type::SET_STENCIL_REFERENCE:
+            _commandBuffer->setStencilReferenceValue((unsigned int)command.values[0], (unsigned int)command.values[1]);
+            break;
+        case RecordedCommand::Type::DRAW_ARRAYS:
+            _commandBuffer->drawArrays(command.primitiveType, command.offset, command.count);
+            break;
+        case RecordedCommand::Type::DRAW_ELEMENTS:
+            _commandBuffer->drawElements(command.primitiveType, command.indexFormat, command.count, command.offset);
+            break;
+        case RecordedCommand::Type::DRAW_ELEMENTS_INSTANCED:
+            _commandBuffer->drawElementsInstanced(command.primitiveType, command.indexFormat, command.count, command.offset, command.instanceCount);
+            break;
+        case RecordedCommand::Type::UPDATE_BUFFER:
+        {
+            auto buffer = getBuffer(command.resource);
+            if (buffer && command.payload >= 0)
+                buffer->updateSubData(payload + command.payload, command.offset, command.count);
+            break;
+        }
+        default:
+            // texture updates of the frame and screen captures are not replayed
+            break;
+        }
+    }
+}
+
+CC_BACKEND_END
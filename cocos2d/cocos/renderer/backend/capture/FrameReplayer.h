@@ -0,0 +1,95 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "CapturedFrame.h"
+
+#include <string>
+#include <vector>
+
+CC_BACKEND_BEGIN
+
+class Buffer;
+class CommandBuffer;
+class Device;
+class Program;
+class ProgramState;
+class RenderPipeline;
+
+/**
+ * @addtogroup _backend
+ * @{
+ */
+
+/**
+ * Execute a frame written by FrameCapture on a device, as many times as needed.
+ * @code
+ * backend::FrameReplayer replayer;
+ * if (replayer.load(filename))
+ * {
+ *     for (int i = 0; i < 1000; ++i)
+ *         replayer.replay();
+ * }
+ * @endcode
+ * The backend objects are created by load(), so that replay() only issues the recorded calls and buffer updates.
+ */
+class FrameReplayer
+{
+public:
+    FrameReplayer() = default;
+    ~FrameReplayer();
+
+    /**
+     * Read a captured frame and create its backend objects.
+     * @param filename Specifies the path of the file.
+     * @param device Specifies the device creating the backend objects, the shared device is used by default.
+     * @return true if succeeded.
+     */
+    bool load(const std::string& filename, Device* device = nullptr);
+
+    /// Issue the calls of the frame once, between the beginning and the end of the frame.
+    void replay();
+
+    /// Get the loaded frame.
+    inline const CapturedFrame& getFrame() const { return _frame; }
+
+private:
+    void createObjects(Device* device);
+    void releaseObjects();
+    RenderPassDescriptor getRenderPass(int index) const;
+
+    CapturedFrame _frame;
+    CommandBuffer* _commandBuffer = nullptr;
+    RenderPipeline* _renderPipeline = nullptr;
+    std::vector<Buffer*> _buffers;
+    std::vector<TextureBackend*> _textures;
+    std::vector<Program*> _programs;
+    std::vector<ProgramState*> _programStates;
+    std::vector<DepthStencilState*> _depthStencilStates;
+};
+
+//end of _backend group
+/// @}
+CC_BACKEND_END
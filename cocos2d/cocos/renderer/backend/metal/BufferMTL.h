@@ -75,6 +75,19 @@ public:
      * Emply implementation. Mainly used in EGL context lost.
      */
     virtual void usingDefaultStoredData(bool needDefaultStoredData) override {};
+
+    /**
+     * Empty implementation. Dynamic buffers are already triple buffered.
+     */
+    virtual void orphanData() override {}
+
+    /**
+     * Read back the contents of the buffer of the current frame.
+     * @param data Specifies a pointer to the memory the contents are copied to.
+     * @param size Specifies the size in bytes of the memory.
+     * @return The number of bytes read.
+     */
+    virtual std::size_t getData(void* data, std::size_t size) const override;
     
     /// @name Setters & Getters
     id<MTLBuffer> getMTLBuffer() const;
@@ -25,6 +25,9 @@
 #include "BufferMTL.h"
 #include "../Macros.h"
 #include "BufferManager.h"
+#include "../capture/FrameCapture.h"
+
+#include <algorithm>
 
 CC_BACKEND_BEGIN
 
@@ -73,6 +76,9 @@ void BufferMTL::updateData(void* data, std::size_t size)
     assert(size <= _size);
     updateIndex();
     memcpy((uint8_t*)_mtlBuffer.contents, data, size);
+
+    if (FrameCapture::isCapturing())
+        FrameCapture::getInstance()->recordBufferUpdate(this, data, 0, size);
 }
 
 void BufferMTL::updateSubData(void* data, std::size_t offset, std::size_t size)
@@ -80,6 +86,16 @@ void BufferMTL::updateSubData(void* data, std::size_t offset, std::size_t size)
     assert(offset + size <= _size);
     updateIndex();
     memcpy((uint8_t*)_mtlBuffer.contents + offset, data, size);
+
+    if (FrameCapture::isCapturing())
+        FrameCapture::getInstance()->recordBufferUpdate(this, data, offset, size);
+}
+
+std::size_t BufferMTL::getData(void* data, std::size_t size) const
+{
+    size = std::min(size, _size);
+    memcpy(data, _mtlBuffer.contents, size);
+    return size;
 }
 
 id<MTLBuffer> BufferMTL::getMTLBuffer() const
@@ -0,0 +1,70 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "BufferNull.h"
+#include "CommandRecorder.h"
+#include "../capture/FrameCapture.h"
+#include "base/ccMacros.h"
+
+CC_BACKEND_BEGIN
+
+BufferNull::BufferNull(CommandRecorder* recorder, std::size_t size, BufferType type, BufferUsage usage)
+: Buffer(size, type, usage)
+, _recorder(recorder)
+{
+}
+
+void BufferNull::updateData(void* data, std::size_t size)
+{
+    CCASSERT(size && size <= _size, "buffer size overflow");
+
+    _bufferAllocated = size;
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::UPDATE_BUFFER;
+    command.object = this;
+    command.count = size;
+    _recorder->record(command, data, size);
+
+    if (FrameCapture::isCapturing())
+        FrameCapture::getInstance()->recordBufferUpdate(this, data, 0, size);
+}
+
+void BufferNull::updateSubData(void* data, std::size_t offset, std::size_t size)
+{
+    CCASSERT(_bufferAllocated != 0, "updateData should be invoke before updateSubData");
+    CCASSERT(offset + size <= _bufferAllocated, "buffer size overflow");
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::UPDATE_BUFFER;
+    command.object = this;
+    command.offset = offset;
+    command.count = size;
+    _recorder->record(command, data, size);
+
+    if (FrameCapture::isCapturing())
+        FrameCapture::getInstance()->recordBufferUpdate(this, data, offset, size);
+}
+
+CC_BACKEND_END
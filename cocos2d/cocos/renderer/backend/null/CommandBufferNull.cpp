@@ -0,0 +1,195 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CommandBufferNull.h"
+#include "../ProgramState.h"
+
+#include <vector>
+
+CC_BACKEND_BEGIN
+
+CommandBufferNull::CommandBufferNull(CommandRecorder* recorder)
+: _recorder(recorder)
+{
+}
+
+void CommandBufferNull::record(RecordedCommand::Type type, const void* object)
+{
+    RecordedCommand command;
+    command.type = type;
+    command.object = object;
+    _recorder->record(command);
+}
+
+void CommandBufferNull::beginFrame()
+{
+    record(RecordedCommand::Type::BEGIN_FRAME);
+}
+
+void CommandBufferNull::beginRenderPass(const RenderPassDescriptor& descriptor)
+{
+    _recorder->recordRenderPass(descriptor);
+}
+
+void CommandBufferNull::setRenderPipeline(RenderPipeline* renderPipeline)
+{
+    record(RecordedCommand::Type::SET_RENDER_PIPELINE, renderPipeline);
+}
+
+void CommandBufferNull::setViewport(int x, int y, unsigned int w, unsigned int h)
+{
+    _viewportWidth = w;
+    _viewportHeight = h;
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_VIEWPORT;
+    command.values[0] = (float)x;
+    command.values[1] = (float)y;
+    command.values[2] = (float)w;
+    command.values[3] = (float)h;
+    _recorder->record(command);
+}
+
+void CommandBufferNull::setCullMode(CullMode mode)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_CULL_MODE;
+    command.value = (uint32_t)mode;
+    _recorder->record(command);
+}
+
+void CommandBufferNull::setWinding(Winding winding)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_WINDING;
+    command.value = (uint32_t)winding;
+    _recorder->record(command);
+}
+
+void CommandBufferNull::setVertexBuffer(Buffer* buffer)
+{
+    record(RecordedCommand::Type::SET_VERTEX_BUFFER, buffer);
+}
+
+void CommandBufferNull::setProgramState(ProgramState* programState)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_PROGRAM_STATE;
+    command.object = programState;
+
+    char* uniformBuffer = nullptr;
+    std::size_t size = 0;
+    if (programState && _recorder->isPayloadEnabled())
+        programState->getVertexUniformBuffer(&uniformBuffer, size);
+    command.count = size;
+    _recorder->record(command, uniformBuffer, size);
+}
+
+void CommandBufferNull::setIndexBuffer(Buffer* buffer)
+{
+    record(RecordedCommand::Type::SET_INDEX_BUFFER, buffer);
+}
+
+void CommandBufferNull::setInstanceBuffer(Buffer* buffer, const VertexLayout& layout, const void* data)
+{
+    record(RecordedCommand::Type::SET_INSTANCE_BUFFER, buffer);
+}
+
+void CommandBufferNull::drawArrays(PrimitiveType primitiveType, std::size_t start,  std::size_t count)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::DRAW_ARRAYS;
+    command.primitiveType = primitiveType;
+    command.offset = start;
+    command.count = count;
+    _recorder->record(command);
+}
+
+void CommandBufferNull::drawElements(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::DRAW_ELEMENTS;
+    command.primitiveType = primitiveType;
+    command.indexFormat = indexType;
+    command.offset = offset;
+    command.count = count;
+    _recorder->record(command);
+}
+
+void CommandBufferNull::drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::DRAW_ELEMENTS_INSTANCED;
+    command.primitiveType = primitiveType;
+    command.indexFormat = indexType;
+    command.offset = offset;
+    command.count = count;
+    command.instanceCount = instanceCount;
+    _recorder->record(command);
+}
+
+void CommandBufferNull::endRenderPass()
+{
+    record(RecordedCommand::Type::END_RENDER_PASS);
+}
+
+void CommandBufferNull::endFrame()
+{
+    record(RecordedCommand::Type::END_FRAME);
+}
+
+void CommandBufferNull::setLineWidth(float lineWidth)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_LINE_WIDTH;
+    command.values[0] = lineWidth;
+    _recorder->record(command);
+}
+
+void CommandBufferNull::setScissorRect(bool isEnabled, float x, float y, float width, float height)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::SET_SCISSOR_RECT;
+    command.value = isEnabled ? 1 : 0;
+    command.values[0] = x;
+    command.values[1] = y;
+    command.values[2] = width;
+    command.values[3] = height;
+    _recorder->record(command);
+}
+
+void CommandBufferNull::setDepthStencilState(DepthStencilState* depthStencilState)
+{
+    record(RecordedCommand::Type::SET_DEPTH_STENCIL_STATE, depthStencilState);
+}
+
+void CommandBufferNull::captureScreen(std::function<void(const unsigned char*, int, int)> callback)
+{
+    record(RecordedCommand::Type::CAPTURE_SCREEN);
+
+    std::vector<unsigned char> image(_viewportWidth * _viewportHeight * 4, 0);
+    callback(image.data(), _viewportWidth, _viewportHeight);
+}
+
+CC_BACKEND_END
@@ -0,0 +1,106 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CommandRecorder.h"
+
+#include <string.h>
+
+CC_BACKEND_BEGIN
+
+void CommandRecorder::record(RecordedCommand& command, const void* data, std::size_t size)
+{
+    updateStats(command);
+
+    if (!_recordingEnabled)
+        return;
+
+    if (_payloadEnabled && data && size)
+    {
+        command.payload = (int)_payload.size();
+        _payload.resize(_payload.size() + size);
+        memcpy(_payload.data() + command.payload, data, size);
+    }
+    _commands.push_back(command);
+}
+
+void CommandRecorder::recordRenderPass(const RenderPassDescriptor& descriptor)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::BEGIN_RENDER_PASS;
+    if (_recordingEnabled)
+    {
+        command.renderPass = (int)_renderPasses.size();
+        _renderPasses.push_back(descriptor);
+    }
+    record(command);
+}
+
+void CommandRecorder::clear()
+{
+    _commands.clear();
+    _renderPasses.clear();
+    _payload.clear();
+    _stats = Stats();
+}
+
+void CommandRecorder::updateStats(const RecordedCommand& command)
+{
+    switch (command.type)
+    {
+        case RecordedCommand::Type::BEGIN_FRAME:
+            ++_stats.frames;
+            break;
+        case RecordedCommand::Type::BEGIN_RENDER_PASS:
+            ++_stats.renderPasses;
+            break;
+        case RecordedCommand::Type::SET_RENDER_PIPELINE:
+            ++_stats.pipelineChanges;
+            break;
+        case RecordedCommand::Type::SET_PROGRAM_STATE:
+            ++_stats.programStateChanges;
+            break;
+        case RecordedCommand::Type::DRAW_ARRAYS:
+        case RecordedCommand::Type::DRAW_ELEMENTS:
+            ++_stats.drawCalls;
+            _stats.drawnVertices += command.count;
+            break;
+        case RecordedCommand::Type::DRAW_ELEMENTS_INSTANCED:
+            ++_stats.drawCalls;
+            ++_stats.instancedDrawCalls;
+            _stats.drawnVertices += command.count * command.instanceCount;
+            break;
+        case RecordedCommand::Type::UPDATE_BUFFER:
+            ++_stats.bufferUpdates;
+            _stats.bufferUpdateBytes += command.count;
+            break;
+        case RecordedCommand::Type::UPDATE_TEXTURE:
+            ++_stats.textureUpdates;
+            _stats.textureUpdateBytes += command.count;
+            break;
+        default:
+            break;
+    }
+}
+
+CC_BACKEND_END
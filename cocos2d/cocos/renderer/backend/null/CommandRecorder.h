@@ -0,0 +1,148 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Macros.h"
+#include "../Types.h"
+#include "../RenderPassDescriptor.h"
+
+#include <vector>
+
+CC_BACKEND_BEGIN
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * A backend call recorded by the null backend.
+ * Object pointers are only used to identify the objects, they are not retained and may be released afterwards.
+ */
+struct RecordedCommand
+{
+    enum class Type : uint32_t
+    {
+        BEGIN_FRAME,
+        END_FRAME,
+        BEGIN_RENDER_PASS,
+        END_RENDER_PASS,
+        SET_RENDER_PIPELINE,
+        UPDATE_RENDER_PIPELINE,
+        SET_VIEWPORT,
+        SET_CULL_MODE,
+        SET_WINDING,
+        SET_VERTEX_BUFFER,
+        SET_INDEX_BUFFER,
+        SET_INSTANCE_BUFFER,
+        SET_PROGRAM_STATE,
+        SET_LINE_WIDTH,
+        SET_SCISSOR_RECT,
+        SET_DEPTH_STENCIL_STATE,
+        SET_STENCIL_REFERENCE,
+        DRAW_ARRAYS,
+        DRAW_ELEMENTS,
+        DRAW_ELEMENTS_INSTANCED,
+        UPDATE_BUFFER,
+        UPDATE_TEXTURE,
+        CAPTURE_SCREEN
+    };
+
+    Type type = Type::BEGIN_FRAME;
+    const void* object = nullptr;           ///< buffer, render pipeline, program state, depth stencil state or texture.
+    PrimitiveType primitiveType = PrimitiveType::TRIANGLE;
+    IndexFormat indexFormat = IndexFormat::U_SHORT;
+    std::size_t offset = 0;                 ///< start of draw arrays, offset of draw elements or of buffer update.
+    std::size_t count = 0;                  ///< vertex or index count of draw, size in bytes of update.
+    std::size_t instanceCount = 0;
+    float values[4] = {0.f, 0.f, 0.f, 0.f}; ///< viewport, scissor rect, line width or front and back stencil reference values.
+    uint32_t value = 0;                     ///< cull mode, winding, whether scissor test is enabled or index of the instance layout.
+    int renderPass = -1;                    ///< index of the render pass descriptor, @see CommandRecorder::getRenderPasses().
+    int payload = -1;                       ///< offset of the copied data in the payload, @see CommandRecorder::getPayload().
+    int resource = -1;                      ///< index of the object in the tables of a captured frame, @see CapturedFrame.
+};
+
+/**
+ * Store the backend calls of the null backend in memory.
+ */
+class CommandRecorder
+{
+public:
+    /// Counters of the recorded calls.
+    struct Stats
+    {
+        unsigned int frames = 0;
+        unsigned int renderPasses = 0;
+        unsigned int drawCalls = 0;
+        unsigned int instancedDrawCalls = 0;
+        std::size_t drawnVertices = 0;
+        unsigned int pipelineChanges = 0;
+        unsigned int programStateChanges = 0;
+        unsigned int bufferUpdates = 0;
+        std::size_t bufferUpdateBytes = 0;
+        unsigned int textureUpdates = 0;
+        std::size_t textureUpdateBytes = 0;
+    };
+
+    /**
+     * Append a call. If data is not null and payload recording is enabled, size bytes of data are copied.
+     */
+    void record(RecordedCommand& command, const void* data = nullptr, std::size_t size = 0);
+
+    /// Append a render pass, the descriptor is copied.
+    void recordRenderPass(const RenderPassDescriptor& descriptor);
+
+    /// Remove all recorded calls, render passes and payload, and reset the counters.
+    void clear();
+
+    /**
+     * Enable or disable recording the calls. Counters are updated even if recording is disabled.
+     * Disabled recording is useful to benchmark the renderer without growing memory.
+     */
+    inline void setRecordingEnabled(bool enabled) { _recordingEnabled = enabled; }
+    inline bool isRecordingEnabled() const { return _recordingEnabled; }
+
+    /// Whether buffer and texture data are copied into the payload, false by default.
+    inline void setPayloadEnabled(bool enabled) { _payloadEnabled = enabled; }
+    inline bool isPayloadEnabled() const { return _payloadEnabled; }
+
+    inline const std::vector<RecordedCommand>& getCommands() const { return _commands; }
+    inline const std::vector<RenderPassDescriptor>& getRenderPasses() const { return _renderPasses; }
+    inline const std::vector<char>& getPayload() const { return _payload; }
+    inline const Stats& getStats() const { return _stats; }
+
+private:
+    void updateStats(const RecordedCommand& command);
+
+    std::vector<RecordedCommand> _commands;
+    std::vector<RenderPassDescriptor> _renderPasses;
+    std::vector<char> _payload;
+    Stats _stats;
+    bool _recordingEnabled = true;
+    bool _payloadEnabled = false;
+};
+
+//end of _null group
+/// @}
+CC_BACKEND_END
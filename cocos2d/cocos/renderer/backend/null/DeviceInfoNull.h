@@ -0,0 +1,59 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../DeviceInfo.h"
+
+CC_BACKEND_BEGIN
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * Device information of the null backend, no compressed texture format or extension is supported.
+ */
+class DeviceInfoNull: public DeviceInfo
+{
+public:
+    DeviceInfoNull() = default;
+    virtual ~DeviceInfoNull() = default;
+
+    virtual bool init() override;
+
+    virtual const char* getVendor() const override { return "cocos2d-x"; }
+
+    virtual const char* getRenderer() const override { return "null"; }
+
+    virtual const char* getVersion() const override { return "1.0"; }
+
+    virtual const char* getExtension() const override { return ""; }
+
+    virtual bool checkForFeatureSupported(FeatureType feature) override;
+};
+
+//end of _null group
+/// @}
+CC_BACKEND_END
@@ -0,0 +1,101 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "DeviceNull.h"
+#include "DeviceInfoNull.h"
+#include "BufferNull.h"
+#include "CommandBufferNull.h"
+#include "TextureNull.h"
+#include "ProgramNull.h"
+#include "RenderPipelineNull.h"
+#include "ShaderModuleNull.h"
+#include "DepthStencilStateNull.h"
+
+CC_BACKEND_BEGIN
+
+DeviceNull::DeviceNull()
+{
+    _deviceInfo = new (std::nothrow) DeviceInfoNull();
+    if(!_deviceInfo || _deviceInfo->init() == false)
+    {
+        delete _deviceInfo;
+        _deviceInfo = nullptr;
+    }
+}
+
+DeviceNull::~DeviceNull()
+{
+    ProgramCache::destroyInstance();
+    delete _deviceInfo;
+    _deviceInfo = nullptr;
+}
+
+CommandBuffer* DeviceNull::newCommandBuffer()
+{
+    return new (std::nothrow) CommandBufferNull(&_recorder);
+}
+
+Buffer* DeviceNull::newBuffer(std::size_t size, BufferType type, BufferUsage usage)
+{
+    return new (std::nothrow) BufferNull(&_recorder, size, type, usage);
+}
+
+TextureBackend* DeviceNull::newTexture(const TextureDescriptor& descriptor)
+{
+    switch (descriptor.textureType)
+    {
+    case TextureType::TEXTURE_2D:
+        return new (std::nothrow) Texture2DNull(&_recorder, descriptor);
+    case TextureType::TEXTURE_CUBE:
+        return new (std::nothrow) TextureCubeNull(&_recorder, descriptor);
+    default:
+        return nullptr;
+    }
+}
+
+ShaderModule* DeviceNull::newShaderModule(ShaderStage stage, const std::string& source)
+{
+    return new (std::nothrow) ShaderModuleNull(stage);
+}
+
+DepthStencilState* DeviceNull::createDepthStencilState(const DepthStencilDescriptor& descriptor)
+{
+    auto ret = new (std::nothrow) DepthStencilStateNull(descriptor);
+    if (ret)
+        ret->autorelease();
+
+    return ret;
+}
+
+RenderPipeline* DeviceNull::newRenderPipeline()
+{
+    return new (std::nothrow) RenderPipelineNull();
+}
+
+Program* DeviceNull::newProgram(const std::string& vertexShader, const std::string& fragmentShader)
+{
+    return new (std::nothrow) ProgramNull(vertexShader, fragmentShader);
+}
+
+CC_BACKEND_END
@@ -0,0 +1,77 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Device.h"
+#include "CommandRecorder.h"
+
+CC_BACKEND_BEGIN
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * A device without GPU. The created objects don't render anything, calls to them are recorded by a CommandRecorder.
+ * It is used to run the renderer on machines without GPU, i.e. for testing and benchmarking the renderer.
+ * @code
+ * backend::Device::setInstance(new backend::DeviceNull());
+ * @endcode
+ */
+class DeviceNull : public Device
+{
+public:
+    DeviceNull();
+    ~DeviceNull();
+
+    virtual CommandBuffer* newCommandBuffer() override;
+
+    virtual Buffer* newBuffer(std::size_t size, BufferType type, BufferUsage usage) override;
+
+    virtual TextureBackend* newTexture(const TextureDescriptor& descriptor) override;
+
+    virtual DepthStencilState* createDepthStencilState(const DepthStencilDescriptor& descriptor) override;
+
+    virtual RenderPipeline* newRenderPipeline() override;
+
+    virtual void setFrameBufferOnly(bool frameBufferOnly) override {}
+
+    virtual Program* newProgram(const std::string& vertexShader, const std::string& fragmentShader) override;
+
+    /**
+     * Get the recorder shared by all objects created by the device.
+     * @return The command recorder.
+     */
+    inline CommandRecorder& getRecorder() { return _recorder; }
+
+protected:
+    virtual ShaderModule* newShaderModule(ShaderStage stage, const std::string& source) override;
+
+private:
+    CommandRecorder _recorder;
+};
+//end of _null group
+/// @}
+CC_BACKEND_END
@@ -0,0 +1,335 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ProgramNull.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    struct DataType
+    {
+        const char* name;
+        unsigned int type;  // the GL enum, so that uniform infos look like the ones of the opengl backend
+        unsigned int size;  // same as UtilsGL::getGLDataTypeSize()
+    };
+
+    const DataType DATA_TYPES[] = {
+        {"float", 0x1406, 4},  {"vec2", 0x8B50, 8},  {"vec3", 0x8B51, 12}, {"vec4", 0x8B52, 16},
+        {"int", 0x1404, 4},    {"ivec2", 0x8B53, 8}, {"ivec3", 0x8B54, 12}, {"ivec4", 0x8B55, 16},
+        {"bool", 0x8B56, 1},   {"bvec2", 0x8B57, 2}, {"bvec3", 0x8B58, 1},  {"bvec4", 0x8B59, 4},
+        {"mat2", 0x8B5A, 16},  {"mat3", 0x8B5B, 36}, {"mat4", 0x8B5C, 64},
+        {"sampler2D", 0x8B5E, 0}, {"samplerCube", 0x8B60, 0},
+    };
+
+    const DataType* findDataType(const std::string& name)
+    {
+        for (const auto& dataType : DATA_TYPES)
+        {
+            if (name == dataType.name)
+                return &dataType;
+        }
+        return nullptr;
+    }
+
+    bool isIdentifierChar(char c)
+    {
+        return isalnum((unsigned char)c) || c == '_';
+    }
+
+    std::string stripComments(const std::string& source)
+    {
+        std::string ret;
+        ret.reserve(source.size());
+        for (std::size_t i = 0; i < source.size(); ++i)
+        {
+            if (source[i] == '/' && i + 1 < source.size() && source[i + 1] == '/')
+            {
+                while (i < source.size() && source[i] != '\n')
+                    ++i;
+                ret += '\n';
+            }
+            else if (source[i] == '/' && i + 1 < source.size() && source[i + 1] == '*')
+            {
+                i += 2;
+                while (i + 1 < source.size() && !(source[i] == '*' && source[i + 1] == '/'))
+                    ++i;
+                ++i;
+                ret += ' ';
+            }
+            else
+            {
+                ret += source[i];
+            }
+        }
+        return ret;
+    }
+
+    std::vector<std::string> tokenize(const std::string& statement)
+    {
+        std::vector<std::string> tokens;
+        std::size_t i = 0;
+        while (i < statement.size())
+        {
+            if (isspace((unsigned char)statement[i]))
+            {
+                ++i;
+            }
+            else if (isIdentifierChar(statement[i]))
+            {
+                auto start = i;
+                while (i < statement.size() && isIdentifierChar(statement[i]))
+                    ++i;
+                tokens.push_back(statement.substr(start, i - start));
+            }
+            else
+            {
+                tokens.push_back(std::string(1, statement[i++]));
+            }
+        }
+        return tokens;
+    }
+}
+
+ProgramNull::ProgramNull(const std::string& vertexShader, const std::string& fragmentShader)
+: Program(vertexShader, fragmentShader)
+{
+    parseShader(_vertexShader, true);
+    parseShader(_fragmentShader, false);
+    computeLocations();
+}
+
+void ProgramNull::parseShader(const std::string& source, bool isVertexShader)
+{
+    auto stripped = stripComments(source);
+
+    // collect numeric defines, they may be used as array sizes
+    std::size_t lineStart = 0;
+    std::string code;
+    code.reserve(stripped.size());
+    while (lineStart < stripped.size())
+    {
+        auto lineEnd = stripped.find('\n', lineStart);
+        if (lineEnd == std::string::npos)
+            lineEnd = stripped.size();
+        auto line = stripped.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
+        auto tokens = tokenize(line);
+        if (!tokens.empty() && tokens[0] == "#")
+        {
+            if (tokens.size() >= 4 && tokens[1] == "define" && isdigit((unsigned char)tokens[3][0]))
+                _defines[tokens[2]] = atoi(tokens[3].c_str());
+            continue;
+        }
+        code += line;
+        code += '\n';
+    }
+
+    auto evaluate = [this](const std::vector<std::string>& tokens, std::size_t begin, std::size_t end) {
+        int value = 1;
+        for (auto i = begin; i < end; ++i)
+        {
+            if (tokens[i] == "*" || tokens[i] == "(" || tokens[i] == ")")
+                continue;
+            if (isdigit((unsigned char)tokens[i][0]))
+                value *= atoi(tokens[i].c_str());
+            else if (_defines.find(tokens[i]) != _defines.end())
+                value *= _defines[tokens[i]];
+        }
+        return value;
+    };
+
+    std::size_t statementStart = 0;
+    while (statementStart < code.size())
+    {
+        auto statementEnd = code.find(';', statementStart);
+        if (statementEnd == std::string::npos)
+            break;
+        auto tokens = tokenize(code.substr(statementStart, statementEnd - statementStart));
+        statementStart = statementEnd + 1;
+
+        auto qualifier = std::find_if(tokens.begin(), tokens.end(), [](const std::string& token) {
+            return token == "uniform" || token == "attribute";
+        });
+        if (qualifier == tokens.end())
+            continue;
+
+        bool isUniform = *qualifier == "uniform";
+        if (!isUniform && !isVertexShader)
+            continue;
+
+        // skip precision qualifier
+        std::size_t i = qualifier - tokens.begin() + 1;
+        while (i < tokens.size() && (tokens[i] == "lowp" || tokens[i] == "mediump" || tokens[i] == "highp"))
+            ++i;
+        if (i >= tokens.size())
+            continue;
+
+        const auto dataType = findDataType(tokens[i++]);
+        if (!dataType)
+            continue;
+
+        // a statement may declare several variables: uniform vec4 a, b[2];
+        while (i < tokens.size())
+        {
+            const auto& name = tokens[i++];
+            int count = 1;
+            bool isArray = false;
+            if (i < tokens.size() && tokens[i] == "[")
+            {
+                auto close = std::find(tokens.begin() + i, tokens.end(), "]") - tokens.begin();
+                count = evaluate(tokens, i + 1, close);
+                isArray = true;
+                i = close + 1;
+            }
+            while (i < tokens.size() && tokens[i] != ",")
+                ++i;
+            ++i;
+
+            if (isUniform)
+            {
+                if (_activeUniformInfos.find(name) != _activeUniformInfos.end())
+                    continue;
+
+                UniformInfo uniform;
+                uniform.count = count;
+                uniform.isArray = isArray;
+                uniform.type = dataType->type;
+                uniform.size = dataType->size;
+                uniform.location = _maxLocation < 0 ? 0 : _maxLocation;
+                uniform.bufferOffset = (uniform.size == 0) ? 0 : _totalBufferSize;
+                _activeUniformInfos[name] = uniform;
+                _totalBufferSize += uniform.size * uniform.count;
+                _maxLocation = uniform.location + count;
+            }
+            else if (_activeAttributes.find(name) == _activeAttributes.end())
+            {
+                AttributeBindInfo info;
+                info.attributeName = name;
+                info.location = (int)_activeAttributes.size();
+                info.type = dataType->type;
+                info.size = dataType->size * count;
+                _activeAttributes[name] = info;
+            }
+        }
+    }
+}
+
+void ProgramNull::computeLocations()
+{
+    std::fill(_builtinAttributeLocation, _builtinAttributeLocation + ATTRIBUTE_MAX, -1);
+
+    _builtinAttributeLocation[Attribute::POSITION] = getAttributeLocation(ATTRIBUTE_NAME_POSITION);
+    _builtinAttributeLocation[Attribute::COLOR] = getAttributeLocation(ATTRIBUTE_NAME_COLOR);
+    _builtinAttributeLocation[Attribute::TEXCOORD] = getAttributeLocation(ATTRIBUTE_NAME_TEXCOORD);
+
+    _builtinUniformLocation[Uniform::MVP_MATRIX] = getUniformLocation(UNIFORM_NAME_MVP_MATRIX);
+    _builtinUniformLocation[Uniform::TEXT_COLOR] = getUniformLocation(UNIFORM_NAME_TEXT_COLOR);
+    _builtinUniformLocation[Uniform::EFFECT_COLOR] = getUniformLocation(UNIFORM_NAME_EFFECT_COLOR);
+    _builtinUniformLocation[Uniform::EFFECT_TYPE] = getUniformLocation(UNIFORM_NAME_EFFECT_TYPE);
+    _builtinUniformLocation[Uniform::TEXTURE] = getUniformLocation(UNIFORM_NAME_TEXTURE);
+    _builtinUniformLocation[Uniform::TEXTURE1] = getUniformLocation(UNIFORM_NAME_TEXTURE1);
+}
+
+int ProgramNull::getAttributeLocation(Attribute name) const
+{
+    return _builtinAttributeLocation[name];
+}
+
+int ProgramNull::getAttributeLocation(const std::string& name) const
+{
+    auto iter = _activeAttributes.find(name);
+    return iter != _activeAttributes.end() ? iter->second.location : -1;
+}
+
+const std::unordered_map<std::string, AttributeBindInfo> ProgramNull::getActiveAttributes() const
+{
+    return _activeAttributes;
+}
+
+UniformLocation ProgramNull::getUniformLocation(backend::Uniform name) const
+{
+    return _builtinUniformLocation[name];
+}
+
+UniformLocation ProgramNull::getUniformLocation(const std::string& uniform) const
+{
+    UniformLocation uniformLocation;
+    auto iter = _activeUniformInfos.find(uniform);
+    if (iter != _activeUniformInfos.end())
+    {
+        uniformLocation.location[0] = iter->second.location;
+        uniformLocation.location[1] = iter->second.bufferOffset;
+    }
+    return uniformLocation;
+}
+
+int ProgramNull::getMaxVertexLocation() const
+{
+    return _maxLocation;
+}
+
+int ProgramNull::getMaxFragmentLocation() const
+{
+    return _maxLocation;
+}
+
+const UniformInfo& ProgramNull::getActiveUniformInfo(ShaderStage stage, int location) const
+{
+    for (const auto& uniform : _activeUniformInfos)
+    {
+        if (uniform.second.location == location)
+            return uniform.second;
+    }
+
+    static const UniformInfo EMPTY_UNIFORM_INFO;
+    return EMPTY_UNIFORM_INFO;
+}
+
+const std::unordered_map<std::string, UniformInfo>& ProgramNull::getAllActiveUniformInfo(ShaderStage stage) const
+{
+    return _activeUniformInfos;
+}
+
+std::size_t ProgramNull::getUniformBufferSize(ShaderStage stage) const
+{
+    return _totalBufferSize;
+}
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+const std::unordered_map<std::string, int> ProgramNull::getAllUniformsLocation() const
+{
+    std::unordered_map<std::string, int> locations;
+    for (const auto& uniform : _activeUniformInfos)
+        locations[uniform.first] = uniform.second.location;
+    return locations;
+}
+#endif
+
+CC_BACKEND_END
@@ -0,0 +1,131 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "TextureNull.h"
+#include "CommandRecorder.h"
+
+#include <vector>
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    void readZeros(std::size_t width, std::size_t height, std::function<void(const unsigned char*, std::size_t, std::size_t)>& callback)
+    {
+        // flipping zeros is a no-op, the format of read back pixels is always RGBA8888
+        std::vector<unsigned char> image(width * height * 4, 0);
+        callback(image.data(), width, height);
+    }
+}
+
+Texture2DNull::Texture2DNull(CommandRecorder* recorder, const TextureDescriptor& descriptor)
+: Texture2DBackend(descriptor)
+, _recorder(recorder)
+{
+    _isCompressed = PixelFormat::PVRTC4 <= descriptor.textureFormat && descriptor.textureFormat <= PixelFormat::ATC_INTERPOLATED_ALPHA;
+}
+
+void Texture2DNull::recordUpdate(const void* data, std::size_t size)
+{
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::UPDATE_TEXTURE;
+    command.object = this;
+    command.count = size;
+    _recorder->record(command, data, size);
+}
+
+void Texture2DNull::updateData(uint8_t* data, std::size_t width , std::size_t height, std::size_t level)
+{
+    recordUpdate(data, width * height * _bitsPerElement / 8);
+    if(level > 0)
+        _hasMipmaps = true;
+}
+
+void Texture2DNull::updateCompressedData(uint8_t* data, std::size_t width , std::size_t height, std::size_t dataLen, std::size_t level)
+{
+    recordUpdate(data, dataLen);
+    if(level > 0)
+        _hasMipmaps = true;
+}
+
+void Texture2DNull::updateSubData(std::size_t xoffset, std::size_t yoffset, std::size_t width, std::size_t height, std::size_t level, uint8_t* data)
+{
+    recordUpdate(data, width * height * _bitsPerElement / 8);
+    if(level > 0)
+        _hasMipmaps = true;
+}
+
+void Texture2DNull::updateCompressedSubData(std::size_t xoffset, std::size_t yoffset, std::size_t width, std::size_t height, std::size_t dataLen, std::size_t level, uint8_t* data)
+{
+    recordUpdate(data, dataLen);
+    if(level > 0)
+        _hasMipmaps = true;
+}
+
+void Texture2DNull::getBytes(std::size_t x, std::size_t y, std::size_t width, std::size_t height, bool flipImage, std::function<void(const unsigned char*, std::size_t, std::size_t)> callback)
+{
+    readZeros(width, height, callback);
+}
+
+void Texture2DNull::generateMipmaps()
+{
+    if (TextureUsage::RENDER_TARGET == _textureUsage)
+        return;
+
+    _hasMipmaps = true;
+}
+
+TextureCubeNull::TextureCubeNull(CommandRecorder* recorder, const TextureDescriptor& descriptor)
+: TextureCubemapBackend(descriptor)
+, _recorder(recorder)
+{
+    _textureType = TextureType::TEXTURE_CUBE;
+}
+
+void TextureCubeNull::updateFaceData(TextureCubeFace side, void *data)
+{
+    auto size = _width * _height * _bitsPerElement / 8;
+
+    RecordedCommand command;
+    command.type = RecordedCommand::Type::UPDATE_TEXTURE;
+    command.object = this;
+    command.offset = (std::size_t)side * size;
+    command.count = size;
+    _recorder->record(command, data, size);
+}
+
+void TextureCubeNull::getBytes(std::size_t x, std::size_t y, std::size_t width, std::size_t height, bool flipImage, std::function<void(const unsigned char*, std::size_t, std::size_t)> callback)
+{
+    readZeros(width, height, callback);
+}
+
+void TextureCubeNull::generateMipmaps()
+{
+    if (TextureUsage::RENDER_TARGET == _textureUsage)
+        return;
+
+    _hasMipmaps = true;
+}
+
+CC_BACKEND_END
@@ -0,0 +1,96 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Texture.h"
+
+CC_BACKEND_BEGIN
+
+class CommandRecorder;
+
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * A 2D texture without storage, updates are recorded and read back pixels are zeros.
+ */
+class Texture2DNull : public backend::Texture2DBackend
+{
+public:
+    /**
+     * @param recorder Specifies the recorder of the device.
+     * @param descriptor Specifies the texture descriptor.
+     */
+    Texture2DNull(CommandRecorder* recorder, const TextureDescriptor& descriptor);
+
+    virtual void updateData(uint8_t* data, std::size_t width , std::size_t height, std::size_t level) override;
+
+    virtual void updateCompressedData(uint8_t* data, std::size_t width , std::size_t height, std::size_t dataLen, std::size_t level) override;
+
+    virtual void updateSubData(std::size_t xoffset, std::size_t yoffset, std::size_t width, std::size_t height, std::size_t level, uint8_t* data) override;
+
+    virtual void updateCompressedSubData(std::size_t xoffset, std::size_t yoffset, std::size_t width, std::size_t height, std::size_t dataLen, std::size_t level, uint8_t* data) override;
+
+    virtual void updateSamplerDescriptor(const SamplerDescriptor &sampler) override {}
+
+    virtual void getBytes(std::size_t x, std::size_t y, std::size_t width, std::size_t height, bool flipImage, std::function<void(const unsigned char*, std::size_t, std::size_t)> callback) override;
+
+    virtual void generateMipmaps() override;
+
+private:
+    void recordUpdate(const void* data, std::size_t size);
+
+    CommandRecorder* _recorder = nullptr;
+};
+
+/**
+ * A cubemap texture without storage, updates are recorded and read back pixels are zeros.
+ */
+class TextureCubeNull : public backend::TextureCubemapBackend
+{
+public:
+    /**
+     * @param recorder Specifies the recorder of the device.
+     * @param descriptor Specifies the texture descriptor.
+     */
+    TextureCubeNull(CommandRecorder* recorder, const TextureDescriptor& descriptor);
+
+    virtual void updateSamplerDescriptor(const SamplerDescriptor &sampler) override {}
+
+    virtual void updateFaceData(TextureCubeFace side, void *data) override;
+
+    virtual void getBytes(std::size_t x, std::size_t y, std::size_t width, std::size_t height, bool flipImage, std::function<void(const unsigned char*, std::size_t, std::size_t)> callback) override;
+
+    virtual void generateMipmaps() override;
+
+private:
+    CommandRecorder* _recorder = nullptr;
+};
+
+//end of _null group
+/// @}
+CC_BACKEND_END
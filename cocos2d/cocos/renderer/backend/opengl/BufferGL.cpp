@@ -24,10 +24,13 @@
  
 #include "BufferGL.h"
 #include <cassert>
+#include <algorithm>
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
 #include "base/CCEventDispatcher.h"
+#include "StateCacheGL.h"
+#include "../capture/FrameCapture.h"
 
 CC_BACKEND_BEGIN
 
@@ -62,7 +65,7 @@ BufferGL::BufferGL(std::size_t size, BufferType type, BufferUsage usage)
 BufferGL::~BufferGL()
 {
     if (_buffer)
-        glDeleteBuffers(1, &_buffer);
+        StateCacheGL::deleteBuffer(_buffer);
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     CC_SAFE_DELETE_ARRAY(_data);
@@ -112,12 +115,12 @@ void BufferGL::updateData(void* data, std::size_t size)
     {
         if (BufferType::VERTEX == _type)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+            StateCacheGL::bindBuffer(GL_ARRAY_BUFFER, _buffer);
             glBufferData(GL_ARRAY_BUFFER, size, data, toGLUsage(_usage));
         }
         else
         {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffer);
+            StateCacheGL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffer);
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, toGLUsage(_usage));
         }
         CHECK_GL_ERROR_DEBUG();
@@ -127,6 +130,9 @@ void BufferGL::updateData(void* data, std::size_t size)
         fillBuffer(data, 0, size);
 #endif
     }
+
+    if (FrameCapture::isCapturing())
+        FrameCapture::getInstance()->recordBufferUpdate(this, data, 0, size);
 }
 
 void BufferGL::updateSubData(void* data, std::size_t offset, std::size_t size)
@@ -140,12 +146,12 @@ void BufferGL::updateSubData(void* data, std::size_t offset, std::size_t size)
         CHECK_GL_ERROR_DEBUG();
         if (BufferType::VERTEX == _type)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+            StateCacheGL::bindBuffer(GL_ARRAY_BUFFER, _buffer);
             glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
         }
         else
         {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffer);
+            StateCacheGL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffer);
             glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, size, data);
         }
 
@@ -154,6 +160,42 @@ void BufferGL::updateSubData(void* data, std::size_t offset, std::size_t size)
 #endif
         CHECK_GL_ERROR_DEBUG();
     }
+
+    if (FrameCapture::isCapturing())
+        FrameCapture::getInstance()->recordBufferUpdate(this, data, offset, size);
+}
+
+void BufferGL::orphanData()
+{
+    if (!_buffer || !_bufferAllocated)
+        return;
+
+    GLenum target = BufferType::VERTEX == _type ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
+    StateCacheGL::bindBuffer(target, _buffer);
+    glBufferData(target, _bufferAllocated, nullptr, toGLUsage(_usage));
+    CHECK_GL_ERROR_DEBUG();
+}
+
+std::size_t BufferGL::getData(void* data, std::size_t size) const
+{
+    size = std::min(size, _bufferAllocated);
+    if (!_buffer || !size)
+        return 0;
+
+#if defined(CC_USE_GL)
+    GLenum target = BufferType::VERTEX == _type ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
+    StateCacheGL::bindBuffer(target, _buffer);
+    glGetBufferSubData(target, 0, size, data);
+    CHECK_GL_ERROR_DEBUG();
+    return size;
+#elif CC_ENABLE_CACHE_TEXTURE_DATA
+    if (!_data)
+        return 0;
+    memcpy(data, _data, size);
+    return size;
+#else
+    return 0;
+#endif
 }
 
 CC_BACKEND_END
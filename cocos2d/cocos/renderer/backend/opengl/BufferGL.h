@@ -74,6 +74,19 @@ public:
      */
     virtual void usingDefaultStoredData(bool needDefaultStoredData) override ;
 
+    /**
+     * Re-specify the data store with glBufferData, the driver allocates a new one if the GPU still uses the old one.
+     */
+    virtual void orphanData() override;
+
+    /**
+     * Read back the contents of the buffer. OpenGL ES can only return the data stored for static buffers.
+     * @param data Specifies a pointer to the memory the contents are copied to.
+     * @param size Specifies the size in bytes of the memory.
+     * @return The number of bytes read.
+     */
+    virtual std::size_t getData(void* data, std::size_t size) const override;
+
     /**
      * Get buffer object.
      * @return Buffer object.
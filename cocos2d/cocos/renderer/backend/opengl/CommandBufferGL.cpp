@@ -28,6 +28,8 @@
 #include "TextureGL.h"
 #include "DepthStencilStateGL.h"
 #include "ProgramGL.h"
+#include "StateCacheGL.h"
+#include "ReadbackGL.h"
 #include "base/ccMacros.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
@@ -71,7 +73,8 @@ namespace
     }
 }
 
-CommandBufferGL::CommandBufferGL()
+CommandBufferGL::CommandBufferGL(bool instancingSupported)
+: _instancingSupported(instancingSupported)
 {
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_defaultFBO);
 
@@ -79,6 +82,7 @@ CommandBufferGL::CommandBufferGL()
     _backToForegroundListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom*){
        if(_generatedFBO)
            glGenFramebuffers(1, &_generatedFBO); //recreate framebuffer
+       StateCacheGL::invalidate();
     });
     Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_backToForegroundListener, -1);
 #endif
@@ -98,6 +102,7 @@ CommandBufferGL::~CommandBufferGL()
 
 void CommandBufferGL::beginFrame()
 {
+    ReadbackGL::poll();
 }
 
 void CommandBufferGL::beginRenderPass(const RenderPassDescriptor& descirptor)
@@ -234,22 +239,13 @@ void CommandBufferGL::applyRenderPassDescriptor(const RenderPassDescriptor& desc
     
     CHECK_GL_ERROR_DEBUG();
     
-    GLboolean oldDepthWrite = GL_FALSE;
-    GLboolean oldDepthTest = GL_FALSE;
-    GLfloat oldDepthClearValue = 0.f;
-    GLint oldDepthFunc = GL_LESS;
+    // glClear() ignores depth test and depth function, but respects depth write mask.
+    // There is no need to restore the mask, every draw call applies its own depth state.
     if (descirptor.needClearDepth)
     {
-        glGetBooleanv(GL_DEPTH_WRITEMASK, &oldDepthWrite);
-        glGetBooleanv(GL_DEPTH_TEST, &oldDepthTest);
-        glGetFloatv(GL_DEPTH_CLEAR_VALUE, &oldDepthClearValue);
-        glGetIntegerv(GL_DEPTH_FUNC, &oldDepthFunc);
-        
         mask |= GL_DEPTH_BUFFER_BIT;
         glClearDepth(descirptor.clearDepthValue);
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(GL_TRUE);
-        glDepthFunc(GL_ALWAYS);
+        StateCacheGL::depthMask(GL_TRUE);
     }
     
     CHECK_GL_ERROR_DEBUG();
@@ -263,19 +259,6 @@ void CommandBufferGL::applyRenderPassDescriptor(const RenderPassDescriptor& desc
     if(mask) glClear(mask);
     
     CHECK_GL_ERROR_DEBUG();
-    
-    // restore depth test
-    if (descirptor.needClearDepth)
-    {
-        if (!oldDepthTest)
-            glDisable(GL_DEPTH_TEST);
-        
-        glDepthMask(oldDepthWrite);
-        glDepthFunc(oldDepthFunc);
-        glClearDepth(oldDepthClearValue);
-    }
-    
-    CHECK_GL_ERROR_DEBUG();
 }
 
 void CommandBufferGL::setRenderPipeline(RenderPipeline* renderPipeline)
@@ -306,7 +289,7 @@ void CommandBufferGL::setCullMode(CullMode mode)
 
 void CommandBufferGL::setWinding(Winding winding)
 {
-    glFrontFace(UtilsGL::toGLFrontFace(winding));
+    StateCacheGL::frontFace(UtilsGL::toGLFrontFace(winding));
 }
 
 void CommandBufferGL::setIndexBuffer(Buffer* buffer)
@@ -348,12 +331,101 @@ void CommandBufferGL::drawArrays(PrimitiveType primitiveType, std::size_t start,
 void CommandBufferGL::drawElements(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset)
 {
     prepareDrawing();
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer->getHandler());
+    StateCacheGL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer->getHandler());
     glDrawElements(UtilsGL::toGLPrimitiveType(primitiveType), count, UtilsGL::toGLIndexType(indexType), (GLvoid*)offset);
     CHECK_GL_ERROR_DEBUG();
     cleanResources();
 }
 
+void CommandBufferGL::setInstanceBuffer(Buffer* buffer, const VertexLayout& layout, const void* data)
+{
+    assert(buffer != nullptr);
+    if (buffer == nullptr)
+        return;
+
+    buffer->retain();
+    CC_SAFE_RELEASE(_instanceBuffer);
+    _instanceBuffer = static_cast<BufferGL*>(buffer);
+    CommandBuffer::setInstanceBuffer(buffer, layout, data);
+}
+
+void CommandBufferGL::drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount)
+{
+#if defined(CC_PLATFORM_PC)
+    if (_instancingSupported)
+    {
+        prepareDrawing();
+        bindInstanceBuffer();
+        StateCacheGL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer->getHandler());
+        glDrawElementsInstanced(UtilsGL::toGLPrimitiveType(primitiveType), count, UtilsGL::toGLIndexType(indexType), (GLvoid*)offset, instanceCount);
+        CHECK_GL_ERROR_DEBUG();
+        unbindInstanceBuffer();
+        cleanResources();
+        return;
+    }
+#endif
+
+    // no glDrawElementsInstanced, set the per-instance attributes as constants before drawing each instance
+    if (!_instanceLayout.isValid())
+        return;
+
+    const char* instanceData = _instanceData;
+    const std::size_t dataSize = instanceCount * _instanceLayout.getStride();
+    if (!instanceData && _instanceBuffer)
+    {
+        // without the attributes in client memory, read them back from the buffer where the backend can
+        _instanceDataRead.resize(dataSize);
+        if (_instanceBuffer->getData(_instanceDataRead.data(), dataSize) == dataSize)
+            instanceData = _instanceDataRead.data();
+    }
+    if (!instanceData)
+    {
+        log("CommandBufferGL: %d instances not drawn, their per-instance attributes can't be read without instancing support.", (int)instanceCount);
+        return;
+    }
+
+    prepareDrawing();
+    StateCacheGL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer->getHandler());
+    for (std::size_t i = 0; i < instanceCount; ++i)
+    {
+        setInstanceAttributes(_instanceLayout, instanceData + i * _instanceLayout.getStride());
+        glDrawElements(UtilsGL::toGLPrimitiveType(primitiveType), count, UtilsGL::toGLIndexType(indexType), (GLvoid*)offset);
+    }
+    CHECK_GL_ERROR_DEBUG();
+    cleanResources();
+}
+
+void CommandBufferGL::setInstanceAttributes(const VertexLayout& layout, const char* data)
+{
+    // an attribute without array reads the current constant value
+    const auto& attributes = layout.getAttributes();
+    for (const auto& attributeInfo : attributes)
+    {
+        const auto& attribute = attributeInfo.second;
+        auto value = reinterpret_cast<const GLfloat*>(data + attribute.offset);
+        glDisableVertexAttribArray(attribute.index);
+        switch (attribute.format)
+        {
+            case VertexFormat::FLOAT4:
+                glVertexAttrib4fv(attribute.index, value);
+                break;
+            case VertexFormat::FLOAT3:
+                glVertexAttrib3fv(attribute.index, value);
+                break;
+            case VertexFormat::FLOAT2:
+                glVertexAttrib2fv(attribute.index, value);
+                break;
+            case VertexFormat::FLOAT:
+                glVertexAttrib1fv(attribute.index, value);
+                break;
+            default:
+                CCASSERT(false, "Only float per-instance attributes can be drawn without instancing.");
+                break;
+        }
+    }
+    StateCacheGL::invalidateVertexLayout();
+}
+
 void CommandBufferGL::endRenderPass()
 {
 }
@@ -377,7 +449,7 @@ void CommandBufferGL::setDepthStencilState(DepthStencilState* depthStencilState)
 void CommandBufferGL::prepareDrawing() const
 {   
     const auto& program = _renderPipeline->getProgram();
-    glUseProgram(program->getHandler());
+    StateCacheGL::useProgram(program->getHandler());
     
     bindVertexBuffer(program);
     setUniforms(program);
@@ -394,12 +466,12 @@ void CommandBufferGL::prepareDrawing() const
     // Set cull mode.
     if (CullMode::NONE == _cullMode)
     {
-        glDisable(GL_CULL_FACE);
+        StateCacheGL::disable(GL_CULL_FACE);
     }
     else
     {
-        glEnable(GL_CULL_FACE);
-        glCullFace(UtilsGL::toGLCullMode(_cullMode));
+        StateCacheGL::enable(GL_CULL_FACE);
+        StateCacheGL::cullFace(UtilsGL::toGLCullMode(_cullMode));
     }
 }
 
@@ -411,7 +483,9 @@ void CommandBufferGL::bindVertexBuffer(ProgramGL *program) const
     if (!vertexLayout->isValid())
         return;
     
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer->getHandler());
+    StateCacheGL::bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer->getHandler());
+    if (StateCacheGL::checkVertexLayout(_vertexBuffer->getHandler(), *vertexLayout))
+        return;
 
     const auto& attributes = vertexLayout->getAttributes();
     for (const auto& attributeInfo : attributes)
@@ -427,22 +501,65 @@ void CommandBufferGL::bindVertexBuffer(ProgramGL *program) const
     }
 }
 
+#if defined(CC_PLATFORM_PC)
+void CommandBufferGL::bindInstanceBuffer() const
+{
+    if (!_instanceBuffer || !_instanceLayout.isValid())
+        return;
+
+    StateCacheGL::bindBuffer(GL_ARRAY_BUFFER, _instanceBuffer->getHandler());
+    StateCacheGL::invalidateVertexLayout();
+
+    const auto& attributes = _instanceLayout.getAttributes();
+    for (const auto& attributeInfo : attributes)
+    {
+        const auto& attribute = attributeInfo.second;
+        glEnableVertexAttribArray(attribute.index);
+        glVertexAttribPointer(attribute.index,
+            UtilsGL::getGLAttributeSize(attribute.format),
+            UtilsGL::toGLAttributeType(attribute.format),
+            attribute.needToBeNormallized,
+            _instanceLayout.getStride(),
+            (GLvoid*)attribute.offset);
+        glVertexAttribDivisor(attribute.index, 1);
+    }
+}
+
+void CommandBufferGL::unbindInstanceBuffer() const
+{
+    if (!_instanceBuffer || !_instanceLayout.isValid())
+        return;
+
+    // the locations may be used by per-vertex attributes of next program
+    const auto& attributes = _instanceLayout.getAttributes();
+    for (const auto& attributeInfo : attributes)
+    {
+        glVertexAttribDivisor(attributeInfo.second.index, 0);
+        glDisableVertexAttribArray(attributeInfo.second.index);
+    }
+    StateCacheGL::invalidateVertexLayout();
+}
+#endif
+
 void CommandBufferGL::setUniforms(ProgramGL* program) const
 {
     if (_programState)
     {
         auto& callbacks = _programState->getCallbackUniforms();
         auto& uniformInfos = _programState->getProgram()->getAllActiveUniformInfo(ShaderStage::VERTEX);
-        std::size_t bufferSize = 0;
-        char* buffer = nullptr;
-        _programState->getVertexUniformBuffer(&buffer, bufferSize);
-
         for (auto &cb : callbacks)
         {
             cb.second(_programState, cb.first);
         }
 
-        int i = 0;
+        // Get the buffer after the callbacks, setting a uniform may replace the shared uniform data.
+        std::size_t bufferSize = 0;
+        char* buffer = nullptr;
+        _programState->getVertexUniformBuffer(&buffer, bufferSize);
+
+        // Uniform values are part of the program object, only upload the ones changed since the program was last used.
+        bool forceUpdate = !program->beginUniformShadow(bufferSize);
+        unsigned int skippedUniforms = 0;
         for(auto& iter : uniformInfos)
         {
             auto& uniformInfo = iter.second;
@@ -450,12 +567,20 @@ void CommandBufferGL::setUniforms(ProgramGL* program) const
                 continue;
 
             int elementCount = uniformInfo.count;
+            auto data = buffer + uniformInfo.bufferOffset;
+            if (!program->updateUniformShadow(uniformInfo.bufferOffset, data, uniformInfo.size * elementCount) && !forceUpdate)
+            {
+                ++skippedUniforms;
+                continue;
+            }
+
             setUniform(uniformInfo.isArray,
                 uniformInfo.location,
                 elementCount,
                 uniformInfo.type,
-                (void*)(buffer + uniformInfo.bufferOffset));
+                (void*)data);
         }
+        StateCacheGL::addSkippedUniformCalls(skippedUniforms);
         
         const auto& textureInfo = _programState->getVertexTextureInfos();
         for(const auto& iter : textureInfo)
@@ -473,6 +598,12 @@ void CommandBufferGL::setUniforms(ProgramGL* program) const
                 ++i;
             }
             
+            if (!program->updateSamplerShadow(location, slot))
+            {
+                StateCacheGL::addSkippedUniformCalls(1);
+                continue;
+            }
+
             auto arrayCount = slot.size();
             if (arrayCount > 1)
                 glUniform1iv(location, (uint32_t)arrayCount, (GLint*)slot.data());
@@ -579,6 +710,7 @@ void CommandBufferGL::cleanResources()
     CC_SAFE_RELEASE_NULL(_indexBuffer);
     CC_SAFE_RELEASE_NULL(_programState);  
     CC_SAFE_RELEASE_NULL(_vertexBuffer);
+    CC_SAFE_RELEASE_NULL(_instanceBuffer);
 }
 
 void CommandBufferGL::setLineWidth(float lineWidth)
@@ -595,41 +727,21 @@ void CommandBufferGL::setScissorRect(bool isEnabled, float x, float y, float wid
 {
     if(isEnabled)
     {
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(x, y, width, height);
+        StateCacheGL::enable(GL_SCISSOR_TEST);
+        StateCacheGL::scissor(x, y, width, height);
     }
     else
     {
-        glDisable(GL_SCISSOR_TEST);
+        StateCacheGL::disable(GL_SCISSOR_TEST);
     }
 }
 
 void CommandBufferGL::captureScreen(std::function<void(const unsigned char*, int, int)> callback)
 {
-    int bufferSize = _viewPort.w * _viewPort.h *4;
-    std::shared_ptr<GLubyte> buffer(new GLubyte[bufferSize], [](GLubyte* p){ CC_SAFE_DELETE_ARRAY(p); });
-    memset(buffer.get(), 0, bufferSize);
-    if (!buffer)
-    {
-        callback(nullptr, 0, 0);
-        return;
-    }
-    glPixelStorei(GL_PACK_ALIGNMENT, 1);
-    glReadPixels(0, 0, _viewPort.w, _viewPort.h, GL_RGBA, GL_UNSIGNED_BYTE, buffer.get());
-
-    std::shared_ptr<GLubyte> flippedBuffer(new GLubyte[bufferSize], [](GLubyte* p) { CC_SAFE_DELETE_ARRAY(p); });
-    memset(flippedBuffer.get(), 0, bufferSize);
-    if (!flippedBuffer)
-    {
-        callback(nullptr, 0, 0);
-        return;
-    }
-    for (int row = 0; row < _viewPort.h; ++row)
-    {
-        memcpy(flippedBuffer.get() + (_viewPort.h - row - 1) * _viewPort.w * 4, buffer.get() + row * _viewPort.w * 4, _viewPort.w * 4);
-    }
-
-    callback(flippedBuffer.get(), _viewPort.w, _viewPort.h);
+    // the pixels are delivered by a later frame, so that the capture doesn't stall the pipeline
+    ReadbackGL::readPixels(0, 0, _viewPort.w, _viewPort.h, true, [callback](const unsigned char* data, std::size_t width, std::size_t height) {
+        callback(data, (int)width, (int)height);
+    });
 }
 
 CC_BACKEND_END
@@ -52,7 +52,11 @@ class DepthStencilStateGL;
 class CommandBufferGL final : public CommandBuffer
 {
 public:
-    CommandBufferGL();
+    /**
+     * @param instancingSupported Whether the context has glDrawElementsInstanced and glVertexAttribDivisor,
+     * the instances are drawn one at a time otherwise.
+     */
+    explicit CommandBufferGL(bool instancingSupported);
     ~CommandBufferGL();
     
     /// @name Setters & Getters
@@ -132,6 +136,26 @@ public:
      * @see `drawArrays(PrimitiveType primitiveType, unsigned int start,  unsigned int count)`
     */
     virtual void drawElements(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset) override;
+
+    /**
+     * Set a buffer holding per-instance attributes, used by the next instanced draw.
+     * @param buffer The buffer the device will read per-instance attributes from.
+     * @param layout Layout of the per-instance attributes. Attribute index is the attribute location of current program.
+     * @param data The same attributes in client memory, used where glDrawElementsInstanced is not available.
+     */
+    virtual void setInstanceBuffer(Buffer* buffer, const VertexLayout& layout, const void* data) override;
+
+    /**
+     * Draw several instances of primitives with an index list.
+     * Without FeatureType::INSTANCING, e.g. OpenGL ES 2.0 or OpenGL 2.1 without ARB_draw_instanced,
+     * the instances are drawn one at a time.
+     * @param primitiveType The type of primitives that elements are assembled into.
+     * @param indexType The type if indexes, either 16 bit integer or 32 bit integer.
+     * @param count The number of indexes to read from the index buffer for each instance.
+     * @param offset Byte offset within indexBuffer to start reading indexes from.
+     * @param instanceCount The number of instances to draw.
+     */
+    virtual void drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount) override;
     
     /**
      * Do some resources release.
@@ -178,8 +202,14 @@ private:
         unsigned int h = 0;
     };
     
+    virtual void setInstanceAttributes(const VertexLayout& layout, const char* data) override;
+
     void prepareDrawing() const;
     void bindVertexBuffer(ProgramGL* program) const;
+#if defined(CC_PLATFORM_PC)
+    void bindInstanceBuffer() const;
+    void unbindInstanceBuffer() const;
+#endif
     void setUniforms(ProgramGL* program) const;
     void setUniform(bool isArray, GLuint location, unsigned int size, GLenum uniformType, void* data) const;
     void cleanResources();
@@ -192,10 +222,13 @@ private:
     bool _generatedFBOBindStencil = false;
 
     GLint _defaultFBO = 0;  // The value gets from glGetIntegerv, so need to use GLint
+    bool _instancingSupported = false;
+    std::vector<char> _instanceDataRead; // per-instance attributes read back from the instance buffer
     GLuint _currentFBO = 0;
     BufferGL* _vertexBuffer;
     ProgramState* _programState = nullptr;
     BufferGL* _indexBuffer = nullptr;
+    BufferGL* _instanceBuffer = nullptr;
     RenderPipelineGL* _renderPipeline = nullptr;
     CullMode _cullMode = CullMode::NONE;
     DepthStencilStateGL* _depthStencilStateGL = nullptr;
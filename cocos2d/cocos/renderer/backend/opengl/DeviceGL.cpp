@@ -61,7 +61,7 @@ DeviceGL::~DeviceGL()
 
 CommandBuffer* DeviceGL::newCommandBuffer()
 {
-    return new (std::nothrow) CommandBufferGL();
+    return new (std::nothrow) CommandBufferGL(_deviceInfo && _deviceInfo->checkForFeatureSupported(FeatureType::INSTANCING));
 }
 
 Buffer* DeviceGL::newBuffer(std::size_t size, BufferType type, BufferUsage usage)
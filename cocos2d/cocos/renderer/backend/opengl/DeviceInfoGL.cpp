@@ -25,8 +25,23 @@
 #include "DeviceInfoGL.h"
 #include "platform/CCGL.h"
 
+#include <stdio.h>
+
 CC_BACKEND_BEGIN
 
+#ifdef CC_PLATFORM_PC
+namespace {
+    // the version string starts with <major>.<minor> on desktop OpenGL
+    bool isVersionAtLeast(const char* version, int major, int minor)
+    {
+        int versionMajor = 0, versionMinor = 0;
+        if (!version || sscanf(version, "%d.%d", &versionMajor, &versionMinor) != 2)
+            return false;
+        return versionMajor > major || (versionMajor == major && versionMinor >= minor);
+    }
+}
+#endif
+
 bool DeviceInfoGL::init()
 {
     glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &_maxAttributes);
@@ -98,6 +113,13 @@ bool DeviceInfoGL::checkForFeatureSupported(FeatureType feature)
     case FeatureType::DEPTH24:
         featureSupported = checkForGLExtension("GL_OES_depth24");
         break;
+    case FeatureType::INSTANCING:
+#ifdef CC_PLATFORM_PC
+        // core since OpenGL 3.3, OpenGL 2.1 contexts need both extensions
+        featureSupported = isVersionAtLeast(getVersion(), 3, 3) ||
+            (checkForGLExtension("GL_ARB_draw_instanced") && checkForGLExtension("GL_ARB_instanced_arrays"));
+#endif
+        break;
     default:
         break;
     }
@@ -30,6 +30,7 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
 #include "renderer/backend/opengl/UtilsGL.h"
+#include "renderer/backend/opengl/StateCacheGL.h"
 
 CC_BACKEND_BEGIN
 namespace {
@@ -75,7 +76,7 @@ ProgramGL::~ProgramGL()
     CC_SAFE_RELEASE(_vertexShaderModule);
     CC_SAFE_RELEASE(_fragmentShaderModule);
     if (_program)
-        glDeleteProgram(_program);
+        StateCacheGL::deleteProgram(_program);
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     Director::getInstance()->getEventDispatcher()->removeEventListener(_backToForegroundListener);
@@ -88,6 +89,7 @@ void ProgramGL::reloadProgram()
     _activeUniformInfos.clear();
     _mapToCurrentActiveLocation.clear();
     _mapToOriginalLocation.clear();
+    _uniformShadowValid = false;
     static_cast<ShaderModuleGL*>(_vertexShaderModule)->compileShader(backend::ShaderStage::VERTEX, std::move(vsPreDefine + _vertexShader));
     static_cast<ShaderModuleGL*>(_fragmentShaderModule)->compileShader(backend::ShaderStage::FRAGMENT, std::move(fsPreDefine + _fragmentShader));
     compileProgram();
@@ -128,7 +130,7 @@ void ProgramGL::compileProgram()
     if (GL_FALSE == status)
     {
         printf("cocos2d: ERROR: %s: failed to link program ", __FUNCTION__);
-        glDeleteProgram(_program);
+        StateCacheGL::deleteProgram(_program);
         _program = 0;
     }
 }
@@ -272,6 +274,46 @@ void ProgramGL::computeUniformInfos()
     free(uniformName);
 }
 
+bool ProgramGL::beginUniformShadow(std::size_t bufferSize)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (_uniformShadowValid && _uniformShadow.size() == bufferSize)
+        return true;
+
+    _uniformShadow.assign(bufferSize, 0);
+    _samplerShadow.clear();
+    _uniformShadowValid = true;
+#endif
+    return false;
+}
+
+bool ProgramGL::updateUniformShadow(std::size_t offset, const char* data, std::size_t size)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (offset + size > _uniformShadow.size())
+        return true;
+
+    auto shadow = _uniformShadow.data() + offset;
+    if (memcmp(shadow, data, size) == 0)
+        return false;
+
+    memcpy(shadow, data, size);
+#endif
+    return true;
+}
+
+bool ProgramGL::updateSamplerShadow(int location, const std::vector<uint32_t>& slots)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    auto& shadow = _samplerShadow[location];
+    if (shadow == slots)
+        return false;
+
+    shadow = slots;
+#endif
+    return true;
+}
+
 int ProgramGL::getAttributeLocation(Attribute name) const
 {
     return _builtinAttributeLocation[name];
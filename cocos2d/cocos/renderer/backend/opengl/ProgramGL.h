@@ -157,6 +157,28 @@ public:
      */
     virtual const std::unordered_map<std::string, UniformInfo>& getAllActiveUniformInfo(ShaderStage stage) const override ;
 
+    /**
+     * Prepare the shadow copy of the uniform values uploaded to this program.
+     * @param bufferSize Specifies the size of the uniform buffer to be uploaded.
+     * @return false if the shadow copy isn't valid, then all uniforms should be uploaded.
+     */
+    bool beginUniformShadow(std::size_t bufferSize);
+
+    /**
+     * Compare a uniform value with the shadow copy, and record it if it is changed.
+     * @param offset Specifies the offset of the uniform in the uniform buffer.
+     * @param data Specifies the uniform value.
+     * @param size Specifies the size of the uniform value in bytes.
+     * @return true if the value is changed and should be uploaded.
+     */
+    bool updateUniformShadow(std::size_t offset, const char* data, std::size_t size);
+
+    /**
+     * Compare the texture slots of a sampler with the shadow copy, and record them if they are changed.
+     * @return true if the slots are changed and should be uploaded.
+     */
+    bool updateSamplerShadow(int location, const std::vector<uint32_t>& slots);
+
 private:
     void compileProgram();
     bool getAttributeLocation(const std::string& attributeName, unsigned int& location) const;
@@ -187,6 +209,10 @@ private:
     UniformLocation _builtinUniformLocation[UNIFORM_MAX];
     int _builtinAttributeLocation[Attribute::ATTRIBUTE_MAX];
     std::unordered_map<int, int> _bufferOffset;
+
+    std::vector<char> _uniformShadow;
+    std::unordered_map<int, std::vector<uint32_t>> _samplerShadow;
+    bool _uniformShadowValid = false;
 };
 //end of _opengl group
 /// @}
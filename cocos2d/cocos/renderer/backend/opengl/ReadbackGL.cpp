@@ -0,0 +1,169 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ReadbackGL.h"
+
+#include <vector>
+#include <string.h>
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    struct PendingReadback
+    {
+        GLuint buffer = 0;
+#if defined(CC_USE_GL)
+        GLsync fence = nullptr;
+#endif
+        GLsizei width = 0;
+        GLsizei height = 0;
+        bool flipImage = false;
+        ReadbackGL::Callback callback;
+        std::vector<unsigned char> staging; ///< pixels read immediately, used without pixel buffers.
+    };
+
+    std::vector<PendingReadback> s_pendingReadbacks;
+
+    // copy the pixels, flipping the rows if needed
+    void copyPixels(const PendingReadback& readback, const unsigned char* source, unsigned char* destination)
+    {
+        std::size_t bytesPerRow = readback.width * 4;
+        if (!readback.flipImage)
+        {
+            memcpy(destination, source, bytesPerRow * readback.height);
+            return;
+        }
+
+        for (GLsizei row = 0; row < readback.height; ++row)
+        {
+            memcpy(destination + row * bytesPerRow, source + (readback.height - row - 1) * bytesPerRow, bytesPerRow);
+        }
+    }
+
+    void deliverStaging(const PendingReadback& readback)
+    {
+        if (readback.flipImage)
+        {
+            std::vector<unsigned char> flipped(readback.staging.size());
+            copyPixels(readback, readback.staging.data(), flipped.data());
+            readback.callback(flipped.data(), readback.width, readback.height);
+        }
+        else
+        {
+            readback.callback(readback.staging.data(), readback.width, readback.height);
+        }
+    }
+}
+
+bool ReadbackGL::isPipelined()
+{
+#if defined(CC_USE_GL)
+    static bool pipelined = glFenceSync && glClientWaitSync && glDeleteSync && glMapBufferRange && glUnmapBuffer;
+    return pipelined;
+#else
+    return false;
+#endif
+}
+
+void ReadbackGL::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, bool flipImage, Callback callback)
+{
+    PendingReadback readback;
+    readback.width = width;
+    readback.height = height;
+    readback.flipImage = flipImage;
+    readback.callback = std::move(callback);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    std::size_t size = width * height * 4;
+#if defined(CC_USE_GL)
+    if (isPipelined())
+    {
+        glGenBuffers(1, &readback.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        s_pendingReadbacks.push_back(std::move(readback));
+        return;
+    }
+#endif
+    // staged copy, delivered immediately so that it can be used before the context is lost
+    readback.staging.resize(size);
+    glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, readback.staging.data());
+    deliverStaging(readback);
+}
+
+void ReadbackGL::poll()
+{
+    if (s_pendingReadbacks.empty())
+        return;
+
+    // take the available reads out first, callbacks may start new reads
+    std::vector<PendingReadback> readbacks;
+    for (auto iter = s_pendingReadbacks.begin(); iter != s_pendingReadbacks.end();)
+    {
+#if defined(CC_USE_GL)
+        if (iter->fence && glClientWaitSync(iter->fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+        {
+            ++iter;
+            continue;
+        }
+#endif
+        readbacks.push_back(std::move(*iter));
+        iter = s_pendingReadbacks.erase(iter);
+    }
+
+    for (auto& readback : readbacks)
+    {
+        std::size_t size = readback.width * readback.height * 4;
+#if defined(CC_USE_GL)
+        if (readback.fence)
+        {
+            // copy out of the pixel buffer before invoking the callback, which may read pixels again
+            glDeleteSync(readback.fence);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+            auto data = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+            if (data)
+            {
+                readback.staging.resize(size);
+                copyPixels(readback, data, readback.staging.data());
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glDeleteBuffers(1, &readback.buffer);
+
+            if (data)
+                readback.callback(readback.staging.data(), readback.width, readback.height);
+            else
+                readback.callback(nullptr, 0, 0);
+            continue;
+        }
+#endif
+        deliverStaging(readback);
+    }
+}
+
+CC_BACKEND_END
@@ -0,0 +1,69 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <cstddef>
+
+#include "platform/CCGL.h"
+#include "renderer/backend/Macros.h"
+
+CC_BACKEND_BEGIN
+
+/**
+ * @addtogroup _opengl
+ * @{
+ */
+
+/**
+ * Pipelined read of framebuffer pixels.
+ * Where pixel buffers and fences are supported, the pixels are copied into a pixel buffer by the GPU and mapped
+ * a few frames later, once the fence is signaled, so the CPU doesn't wait for the GPU to finish the frame.
+ * Elsewhere the pixels are read into a staging copy and delivered immediately.
+ */
+class ReadbackGL
+{
+public:
+    /// Receive the pixels in RGBA8888 format, they are only valid during the call.
+    using Callback = std::function<void(const unsigned char*, std::size_t, std::size_t)>;
+
+    /**
+     * Read pixels from the bound framebuffer.
+     * @param flipImage Whether the rows are flipped, the first row of GL is the bottom one.
+     * @param callback Invoked by a later poll() on the same thread if isPipelined(), before returning otherwise.
+     *                 The data is null if the read failed.
+     */
+    static void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, bool flipImage, Callback callback);
+
+    /// Deliver the reads whose pixels are available, should be invoked every frame.
+    static void poll();
+
+    /// Whether the pixels are read without stalling, using pixel buffers and fences.
+    static bool isPipelined();
+};
+
+//end of _opengl group
+/// @}
+CC_BACKEND_END
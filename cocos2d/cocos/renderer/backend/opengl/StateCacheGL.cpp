@@ -0,0 +1,506 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "StateCacheGL.h"
+#include "renderer/backend/VertexLayout.h"
+
+#include <string.h>
+
+CC_BACKEND_BEGIN
+
+StateCacheGL::Stats StateCacheGL::_stats;
+
+namespace
+{
+    enum CapabilityIndex
+    {
+        CAP_BLEND = 0,
+        CAP_DEPTH_TEST,
+        CAP_STENCIL_TEST,
+        CAP_CULL_FACE,
+        CAP_SCISSOR_TEST,
+        CAP_MAX
+    };
+
+    // value of a cached flag which hasn't been set since the last invalidation
+    enum { UNKNOWN = -1 };
+
+    const int MAX_VERTEX_ATTRIBUTES = 16;
+
+    struct StencilFaceState
+    {
+        bool funcValid = false;
+        GLenum func = GL_ALWAYS;
+        GLint ref = 0;
+        GLuint readMask = 0;
+
+        bool opValid = false;
+        GLenum sfail = GL_KEEP;
+        GLenum dpfail = GL_KEEP;
+        GLenum dppass = GL_KEEP;
+
+        bool writeMaskValid = false;
+        GLuint writeMask = 0;
+    };
+
+    struct VertexLayoutState
+    {
+        bool valid = false;
+        GLuint buffer = 0;
+        std::size_t stride = 0;
+        // packed as offset << 16 | normalized << 8 | (format + 1), 0 means the index is not used
+        uint64_t attributes[MAX_VERTEX_ATTRIBUTES] = {0};
+    };
+
+    struct State
+    {
+        GLuint program = 0;
+        bool programValid = false;
+
+        GLuint arrayBuffer = 0;
+        bool arrayBufferValid = false;
+        GLuint elementArrayBuffer = 0;
+        bool elementArrayBufferValid = false;
+
+        int activeUnit = UNKNOWN;
+        GLenum textureTargets[StateCacheGL::MAX_TEXTURE_UNITS];
+        GLuint textures[StateCacheGL::MAX_TEXTURE_UNITS];
+        bool texturesValid[StateCacheGL::MAX_TEXTURE_UNITS];
+
+        int capabilities[CAP_MAX];
+
+        bool blendEquationValid = false;
+        GLenum blendModeRGB = GL_FUNC_ADD;
+        GLenum blendModeAlpha = GL_FUNC_ADD;
+
+        bool blendFuncValid = false;
+        GLenum blendSrcRGB = GL_ONE;
+        GLenum blendDstRGB = GL_ZERO;
+        GLenum blendSrcAlpha = GL_ONE;
+        GLenum blendDstAlpha = GL_ZERO;
+
+        bool colorMaskValid = false;
+        GLboolean colorMask[4];
+
+        int depthMask = UNKNOWN;
+        bool depthFuncValid = false;
+        GLenum depthFunc = GL_LESS;
+
+        StencilFaceState stencilFront;
+        StencilFaceState stencilBack;
+
+        bool cullFaceValid = false;
+        GLenum cullFace = GL_BACK;
+        bool frontFaceValid = false;
+        GLenum frontFace = GL_CCW;
+
+        bool scissorValid = false;
+        GLint scissor[4];
+
+        VertexLayoutState vertexLayout;
+
+        State()
+        {
+            for (int i = 0; i < StateCacheGL::MAX_TEXTURE_UNITS; ++i)
+            {
+                textureTargets[i] = 0;
+                textures[i] = 0;
+                texturesValid[i] = false;
+            }
+            for (int i = 0; i < CAP_MAX; ++i)
+                capabilities[i] = UNKNOWN;
+        }
+    };
+
+    State s_state;
+
+    int toCapabilityIndex(GLenum capability)
+    {
+        switch (capability)
+        {
+            case GL_BLEND:
+                return CAP_BLEND;
+            case GL_DEPTH_TEST:
+                return CAP_DEPTH_TEST;
+            case GL_STENCIL_TEST:
+                return CAP_STENCIL_TEST;
+            case GL_CULL_FACE:
+                return CAP_CULL_FACE;
+            case GL_SCISSOR_TEST:
+                return CAP_SCISSOR_TEST;
+            default:
+                return UNKNOWN;
+        }
+    }
+
+    // Returns true if the GL call can be skipped.
+    inline bool canSkip(bool unchanged, unsigned int& counter)
+    {
+#if CC_ENABLE_GL_STATE_CACHE
+        if (unchanged)
+        {
+            ++counter;
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    template <typename Fn>
+    void forEachStencilFace(GLenum face, Fn fn)
+    {
+        if (face == GL_FRONT || face == GL_FRONT_AND_BACK)
+            fn(s_state.stencilFront);
+        if (face == GL_BACK || face == GL_FRONT_AND_BACK)
+            fn(s_state.stencilBack);
+    }
+}
+
+void StateCacheGL::invalidate()
+{
+    s_state = State();
+}
+
+void StateCacheGL::resetStats()
+{
+    _stats = Stats();
+}
+
+void StateCacheGL::useProgram(GLuint program)
+{
+    if (canSkip(s_state.programValid && s_state.program == program, _stats.skippedStateCalls))
+        return;
+
+    glUseProgram(program);
+    s_state.program = program;
+    s_state.programValid = true;
+}
+
+void StateCacheGL::bindBuffer(GLenum target, GLuint buffer)
+{
+    GLuint* current = nullptr;
+    bool* valid = nullptr;
+    if (target == GL_ARRAY_BUFFER)
+    {
+        current = &s_state.arrayBuffer;
+        valid = &s_state.arrayBufferValid;
+    }
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        current = &s_state.elementArrayBuffer;
+        valid = &s_state.elementArrayBufferValid;
+    }
+
+    if (current && canSkip(*valid && *current == buffer, _stats.skippedStateCalls))
+        return;
+
+    glBindBuffer(target, buffer);
+    if (current)
+    {
+        *current = buffer;
+        *valid = true;
+    }
+}
+
+void StateCacheGL::bindTexture(GLenum target, GLuint texture, int unit)
+{
+    if (unit < 0 || unit >= MAX_TEXTURE_UNITS)
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture);
+        s_state.activeUnit = unit;
+        return;
+    }
+
+    if (!canSkip(s_state.activeUnit == unit, _stats.skippedStateCalls))
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        s_state.activeUnit = unit;
+    }
+
+    // Only one target per unit is tracked, binding another target to the unit just issues one more call.
+    bool unchanged = s_state.texturesValid[unit]
+                  && s_state.textureTargets[unit] == target
+                  && s_state.textures[unit] == texture;
+    if (canSkip(unchanged, _stats.skippedStateCalls))
+        return;
+
+    glBindTexture(target, texture);
+    s_state.textureTargets[unit] = target;
+    s_state.textures[unit] = texture;
+    s_state.texturesValid[unit] = true;
+}
+
+void StateCacheGL::setEnabled(GLenum capability, bool enabled)
+{
+    int index = toCapabilityIndex(capability);
+    if (index != UNKNOWN && canSkip(s_state.capabilities[index] == (int)enabled, _stats.skippedStateCalls))
+        return;
+
+    if (enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+
+    if (index != UNKNOWN)
+        s_state.capabilities[index] = enabled;
+}
+
+void StateCacheGL::blendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
+{
+    bool unchanged = s_state.blendEquationValid
+                  && s_state.blendModeRGB == modeRGB
+                  && s_state.blendModeAlpha == modeAlpha;
+    if (canSkip(unchanged, _stats.skippedStateCalls))
+        return;
+
+    glBlendEquationSeparate(modeRGB, modeAlpha);
+    s_state.blendModeRGB = modeRGB;
+    s_state.blendModeAlpha = modeAlpha;
+    s_state.blendEquationValid = true;
+}
+
+void StateCacheGL::blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+    bool unchanged = s_state.blendFuncValid
+                  && s_state.blendSrcRGB == srcRGB
+                  && s_state.blendDstRGB == dstRGB
+                  && s_state.blendSrcAlpha == srcAlpha
+                  && s_state.blendDstAlpha == dstAlpha;
+    if (canSkip(unchanged, _stats.skippedStateCalls))
+        return;
+
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    s_state.blendSrcRGB = srcRGB;
+    s_state.blendDstRGB = dstRGB;
+    s_state.blendSrcAlpha = srcAlpha;
+    s_state.blendDstAlpha = dstAlpha;
+    s_state.blendFuncValid = true;
+}
+
+void StateCacheGL::colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    bool unchanged = s_state.colorMaskValid
+                  && s_state.colorMask[0] == red
+                  && s_state.colorMask[1] == green
+                  && s_state.colorMask[2] == blue
+                  && s_state.colorMask[3] == alpha;
+    if (canSkip(unchanged, _stats.skippedStateCalls))
+        return;
+
+    glColorMask(red, green, blue, alpha);
+    s_state.colorMask[0] = red;
+    s_state.colorMask[1] = green;
+    s_state.colorMask[2] = blue;
+    s_state.colorMask[3] = alpha;
+    s_state.colorMaskValid = true;
+}
+
+void StateCacheGL::depthMask(GLboolean flag)
+{
+    int value = flag ? 1 : 0;
+    if (canSkip(s_state.depthMask == value, _stats.skippedStateCalls))
+        return;
+
+    glDepthMask(flag);
+    s_state.depthMask = value;
+}
+
+void StateCacheGL::depthFunc(GLenum func)
+{
+    if (canSkip(s_state.depthFuncValid && s_state.depthFunc == func, _stats.skippedStateCalls))
+        return;
+
+    glDepthFunc(func);
+    s_state.depthFunc = func;
+    s_state.depthFuncValid = true;
+}
+
+void StateCacheGL::stencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask)
+{
+    bool unchanged = true;
+    forEachStencilFace(face, [&](const StencilFaceState& state) {
+        unchanged = unchanged && state.funcValid && state.func == func && state.ref == ref && state.readMask == mask;
+    });
+    if (canSkip(unchanged, _stats.skippedStateCalls))
+        return;
+
+    if (face == GL_FRONT_AND_BACK)
+        glStencilFunc(func, ref, mask);
+    else
+        glStencilFuncSeparate(face, func, ref, mask);
+    forEachStencilFace(face, [&](StencilFaceState& state) {
+        state.func = func;
+        state.ref = ref;
+        state.readMask = mask;
+        state.funcValid = true;
+    });
+}
+
+void StateCacheGL::stencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+    bool unchanged = true;
+    forEachStencilFace(face, [&](const StencilFaceState& state) {
+        unchanged = unchanged && state.opValid && state.sfail == sfail && state.dpfail == dpfail && state.dppass == dppass;
+    });
+    if (canSkip(unchanged, _stats.skippedStateCalls))
+        return;
+
+    if (face == GL_FRONT_AND_BACK)
+        glStencilOp(sfail, dpfail, dppass);
+    else
+        glStencilOpSeparate(face, sfail, dpfail, dppass);
+    forEachStencilFace(face, [&](StencilFaceState& state) {
+        state.sfail = sfail;
+        state.dpfail = dpfail;
+        state.dppass = dppass;
+        state.opValid = true;
+    });
+}
+
+void StateCacheGL::stencilMaskSeparate(GLenum face, GLuint mask)
+{
+    bool unchanged = true;
+    forEachStencilFace(face, [&](const StencilFaceState& state) {
+        unchanged = unchanged && state.writeMaskValid && state.writeMask == mask;
+    });
+    if (canSkip(unchanged, _stats.skippedStateCalls))
+        return;
+
+    if (face == GL_FRONT_AND_BACK)
+        glStencilMask(mask);
+    else
+        glStencilMaskSeparate(face, mask);
+    forEachStencilFace(face, [&](StencilFaceState& state) {
+        state.writeMask = mask;
+        state.writeMaskValid = true;
+    });
+}
+
+void StateCacheGL::cullFace(GLenum mode)
+{
+    if (canSkip(s_state.cullFaceValid && s_state.cullFace == mode, _stats.skippedStateCalls))
+        return;
+
+    glCullFace(mode);
+    s_state.cullFace = mode;
+    s_state.cullFaceValid = true;
+}
+
+void StateCacheGL::frontFace(GLenum mode)
+{
+    if (canSkip(s_state.frontFaceValid && s_state.frontFace == mode, _stats.skippedStateCalls))
+        return;
+
+    glFrontFace(mode);
+    s_state.frontFace = mode;
+    s_state.frontFaceValid = true;
+}
+
+void StateCacheGL::scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    bool unchanged = s_state.scissorValid
+                  && s_state.scissor[0] == x
+                  && s_state.scissor[1] == y
+                  && s_state.scissor[2] == width
+                  && s_state.scissor[3] == height;
+    if (canSkip(unchanged, _stats.skippedStateCalls))
+        return;
+
+    glScissor(x, y, width, height);
+    s_state.scissor[0] = x;
+    s_state.scissor[1] = y;
+    s_state.scissor[2] = width;
+    s_state.scissor[3] = height;
+    s_state.scissorValid = true;
+}
+
+bool StateCacheGL::checkVertexLayout(GLuint buffer, const VertexLayout& layout)
+{
+    // Pack the layout by attribute index, so that the result doesn't depend on the iteration order of the attributes.
+    VertexLayoutState current;
+    current.valid = true;
+    current.buffer = buffer;
+    current.stride = layout.getStride();
+    for (const auto& iter : layout.getAttributes())
+    {
+        const auto& attribute = iter.second;
+        if (attribute.index >= MAX_VERTEX_ATTRIBUTES)
+        {
+            s_state.vertexLayout.valid = false;
+            return false;
+        }
+        current.attributes[attribute.index] = ((uint64_t)attribute.offset << 16)
+                                            | ((uint64_t)attribute.needToBeNormallized << 8)
+                                            | ((uint64_t)attribute.format + 1);
+    }
+
+    auto& cached = s_state.vertexLayout;
+    bool unchanged = cached.valid
+                  && cached.buffer == current.buffer
+                  && cached.stride == current.stride
+                  && memcmp(cached.attributes, current.attributes, sizeof(current.attributes)) == 0;
+    if (canSkip(unchanged, _stats.skippedAttributeCalls))
+        return true;
+
+    cached = current;
+    return false;
+}
+
+void StateCacheGL::invalidateVertexLayout()
+{
+    s_state.vertexLayout.valid = false;
+}
+
+void StateCacheGL::deleteProgram(GLuint program)
+{
+    if (s_state.program == program)
+        s_state.programValid = false;
+    glDeleteProgram(program);
+}
+
+void StateCacheGL::deleteBuffer(GLuint buffer)
+{
+    // glDeleteBuffers reverts the bindings of the buffer to 0
+    if (s_state.arrayBuffer == buffer)
+        s_state.arrayBuffer = 0;
+    if (s_state.elementArrayBuffer == buffer)
+        s_state.elementArrayBuffer = 0;
+    if (s_state.vertexLayout.buffer == buffer)
+        s_state.vertexLayout.valid = false;
+    glDeleteBuffers(1, &buffer);
+}
+
+void StateCacheGL::deleteTexture(GLuint texture)
+{
+    // glDeleteTextures reverts the bindings of the texture to 0
+    for (int i = 0; i < MAX_TEXTURE_UNITS; ++i)
+    {
+        if (s_state.textures[i] == texture)
+            s_state.textures[i] = 0;
+    }
+    glDeleteTextures(1, &texture);
+}
+
+CC_BACKEND_END
@@ -0,0 +1,126 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/ccConfig.h"
+#include "platform/CCGL.h"
+#include "renderer/backend/Macros.h"
+
+CC_BACKEND_BEGIN
+
+class VertexLayout;
+
+/**
+ * @addtogroup _opengl
+ * @{
+ */
+
+/**
+ * Shadow copy of the OpenGL state touched by the backend.
+ * Every state change of the opengl backend goes through this class, so that a call which would not change
+ * the current GL state can be skipped. If CC_ENABLE_GL_STATE_CACHE is 0, all calls are forwarded to OpenGL.
+ * The cache must be invalidated when the GL context is recreated, or when GL state is changed outside of the backend.
+ */
+class StateCacheGL
+{
+public:
+    /// Number of GL calls skipped because the state was already set.
+    struct Stats
+    {
+        unsigned int skippedStateCalls = 0;
+        unsigned int skippedAttributeCalls = 0;
+        unsigned int skippedUniformCalls = 0;
+    };
+
+    /// Max texture units tracked by the cache, units above it are always bound.
+    static const int MAX_TEXTURE_UNITS = 16;
+
+    /// Forget all cached state, the next call of every kind will be issued.
+    static void invalidate();
+
+    /// Get the skip counters since the last call to resetStats().
+    static const Stats& getStats() { return _stats; }
+
+    /// Reset the skip counters.
+    static void resetStats();
+
+    static void useProgram(GLuint program);
+    static void bindBuffer(GLenum target, GLuint buffer);
+
+    /**
+     * Bind a texture to a texture unit.
+     * @param target GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP.
+     * @param texture Specifies the texture handler.
+     * @param unit Specifies the texture unit, starting from 0.
+     */
+    static void bindTexture(GLenum target, GLuint texture, int unit = 0);
+
+    /// Only GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_CULL_FACE and GL_SCISSOR_TEST are cached.
+    static void setEnabled(GLenum capability, bool enabled);
+    static void enable(GLenum capability) { setEnabled(capability, true); }
+    static void disable(GLenum capability) { setEnabled(capability, false); }
+
+    static void blendEquationSeparate(GLenum modeRGB, GLenum modeAlpha);
+    static void blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+    static void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+
+    static void depthMask(GLboolean flag);
+    static void depthFunc(GLenum func);
+
+    /// @param face GL_FRONT, GL_BACK or GL_FRONT_AND_BACK.
+    static void stencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask);
+    static void stencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass);
+    static void stencilMaskSeparate(GLenum face, GLuint mask);
+
+    static void cullFace(GLenum mode);
+    static void frontFace(GLenum mode);
+    static void scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    /**
+     * Check whether the attribute pointers of the vertex layout are already set for the buffer.
+     * If not, the layout is recorded as the current one and the caller should set the attribute pointers.
+     * @param buffer Specifies the vertex buffer handler.
+     * @param layout Specifies the vertex layout.
+     * @return true if the attribute pointers can be skipped.
+     */
+    static bool checkVertexLayout(GLuint buffer, const VertexLayout& layout);
+
+    /// Forget the attribute pointers, should be invoked after setting attribute pointers without checkVertexLayout().
+    static void invalidateVertexLayout();
+
+    /// Record uniform calls skipped by the per-program uniform shadow, @see ProgramGL::updateUniformShadow().
+    static void addSkippedUniformCalls(unsigned int count) { _stats.skippedUniformCalls += count; }
+
+    static void deleteProgram(GLuint program);
+    static void deleteBuffer(GLuint buffer);
+    static void deleteTexture(GLuint texture);
+
+private:
+    static Stats _stats;
+};
+
+//end of _opengl group
+/// @}
+CC_BACKEND_END
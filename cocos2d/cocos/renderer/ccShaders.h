@@ -70,12 +70,15 @@ extern CC_DLL const char * CC3D_color_frag;
 extern CC_DLL const char * CC3D_colorNormal_frag;
 extern CC_DLL const char * CC3D_colorNormalTexture_frag;
 extern CC_DLL const char * CC3D_colorTexture_frag;
+extern CC_DLL const char * CC3D_colorInstanced_frag;
+extern CC_DLL const char * CC3D_colorTextureInstanced_frag;
 extern CC_DLL const char * CC3D_particleTexture_frag;
 extern CC_DLL const char * CC3D_particleColor_frag;
 extern CC_DLL const char * CC3D_particle_vert;
 extern CC_DLL const char * CC3D_positionNormalTexture_vert;
 extern CC_DLL const char * CC3D_skinPositionNormalTexture_vert;
 extern CC_DLL const char * CC3D_positionTexture_vert;
+extern CC_DLL const char * CC3D_positionTextureInstanced_vert;
 extern CC_DLL const char * CC3D_skinPositionTexture_vert;
 extern CC_DLL const char * CC3D_skybox_frag;
 extern CC_DLL const char * CC3D_skybox_vert;
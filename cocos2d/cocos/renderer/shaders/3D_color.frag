@@ -37,3 +37,17 @@ void main(void)
     gl_FragColor = u_color;
 }
 )";
+
+const char* CC3D_colorInstanced_frag = R"(
+
+#ifdef GL_ES
+varying lowp vec4 InstanceColorOut;
+#else
+varying vec4 InstanceColorOut;
+#endif
+
+void main(void)
+{
+    gl_FragColor = InstanceColorOut;
+}
+)";
@@ -38,3 +38,20 @@ void main(void)
     gl_FragColor = texture2D(u_texture, TextureCoordOut) * u_color;
 }
 )";
+
+const char* CC3D_colorTextureInstanced_frag = R"(
+
+#ifdef GL_ES
+varying mediump vec2 TextureCoordOut;
+varying lowp vec4 InstanceColorOut;
+#else
+varying vec2 TextureCoordOut;
+varying vec4 InstanceColorOut;
+#endif
+uniform sampler2D u_texture;
+
+void main(void)
+{
+    gl_FragColor = texture2D(u_texture, TextureCoordOut) * InstanceColorOut;
+}
+)";
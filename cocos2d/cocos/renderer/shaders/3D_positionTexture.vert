@@ -40,6 +40,31 @@ void main(void)
 }
 )";
 
+const char* CC3D_positionTextureInstanced_vert = R"(
+
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+
+// per-instance attributes, columns of the MVP matrix and the color
+attribute vec4 a_instanceMVP0;
+attribute vec4 a_instanceMVP1;
+attribute vec4 a_instanceMVP2;
+attribute vec4 a_instanceMVP3;
+attribute vec4 a_instanceColor;
+
+varying vec2 TextureCoordOut;
+varying vec4 InstanceColorOut;
+
+void main(void)
+{
+    mat4 mvpMatrix = mat4(a_instanceMVP0, a_instanceMVP1, a_instanceMVP2, a_instanceMVP3);
+    gl_Position = mvpMatrix * a_position;
+    TextureCoordOut = a_texCoord;
+    TextureCoordOut.y = 1.0 - TextureCoordOut.y;
+    InstanceColorOut = a_instanceColor;
+}
+)";
+
 const char* CC3D_skinPositionTexture_vert = R"(
 attribute vec3 a_position;
 
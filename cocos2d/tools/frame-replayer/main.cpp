@@ -0,0 +1,180 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/**
+ * Replay a frame written by FrameCapture, i.e. under a profiler, detached from the game that recorded it.
+ *
+ * frame-replayer FILE [--frames N] [--gpu] [--min-draw-calls N]
+ *
+ * The frame is replayed on the null backend by default, which measures the CPU cost of the backend calls and
+ * prints the CommandRecorder counters. --gpu opens a window and replays on the default device of the platform.
+ * The process fails if the file can't be loaded, or if a null replay draws less than --min-draw-calls per frame.
+ */
+
+#include "cocos2d.h"
+#include "renderer/backend/Device.h"
+#include "renderer/backend/null/DeviceNull.h"
+#include "renderer/backend/capture/FrameReplayer.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+USING_NS_CC;
+
+namespace
+{
+    const float WIN_WIDTH = 960;
+    const float WIN_HEIGHT = 640;
+
+    struct Options
+    {
+        std::string filename;
+        int frames = 1000;
+        int minDrawCalls = -1;
+        bool gpu = false;
+    };
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            if (strcmp(argv[i], "--gpu") == 0)
+            {
+                options.gpu = true;
+                continue;
+            }
+
+            if (strncmp(argv[i], "--", 2) != 0)
+            {
+                if (!options.filename.empty())
+                    return false;
+                options.filename = argv[i];
+                continue;
+            }
+
+            if (i + 1 >= argc)
+                return false;
+
+            const char* value = argv[++i];
+            if (strcmp(argv[i - 1], "--frames") == 0 && atoi(value) > 0)
+                options.frames = atoi(value);
+            else if (strcmp(argv[i - 1], "--min-draw-calls") == 0 && atoi(value) >= 0)
+                options.minDrawCalls = atoi(value);
+            else
+                return false;
+        }
+        return !options.filename.empty();
+    }
+
+    int replayOnNullDevice(const Options& options)
+    {
+        auto device = new backend::DeviceNull();
+        backend::Device::setInstance(device);
+        auto& recorder = device->getRecorder();
+        recorder.setRecordingEnabled(false);
+
+        backend::FrameReplayer replayer;
+        if (!replayer.load(options.filename, device))
+            return 1;
+
+        // loading uploads the resources, only the replayed frames are counted
+        recorder.clear();
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < options.frames; ++i)
+            replayer.replay();
+        auto end = std::chrono::steady_clock::now();
+
+        const auto& stats = recorder.getStats();
+        const auto& frame = replayer.getFrame();
+        double frames = options.frames;
+        double drawCalls = stats.drawCalls / frames;
+        printf("file: %s, commands: %d, frames: %d\n", options.filename.c_str(), (int)frame.commands.size(), options.frames);
+        printf("ms per frame: %.3f\n", std::chrono::duration<double, std::milli>(end - begin).count() / frames);
+        printf("draw calls per frame: %.1f\n", drawCalls);
+        printf("vertices per frame: %.0f\n", stats.drawnVertices / frames);
+        printf("pipeline changes per frame: %.1f\n", stats.pipelineChanges / frames);
+        printf("buffer upload bytes per frame: %.0f\n", stats.bufferUpdateBytes / frames);
+
+        if (options.minDrawCalls >= 0 && drawCalls < options.minDrawCalls)
+        {
+            fprintf(stderr, "draw calls per frame %.1f below %d\n", drawCalls, options.minDrawCalls);
+            return 1;
+        }
+        return 0;
+    }
+
+    int replayOnGPU(const Options& options)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        // the view creates the context the default device renders with
+        auto director = Director::getInstance();
+        auto view = GLViewImpl::createWithRect("frame-replayer", Rect(0, 0, WIN_WIDTH, WIN_HEIGHT));
+        director->setOpenGLView(view);
+
+        int result = 0;
+        {
+            backend::FrameReplayer replayer;
+            if (replayer.load(options.filename))
+            {
+                auto begin = std::chrono::steady_clock::now();
+                for (int i = 0; i < options.frames && !view->windowShouldClose(); ++i)
+                {
+                    replayer.replay();
+                    view->swapBuffers();
+                    view->pollEvents();
+                }
+                auto end = std::chrono::steady_clock::now();
+                printf("file: %s, frames: %d\n", options.filename.c_str(), options.frames);
+                printf("ms per frame: %.3f\n", std::chrono::duration<double, std::milli>(end - begin).count() / options.frames);
+            }
+            else
+            {
+                result = 1;
+            }
+        }
+
+        director->end();
+        director->mainLoop();
+        return result;
+#else
+        fprintf(stderr, "--gpu is only supported on desktop platforms\n");
+        return 2;
+#endif
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        fprintf(stderr, "usage: %s FILE [--frames N] [--gpu] [--min-draw-calls N]\n", argv[0]);
+        return 2;
+    }
+
+    return options.gpu ? replayOnGPU(options) : replayOnNullDevice(options);
+}
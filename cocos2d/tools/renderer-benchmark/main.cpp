@@ -0,0 +1,331 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/**
+ * Headless renderer benchmark: runs a scene through the Director on the null backend and prints
+ * the time per frame with the counters of CommandRecorder. It needs no GPU nor window, so that
+ * batching, sorting and state cache changes can be measured and regression-tested on CI machines.
+ *
+ * renderer-benchmark [--scene sprites|nodes|timers] [--frames N] [--count N] [--matrix-stack] [--max-draw-calls N] [--capture FILE]
+ *
+ * - sprites: --count sprites (10,000 by default) grouped by texture, measures batching.
+ * - nodes: a hierarchy of --count nodes (5,000 by default) without content, measures the cost of Node::visit.
+ *   --matrix-stack enables Director::setMatrixStackCompatibilityEnabled() to compare with the deprecated matrix stack.
+ * - timers: --count nodes (5,000 by default) calling Node::scheduleOnce() with delays of 1 to 60 frames, measures the
+ *   Scheduler. The timers must wait in the timer wheel rather than being updated every frame, and fire on their frame.
+ *
+ * Each frame advances the scheduler by 1/60 s, so that the scheduled callbacks are deterministic.
+ * The process fails if the average draw calls per frame exceed --max-draw-calls, or if a timer of the timers scene
+ * is updated every frame or doesn't fire on its frame.
+ * --capture writes one more frame with FrameCapture, to be replayed by frame-replayer.
+ */
+
+#include "cocos2d.h"
+#include "renderer/backend/Device.h"
+#include "renderer/backend/null/DeviceNull.h"
+#include "renderer/backend/capture/FrameCapture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+USING_NS_CC;
+
+namespace
+{
+    const int TEXTURE_COUNT = 4;
+    const int TEXTURE_SIZE = 64;
+    const float WIN_WIDTH = 960;
+    const float WIN_HEIGHT = 640;
+    const int NODES_PER_GROUP = 100;
+    const float FRAME_TIME = 1.0f / 60;
+    const int TIMER_DELAY_FRAMES = 60;
+
+    /// A view without window, the null device does not present anything.
+    class GLViewNull : public GLView
+    {
+    public:
+        static GLViewNull* create(float width, float height)
+        {
+            auto view = new (std::nothrow) GLViewNull();
+            view->setFrameSize(width, height);
+            view->setDesignResolutionSize(width, height, ResolutionPolicy::SHOW_ALL);
+            view->autorelease();
+            return view;
+        }
+
+        virtual void end() override { release(); }
+        virtual bool isOpenGLReady() override { return true; }
+        virtual void swapBuffers() override {}
+        virtual void setIMEKeyboardState(bool /*open*/) override {}
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        virtual HWND getWin32Window() override { return nullptr; }
+#endif
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+        virtual id getCocoaWindow() override { return nil; }
+        virtual id getNSGLContext() override { return nil; }
+#endif
+    };
+
+    struct Options
+    {
+        std::string scene = "sprites";
+        int frames = 300;
+        int count = 0;
+        int maxDrawCalls = -1;
+        bool matrixStack = false;
+        std::string capture;
+    };
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            if (strcmp(argv[i], "--matrix-stack") == 0)
+            {
+                options.matrixStack = true;
+                continue;
+            }
+
+            if (i + 1 >= argc)
+                return false;
+
+            const char* value = argv[++i];
+            if (strcmp(argv[i - 1], "--scene") == 0 && (strcmp(value, "sprites") == 0 || strcmp(value, "nodes") == 0 || strcmp(value, "timers") == 0))
+                options.scene = value;
+            else if (strcmp(argv[i - 1], "--frames") == 0 && atoi(value) > 0)
+                options.frames = atoi(value);
+            else if (strcmp(argv[i - 1], "--count") == 0 && atoi(value) > 0)
+                options.count = atoi(value);
+            else if (strcmp(argv[i - 1], "--max-draw-calls") == 0 && atoi(value) >= 0)
+                options.maxDrawCalls = atoi(value);
+            else if (strcmp(argv[i - 1], "--capture") == 0)
+                options.capture = value;
+            else
+                return false;
+        }
+
+        if (options.count == 0)
+            options.count = options.scene == "sprites" ? 10000 : 5000;
+        return true;
+    }
+
+    Texture2D* createTexture(int index)
+    {
+        std::vector<unsigned char> pixels(TEXTURE_SIZE * TEXTURE_SIZE * 4, (unsigned char)(64 * (index + 1) - 1));
+        auto texture = new (std::nothrow) Texture2D();
+        texture->initWithData(pixels.data(), pixels.size(), backend::PixelFormat::RGBA8888, TEXTURE_SIZE, TEXTURE_SIZE, Size(TEXTURE_SIZE, TEXTURE_SIZE));
+        texture->autorelease();
+        return texture;
+    }
+
+    /// Sprites grouped by texture, so that a batching renderer draws each group with one call.
+    Scene* createSpriteScene(int spriteCount)
+    {
+        auto scene = Scene::create();
+        auto sprites = std::make_shared<std::vector<Sprite*>>();
+        std::minstd_rand random(1);
+        std::uniform_real_distribution<float> x(0, WIN_WIDTH);
+        std::uniform_real_distribution<float> y(0, WIN_HEIGHT);
+
+        for (int i = 0; i < TEXTURE_COUNT; ++i)
+        {
+            auto texture = createTexture(i);
+            for (int j = i * spriteCount / TEXTURE_COUNT; j < (i + 1) * spriteCount / TEXTURE_COUNT; ++j)
+            {
+                auto sprite = Sprite::createWithTexture(texture);
+                sprite->setPosition(x(random), y(random));
+                sprite->setScale(0.25f);
+                scene->addChild(sprite);
+                sprites->push_back(sprite);
+            }
+        }
+
+        // dirty transforms every frame, as animated sprites do
+        scene->schedule([sprites](float /*dt*/) {
+            for (auto sprite : *sprites)
+                sprite->setRotation(sprite->getRotation() + 1);
+        }, "rotate");
+        return scene;
+    }
+
+    /// Groups of nodes without content under the scene, so that the frame time is mostly spent in Node::visit.
+    Scene* createNodeScene(int nodeCount)
+    {
+        auto scene = Scene::create();
+        auto groups = std::make_shared<std::vector<Node*>>();
+
+        for (int i = 0; i < nodeCount; i += NODES_PER_GROUP)
+        {
+            auto group = Node::create();
+            group->setPosition(WIN_WIDTH / 2, WIN_HEIGHT / 2);
+            scene->addChild(group);
+            groups->push_back(group);
+
+            for (int j = i + 1; j < std::min(i + NODES_PER_GROUP, nodeCount); ++j)
+            {
+                auto node = Node::create();
+                node->setPosition((float)(j - i), (float)(j - i));
+                group->addChild(node);
+            }
+        }
+
+        // dirty the transforms of all nodes every frame
+        scene->schedule([groups](float /*dt*/) {
+            for (auto group : *groups)
+                group->setRotation(group->getRotation() + 1);
+        }, "rotate");
+        return scene;
+    }
+
+    /// Nodes firing scheduleOnce() callbacks, the frame each one fired at is stored in firedFrames.
+    Scene* createTimerScene(int nodeCount, const std::shared_ptr<std::vector<int>>& firedFrames)
+    {
+        auto scene = Scene::create();
+        firedFrames->assign(nodeCount, -1);
+
+        for (int i = 0; i < nodeCount; ++i)
+        {
+            auto node = Node::create();
+            scene->addChild(node);
+
+            // half a frame early, so that the rounding of the accumulated time doesn't move it to another frame
+            float delay = (i % TIMER_DELAY_FRAMES + 0.5f) * FRAME_TIME;
+            node->scheduleOnce([firedFrames, i](float /*dt*/) {
+                (*firedFrames)[i] = (int)Director::getInstance()->getTotalFrames();
+            }, delay, "once");
+        }
+        return scene;
+    }
+
+    /// Number of timers which didn't fire, or which didn't fire on the frame of their delay.
+    int countMissedTimers(const std::vector<int>& firedFrames)
+    {
+        // the timers start on the same frame, so they fire their delay apart
+        int startFrame = firedFrames.empty() ? 0 : firedFrames[0] - 1;
+        int missed = 0;
+        for (size_t i = 0; i < firedFrames.size(); ++i)
+        {
+            if (firedFrames[i] < 0 || firedFrames[i] != startFrame + (int)(i % TIMER_DELAY_FRAMES) + 1)
+                ++missed;
+        }
+        return missed;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        fprintf(stderr, "usage: %s [--scene sprites|nodes|timers] [--frames N] [--count N] [--matrix-stack] [--max-draw-calls N] [--capture FILE]\n", argv[0]);
+        return 2;
+    }
+
+    // the device must be replaced before any backend object is created
+    auto device = new backend::DeviceNull();
+    backend::Device::setInstance(device);
+    auto& recorder = device->getRecorder();
+    recorder.setRecordingEnabled(false);
+
+    auto director = Director::getInstance();
+    director->setOpenGLView(GLViewNull::create(WIN_WIDTH, WIN_HEIGHT));
+    director->setMatrixStackCompatibilityEnabled(options.matrixStack);
+    auto firedFrames = std::make_shared<std::vector<int>>();
+    if (options.scene == "nodes")
+        director->runWithScene(createNodeScene(options.count));
+    else if (options.scene == "timers")
+        director->runWithScene(createTimerScene(options.count, firedFrames));
+    else
+        director->runWithScene(createSpriteScene(options.count));
+
+    // the first frame presents the scene and uploads the textures
+    director->mainLoop(FRAME_TIME);
+    recorder.clear();
+
+    // the timers of the scene are started by the first frame they are updated
+    int loopTimers = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.frames; ++i)
+    {
+        director->mainLoop(FRAME_TIME);
+        if (i == 0)
+            loopTimers = director->getScheduler()->getLoopTimerCount();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const auto& stats = recorder.getStats();
+    double frames = options.frames;
+    double drawCalls = stats.drawCalls / frames;
+    printf("scene: %s, count: %d, frames: %d, matrix stack: %s\n", options.scene.c_str(), options.count, options.frames, options.matrixStack ? "on" : "off");
+    printf("ms per frame: %.3f\n", std::chrono::duration<double, std::milli>(end - begin).count() / frames);
+    printf("draw calls per frame: %.1f\n", drawCalls);
+    printf("vertices per frame: %.0f\n", stats.drawnVertices / frames);
+    printf("pipeline changes per frame: %.1f\n", stats.pipelineChanges / frames);
+    printf("program state changes per frame: %.1f\n", stats.programStateChanges / frames);
+    printf("buffer upload bytes per frame: %.0f\n", stats.bufferUpdateBytes / frames);
+    printf("timers updated every frame: %d\n", loopTimers);
+
+    int missedTimers = 0;
+    if (options.scene == "timers")
+    {
+        missedTimers = countMissedTimers(*firedFrames);
+        printf("timers not fired on their frame: %d\n", missedTimers);
+    }
+
+    // the null textures read back synchronously, so the file is written at the end of the frame
+    bool captured = false;
+    if (!options.capture.empty())
+    {
+        backend::FrameCapture::getInstance()->requestCapture(options.capture, [&captured](bool succeeded) {
+            captured = succeeded;
+        });
+        director->mainLoop(FRAME_TIME);
+        printf("capture %s: %s\n", options.capture.c_str(), captured ? "written" : "failed");
+    }
+
+    director->end();
+    director->mainLoop();
+
+    if (!options.capture.empty() && !captured)
+        return 1;
+
+    if (options.maxDrawCalls >= 0 && drawCalls > options.maxDrawCalls)
+    {
+        fprintf(stderr, "draw calls per frame %.1f exceed %d\n", drawCalls, options.maxDrawCalls);
+        return 1;
+    }
+
+    if (options.scene == "timers" && (loopTimers > 0 || missedTimers > 0))
+    {
+        fprintf(stderr, "%d timers updated every frame, %d timers not fired on their frame\n", loopTimers, missedTimers);
+        return 1;
+    }
+    return 0;
+}